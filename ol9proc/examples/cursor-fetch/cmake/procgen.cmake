@@ -17,6 +17,9 @@
 #   -DPROC_SYS_INCLUDE="a,b,c"
 #   -DPCS_CFG=/opt/oracle/instantclient/lib/precomp/admin/pcscfg.cfg
 #   -DPROC_DEFINES="NAME=VALUE;FOO=1"
+#
+# Always precompiles with threads=yes: the sources declare no global sqlca
+# (SQLCA_NONE) and bind one per connection handle, see xora_proc_contex.h.
 # ------------------------------------------------------------------------------
 
 function(proc_generate OUTVAR PC_SRC PROJECT_INCLUDES)
@@ -130,6 +133,7 @@ function(proc_generate OUTVAR PC_SRC PROJECT_INCLUDES)
     COMMAND ${CMAKE_COMMAND} -E echo "--   include = (${_include_csv})"
     COMMAND ${CMAKE_COMMAND} -E echo "--   sys_include = (${PROC_SYS_INCLUDE})"
     COMMAND ${CMAKE_COMMAND} -E echo "--   parse = none"
+    COMMAND ${CMAKE_COMMAND} -E echo "--   threads = yes"
     COMMAND ${CMAKE_COMMAND} -E echo "--   config = ${PCS_CFG}"
     COMMAND "${PROC}"
             iname=${_abs_pc}
@@ -137,6 +141,7 @@ function(proc_generate OUTVAR PC_SRC PROJECT_INCLUDES)
             code=ansi_c
             mode=ansi
             parse=none
+            threads=yes
             "include=(${_include_csv})"
             "sys_include=(${PROC_SYS_INCLUDE})"
             ${_define_args}
@@ -0,0 +1,538 @@
+#ifndef XORA_HPP
+#define XORA_HPP
+/* xora.hpp — header-only C++17/20 layer over the C API
+ *
+ * Summary:
+ *   - Move-only owners: Connection (xora_conn_t), Transaction (rolls back
+ *     unless committed), Cursor (xora_emp_cursor_t), Rows (stb_ds vector of
+ *     xora_emp_row_t) and Columns (xora_emp_cols_t). Destructors call the C
+ *     close/free; nothing here owns memory the C layer does not.
+ *   - Batch is a view of the cursor's host arrays as spans, valid until the
+ *     cursor fetches again. `for (const xora::Batch &b : cur)` runs the next
+ *     array FETCH when the iterator advances; rows are read in place, so the
+ *     loop allocates nothing per row or per batch.
+ *   - Failures throw xora::Error with the xora_err_t and, where there is a
+ *     session, its sqlcode and message. Destructors never throw.
+ *   - xora::span is std::span under C++20, a minimal stand-in under C++17.
+ *
+ * The inline members call the C API directly; with optimisation a range-for
+ * over a cursor compiles to the same loop as xora_emp_cursor_next_batch.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define XORA_HPP_STD_SPAN 1
+#endif
+#endif
+
+#include "xora_error.h"
+#include "xora_contex.h"
+#include "xora_stbds.h"
+#include "xora_proc_emp.h"
+#include "xora_proc_emp_fetch.h"
+#include "xora_proc_emp_crud.h"
+#include "xora_emp_cols.h"
+
+namespace xora
+{
+
+#ifdef XORA_HPP_STD_SPAN
+  template <class T>
+  using span = std::span<T>;
+#else
+  /* The subset of std::span the views need */
+  template <class T>
+  class span
+  {
+  public:
+    using element_type = T;
+    using iterator = T *;
+
+    constexpr span() noexcept = default;
+    constexpr span(T *p, std::size_t n) noexcept : p_(p), n_(n) {}
+
+    constexpr T *data() const noexcept { return p_; }
+    constexpr std::size_t size() const noexcept { return n_; }
+    constexpr bool empty() const noexcept { return n_ == 0; }
+    constexpr T &operator[](std::size_t i) const noexcept { return p_[i]; }
+    constexpr T *begin() const noexcept { return p_; }
+    constexpr T *end() const noexcept { return p_ + n_; }
+    constexpr span subspan(std::size_t off, std::size_t n) const noexcept { return span(p_ + off, n); }
+
+  private:
+    T *p_ = nullptr;
+    std::size_t n_ = 0;
+  };
+#endif
+
+  /*  errors  */
+
+  class Error : public std::runtime_error
+  {
+  public:
+    Error(xora_err_t rc, const std::string &what, long sqlcode = 0)
+        : std::runtime_error(what), rc_(rc), sqlcode_(sqlcode) {}
+
+    xora_err_t code() const noexcept { return rc_; }
+    long sqlcode() const noexcept { return sqlcode_; }
+
+  private:
+    xora_err_t rc_;
+    long sqlcode_;
+  };
+
+  namespace detail
+  {
+    [[noreturn]] inline void fail(xora_err_t rc, const char *op, const xora_conn_t *h)
+    {
+      char msg[128] = "";
+      long sc = h ? xora_conn_sqlcode(h, msg, sizeof(msg)) : 0;
+      std::string what = std::string("xora: ") + op + " failed (rc=" + std::to_string((int)rc);
+      if (sc)
+        what += ", sqlcode=" + std::to_string(sc);
+      what += msg[0] ? std::string("): ") + msg : std::string(")");
+      throw Error(rc, what, sc);
+    }
+
+    inline void check(xora_err_t rc, const char *op, const xora_conn_t *h)
+    {
+      if (rc != XORA_OK)
+        fail(rc, op, h);
+    }
+  } // namespace detail
+
+  class Cursor;
+
+  /*  Connection  */
+
+  class Connection
+  {
+  public:
+    Connection() noexcept = default;
+
+    /* Create and open a session */
+    Connection(const char *user, const char *pass, const char *db)
+    {
+      detail::check(xora_conn_create(&h_, user, pass, db), "xora_conn_create", nullptr);
+      xora_err_t rc = xora_conn_open(h_);
+      if (rc != XORA_CONN_OPEN_OK)
+      {
+        char msg[128] = "";
+        long sc = xora_conn_sqlcode(h_, msg, sizeof(msg));
+        xora_conn_destroy(&h_);
+        throw Error(rc, std::string("xora: xora_conn_open failed: ") + msg, sc);
+      }
+    }
+
+    /* Adopt a handle (e.g. from xora_pool_acquire: release() it back first) */
+    explicit Connection(xora_conn_t *h) noexcept : h_(h) {}
+
+    ~Connection() { reset(); }
+
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+    Connection(Connection &&o) noexcept : h_(std::exchange(o.h_, nullptr)) {}
+    Connection &operator=(Connection &&o) noexcept
+    {
+      if (this != &o)
+        reset(std::exchange(o.h_, nullptr));
+      return *this;
+    }
+
+    xora_conn_t *get() const noexcept { return h_; }
+    explicit operator bool() const noexcept { return h_ != nullptr; }
+    xora_conn_t *release() noexcept { return std::exchange(h_, nullptr); }
+
+    void reset(xora_conn_t *h = nullptr) noexcept
+    {
+      if (h_)
+        xora_conn_destroy(&h_);
+      h_ = h;
+    }
+
+    bool is_open() const noexcept { return h_ && xora_conn_is_open(h_) == XORA_CONN_OPEN_OK; }
+
+    /* Status of the last statement on this session */
+    long sqlcode() const noexcept { return xora_conn_sqlcode(h_, nullptr, 0); }
+
+    void commit() { detail::check(xora_tx_commit(h_), "COMMIT", h_); }
+    void rollback() { detail::check(xora_tx_rollback(h_), "ROLLBACK", h_); }
+
+    std::optional<xora_emp_row_t> get_by_id(int empno)
+    {
+      xora_emp_row_t row;
+      int found = 0;
+      xora_err_t rc = xora_emp_get_by_id(h_, empno, &row, &found);
+      if (rc == XORA_NO_DATA_FOUND || (rc == XORA_OK && !found))
+        return std::nullopt;
+      detail::check(rc, "xora_emp_get_by_id", h_);
+      return row;
+    }
+
+    /* INSERT with MAX(id)+1; returns the id (no commit).
+     * Not for tables whose ids come from xora_idalloc_t (see xora_idalloc.h). */
+    int create(const xora_emp_row_t &row)
+    {
+      int id = 0;
+      detail::check(xora_emp_create_autoid(h_, &row, &id), "xora_emp_create_autoid", h_);
+      return id;
+    }
+
+    /* INSERT with the caller's id (no commit) */
+    void create(const xora_emp_row_t &row, int id)
+    {
+      int out = 0;
+      detail::check(xora_emp_create_with_id(h_, &row, id, &out), "xora_emp_create_with_id", h_);
+    }
+
+    /* INSERT with the allocator's next id; returns the id (no commit) */
+    int create(const xora_emp_row_t &row, xora_idalloc_t *ids)
+    {
+      int id = 0;
+      detail::check(xora_idalloc_next(ids, h_, &id), "xora_idalloc_next", h_);
+      create(row, id);
+      return id;
+    }
+
+    /* UPDATE by row.empno (no commit) */
+    void update(const xora_emp_row_t &row)
+    {
+      detail::check(xora_emp_update(h_, &row), "xora_emp_update", h_);
+    }
+
+    inline Cursor cursor(const xora_fetch_opts_t *opts = nullptr, const xora_emp_part_t *part = nullptr);
+
+  private:
+    xora_conn_t *h_ = nullptr;
+  };
+
+  /*  Transaction: rolls back on scope exit unless committed  */
+
+  class Transaction
+  {
+  public:
+    explicit Transaction(Connection &c) noexcept : h_(c.get()) {}
+    ~Transaction()
+    {
+      if (h_)
+        (void)xora_tx_rollback(h_);
+    }
+
+    Transaction(const Transaction &) = delete;
+    Transaction &operator=(const Transaction &) = delete;
+    Transaction(Transaction &&o) noexcept : h_(std::exchange(o.h_, nullptr)) {}
+    Transaction &operator=(Transaction &&o) noexcept
+    {
+      if (this != &o)
+      {
+        if (h_)
+          (void)xora_tx_rollback(h_);
+        h_ = std::exchange(o.h_, nullptr);
+      }
+      return *this;
+    }
+
+    void commit()
+    {
+      xora_conn_t *h = std::exchange(h_, nullptr);
+      detail::check(xora_tx_commit(h), "COMMIT", h);
+    }
+
+    void rollback()
+    {
+      xora_conn_t *h = std::exchange(h_, nullptr);
+      detail::check(xora_tx_rollback(h), "ROLLBACK", h);
+    }
+
+    bool active() const noexcept { return h_ != nullptr; }
+
+  private:
+    xora_conn_t *h_ = nullptr;
+  };
+
+  /*  Batch: the cursor's host arrays, in place  */
+
+  struct Row
+  {
+    int empno;
+    double salary;
+    int64_t salary_cents;
+    std::string_view ename; /* empty when NULL */
+    bool ename_is_null;
+  };
+
+  class Batch
+  {
+  public:
+    static constexpr std::size_t name_cap = sizeof(((xora_emp_batch_view_t *)nullptr)->ename[0]);
+
+    Batch() noexcept { std::memset(&v_, 0, sizeof(v_)); }
+    explicit Batch(const xora_emp_batch_view_t &v) noexcept : v_(v) {}
+
+    std::size_t size() const noexcept { return (std::size_t)v_.count; }
+    bool empty() const noexcept { return v_.count == 0; }
+
+    span<const int> empno() const noexcept { return {v_.empno, size()}; }
+    span<const double> salary() const noexcept { return {v_.salary, size()}; }
+    span<const int64_t> salary_cents() const noexcept { return {v_.salary_cents, size()}; }
+    span<const short> ename_ind() const noexcept { return {v_.ename_ind, size()}; }
+    span<const char[name_cap]> ename() const noexcept { return {v_.ename, size()}; }
+
+    bool ename_is_null(std::size_t i) const noexcept { return v_.ename_ind[i] < 0; }
+    std::string_view ename(std::size_t i) const noexcept
+    {
+      if (v_.ename_ind[i] < 0)
+        return {};
+      const char *s = v_.ename[i];
+      const void *nul = std::memchr(s, '\0', name_cap);
+      return {s, nul ? (std::size_t)((const char *)nul - s) : name_cap};
+    }
+
+    Row operator[](std::size_t i) const noexcept
+    {
+      return Row{v_.empno[i], v_.salary[i], v_.salary_cents[i], ename(i), ename_is_null(i)};
+    }
+
+    class iterator
+    {
+    public:
+      using value_type = Row;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() noexcept = default;
+      iterator(const Batch *b, std::size_t i) noexcept : b_(b), i_(i) {}
+      Row operator*() const noexcept { return (*b_)[i_]; }
+      iterator &operator++() noexcept
+      {
+        ++i_;
+        return *this;
+      }
+      iterator operator++(int) noexcept
+      {
+        iterator t = *this;
+        ++i_;
+        return t;
+      }
+      bool operator==(const iterator &o) const noexcept { return i_ == o.i_; }
+      bool operator!=(const iterator &o) const noexcept { return i_ != o.i_; }
+
+    private:
+      const Batch *b_ = nullptr;
+      std::size_t i_ = 0;
+    };
+
+    iterator begin() const noexcept { return iterator(this, 0); }
+    iterator end() const noexcept { return iterator(this, size()); }
+
+    const xora_emp_batch_view_t &view() const noexcept { return v_; }
+
+  private:
+    xora_emp_batch_view_t v_;
+  };
+
+  /*  Cursor: streaming ORDER BY id scan  */
+
+  class Cursor
+  {
+  public:
+    Cursor() noexcept = default;
+
+    /* opts/part may be NULL (defaults, whole table) */
+    explicit Cursor(Connection &c, const xora_fetch_opts_t *opts = nullptr,
+                    const xora_emp_part_t *part = nullptr)
+        : h_(c.get())
+    {
+      detail::check(xora_emp_cursor_open_part(h_, &c_, opts, part), "xora_emp_cursor_open", h_);
+    }
+
+    ~Cursor() { xora_emp_cursor_close(&c_); }
+
+    Cursor(const Cursor &) = delete;
+    Cursor &operator=(const Cursor &) = delete;
+    Cursor(Cursor &&o) noexcept : c_(std::exchange(o.c_, nullptr)), h_(std::exchange(o.h_, nullptr)) {}
+    Cursor &operator=(Cursor &&o) noexcept
+    {
+      if (this != &o)
+      {
+        xora_emp_cursor_close(&c_);
+        c_ = std::exchange(o.c_, nullptr);
+        h_ = std::exchange(o.h_, nullptr);
+      }
+      return *this;
+    }
+
+    xora_emp_cursor_t *get() const noexcept { return c_; }
+    int batch_size() const noexcept { return xora_emp_cursor_batch_size(c_); }
+
+    /* Fetch the next batch into b; false once exhausted. b (and any earlier
+     * batch) is valid until the next call. */
+    bool next(Batch &b)
+    {
+      xora_emp_batch_view_t v;
+      xora_err_t rc = xora_emp_cursor_next_batch(c_, &v);
+      if (rc == XORA_OK)
+      {
+        b = Batch(v);
+        return true;
+      }
+      if (rc == XORA_NO_DATA_FOUND)
+        return false;
+      detail::fail(rc, "FETCH employees cursor", h_);
+    }
+
+    /* Single-pass input iterator; advancing it is the next FETCH */
+    class iterator
+    {
+    public:
+      using value_type = Batch;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() noexcept = default;
+      explicit iterator(Cursor *c) : c_(c) { ++*this; }
+      const Batch &operator*() const noexcept { return b_; }
+      const Batch *operator->() const noexcept { return &b_; }
+      iterator &operator++()
+      {
+        if (!c_->next(b_))
+          c_ = nullptr;
+        return *this;
+      }
+      void operator++(int) { ++*this; }
+      bool operator==(const iterator &o) const noexcept { return c_ == o.c_; }
+      bool operator!=(const iterator &o) const noexcept { return c_ != o.c_; }
+
+    private:
+      Cursor *c_ = nullptr;
+      Batch b_;
+    };
+
+    /* The first FETCH happens here, not at open */
+    iterator begin() { return c_ ? iterator(this) : iterator(); }
+    iterator end() noexcept { return iterator(); }
+
+  private:
+    xora_emp_cursor_t *c_ = nullptr;
+    xora_conn_t *h_ = nullptr;
+  };
+
+  inline Cursor Connection::cursor(const xora_fetch_opts_t *opts, const xora_emp_part_t *part)
+  {
+    return Cursor(*this, opts, part);
+  }
+
+  /*  Rows: stb_ds vector from xora_emp_fetch_vect (Pro*C build)  */
+
+  class Rows
+  {
+  public:
+    Rows() noexcept = default;
+    ~Rows() { xora_emp_rows_free(&v_); }
+
+    Rows(const Rows &) = delete;
+    Rows &operator=(const Rows &) = delete;
+    Rows(Rows &&o) noexcept : v_(std::exchange(o.v_, nullptr)) {}
+    Rows &operator=(Rows &&o) noexcept
+    {
+      if (this != &o)
+      {
+        xora_emp_rows_free(&v_);
+        v_ = std::exchange(o.v_, nullptr);
+      }
+      return *this;
+    }
+
+    static Rows fetch(Connection &c, int reserve_hint = 0, const xora_fetch_opts_t *opts = nullptr)
+    {
+      Rows r;
+      detail::check(xora_emp_fetch_vect_ex(c.get(), &r.v_, reserve_hint, opts), "xora_emp_fetch_vect", c.get());
+      return r;
+    }
+
+    std::size_t size() const noexcept { return (std::size_t)arrlenu(v_); }
+    bool empty() const noexcept { return size() == 0; }
+    const xora_emp_row_t *data() const noexcept { return v_; }
+    const xora_emp_row_t &operator[](std::size_t i) const noexcept { return v_[i]; }
+    const xora_emp_row_t *begin() const noexcept { return v_; }
+    const xora_emp_row_t *end() const noexcept { return v_ + size(); }
+    span<const xora_emp_row_t> view() const noexcept { return {v_, size()}; }
+
+  private:
+    xora_emp_row_t *v_ = nullptr;
+  };
+
+  /*  Columns: columnar result set (xora_emp_cols.h)  */
+
+  class Columns
+  {
+  public:
+    Columns() noexcept { xora_emp_cols_init(&c_); }
+    ~Columns() { xora_emp_cols_free(&c_); }
+
+    Columns(const Columns &) = delete;
+    Columns &operator=(const Columns &) = delete;
+    Columns(Columns &&o) noexcept : c_(o.c_) { xora_emp_cols_init(&o.c_); }
+    Columns &operator=(Columns &&o) noexcept
+    {
+      if (this != &o)
+      {
+        xora_emp_cols_free(&c_);
+        c_ = o.c_;
+        xora_emp_cols_init(&o.c_);
+      }
+      return *this;
+    }
+
+    /* Append all rows (ORDER BY id); on error nothing is appended */
+    void fetch(Connection &c, const xora_fetch_opts_t *opts = nullptr)
+    {
+      xora_err_t rc = xora_emp_fetch_cols(c.get(), &c_, opts);
+      detail::check(rc, "xora_emp_fetch_cols", c.get());
+    }
+
+    void append(const Batch &b)
+    {
+      detail::check(xora_emp_cols_append(&c_, &b.view()), "xora_emp_cols_append", nullptr);
+    }
+
+    void clear() noexcept { xora_emp_cols_clear(&c_); }
+
+    std::size_t size() const noexcept { return (std::size_t)c_.count; }
+    span<const int> empno() const noexcept { return {c_.empno, size()}; }
+    span<const double> salary() const noexcept { return {c_.salary, size()}; }
+    span<const int64_t> salary_cents() const noexcept { return {c_.salary_cents, size()}; }
+
+    bool ename_is_null(std::size_t i) const noexcept { return xora_emp_cols_is_null(&c_, (int)i); }
+    std::string_view ename(std::size_t i) const noexcept
+    {
+      size_t len = 0;
+      const char *s = xora_emp_cols_name(&c_, (int)i, &len);
+      return {s, len};
+    }
+
+    xora_emp_salary_summary_t salary_by_id(int id_lo, int id_hi) const noexcept
+    {
+      xora_emp_salary_summary_t s;
+      xora_emp_cols_salary_by_id(&c_, id_lo, id_hi, &s);
+      return s;
+    }
+
+    const xora_emp_cols_t *get() const noexcept { return &c_; }
+    xora_emp_cols_t *get() noexcept { return &c_; }
+
+  private:
+    xora_emp_cols_t c_;
+  };
+
+} // namespace xora
+
+#endif
@@ -90,6 +90,8 @@ extern "C"
    * - Ensures dst is null-terminated if dst_size > 0
    * - Never cuts inside a UTF-8 sequence
    * - Copies as much as fits using memcpy
+   * Reference version; the library calls xora_utf8_copy_bounded
+   * (xora_utf8.h), same result with SIMD fast paths.
    */
   static inline void xora_ut8_copy_bounded(char *dst, const char *src, size_t dst_size)
   {
@@ -253,6 +255,190 @@ extern "C"
     (ptr) = NULL;      \
   } while (0)
 
+/* Arena (region) allocator
+ *
+ *  - Bump-pointer allocation out of a list of chunks; blocks are never freed
+ *    one by one. xora_arena_reset() drops everything at once and keeps the
+ *    memory, xora_arena_release() gives it back.
+ *  - Meant for request-scoped data (a fetched result set, its strings, stb_ds
+ *    containers built while answering one request): one reset replaces a
+ *    free() per row.
+ *  - Chunk size doubles up to XORA_ARENA_CHUNK_MAX; after a reset that found
+ *    several chunks they are merged into one holding all bytes handed out, so a
+ *    steady workload settles on one chunk and no growth.
+ *  - XORA_ARENA_HUGEPAGES: chunks of 2 MiB and up are mmap'ed 2 MiB aligned
+ *    and advised MADV_HUGEPAGE (falls back to malloc where unavailable).
+ *  - Blocks are XORA_ARENA_ALIGN aligned. Not thread-safe: one owner at a time.
+ *
+ *  xora_arena_t a;
+ *  xora_arena_init(&a, 0, 0);
+ *  for (;;) {
+ *    xora_emp_row_t *rows; int n;
+ *    xora_emp_fetch_arena(h, &a, &rows, &n, 0, NULL);
+ *    ...
+ *    xora_arena_reset(&a);
+ *  }
+ *  xora_arena_release(&a);
+ */
+#define XORA_ARENA_ALIGN 16u
+#define XORA_ARENA_CHUNK_DEFAULT ((size_t)64u << 10)
+#define XORA_ARENA_CHUNK_MAX ((size_t)64u << 20)
+#define XORA_ARENA_HUGEPAGES 0x1u
+
+  typedef struct XoraArenaChunk
+  {
+    struct XoraArenaChunk *prev; /* older chunk */
+    size_t cap;                  /* usable bytes after this header */
+    size_t used;
+    size_t map_len;              /* != 0: mmap'ed region of this length */
+  } xora_arena_chunk_t;
+
+  typedef struct XoraArena
+  {
+    xora_arena_chunk_t *cur; /* chunk being filled */
+    void *last;              /* most recent block (can grow in place) */
+    size_t chunk_size;       /* first chunk size */
+    size_t next_size;        /* size of the next chunk */
+    size_t reserved;         /* bytes held in chunks */
+    unsigned flags;
+  } xora_arena_t;
+
+  /* Position to rewind to (scratch allocations on top of longer-lived ones) */
+  typedef struct XoraArenaMark
+  {
+    xora_arena_chunk_t *chunk;
+    size_t used;
+  } xora_arena_mark_t;
+
+  /* chunk_size 0 = XORA_ARENA_CHUNK_DEFAULT; flags XORA_ARENA_*. No memory is
+   * taken until the first allocation. */
+  static inline void xora_arena_init(xora_arena_t *a, size_t chunk_size, unsigned flags)
+  {
+    memset(a, 0, sizeof(*a));
+    a->chunk_size = chunk_size ? chunk_size : XORA_ARENA_CHUNK_DEFAULT;
+    a->next_size = a->chunk_size;
+    a->flags = flags;
+  }
+
+  /* Out of line: new chunk, then allocate `size` (already aligned) from it */
+  void *xora_arena_alloc_slow(xora_arena_t *a, size_t size);
+
+  static inline size_t xora_arena_align(size_t size)
+  {
+    if (size > SIZE_MAX - (XORA_ARENA_ALIGN - 1))
+    {
+      fprintf(stderr, "FATAL: arena size overflow (%zu)\n", size);
+      abort();
+    }
+    return (size + (XORA_ARENA_ALIGN - 1)) & ~(size_t)(XORA_ARENA_ALIGN - 1);
+  }
+
+  static inline void *xora_arena_alloc(xora_arena_t *a, size_t size)
+  {
+    size = xora_arena_align(size);
+    xora_arena_chunk_t *c = a->cur;
+    if (c && size <= c->cap - c->used)
+    {
+      void *p = (char *)(c + 1) + c->used;
+      c->used += size;
+      a->last = p;
+      return p;
+    }
+    return xora_arena_alloc_slow(a, size);
+  }
+
+  static inline void *xora_arena_calloc(xora_arena_t *a, size_t nmemb, size_t size)
+  {
+    size_t n = xora_size_mul(nmemb, size);
+    void *p = xora_arena_alloc(a, n);
+    memset(p, 0, n);
+    return p;
+  }
+
+  /* Grows (or shrinks) in place when p is the most recent block and the chunk
+   * has room; otherwise copies into a new block. The old block is not
+   * reclaimed until reset. */
+  static inline void *xora_arena_realloc(xora_arena_t *a, void *p, size_t old_size, size_t new_size)
+  {
+    if (!p)
+      return xora_arena_alloc(a, new_size);
+    if (p == a->last)
+    {
+      xora_arena_chunk_t *c = a->cur;
+      size_t off = (size_t)((char *)p - (char *)(c + 1));
+      size_t need = xora_arena_align(new_size);
+      if (need <= c->cap - off)
+      {
+        c->used = off + need;
+        return p;
+      }
+    }
+    if (new_size <= old_size)
+      return p;
+    void *q = xora_arena_alloc(a, new_size);
+    memcpy(q, p, old_size);
+    return q;
+  }
+
+  static inline char *xora_arena_strndup(xora_arena_t *a, const char *src, size_t maxlen)
+  {
+    if (!src)
+      return NULL;
+    size_t n = strnlen(src, maxlen);
+    char *dst = (char *)xora_arena_alloc(a, n + 1);
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+    return dst;
+  }
+
+  static inline char *xora_arena_strdup(xora_arena_t *a, const char *src)
+  {
+    if (!src)
+      return NULL;
+    size_t len = strlen(src) + 1;
+    char *dst = (char *)xora_arena_alloc(a, len);
+    memcpy(dst, src, len);
+    return dst;
+  }
+
+  static inline xora_arena_mark_t xora_arena_mark(const xora_arena_t *a)
+  {
+    xora_arena_mark_t m;
+    m.chunk = a->cur;
+    m.used = a->cur ? a->cur->used : 0;
+    return m;
+  }
+
+  /* Drop everything allocated since m (chunks taken after it are freed) */
+  void xora_arena_rewind(xora_arena_t *a, xora_arena_mark_t m);
+
+  /* Drop every block; keep (merged) chunk memory for reuse */
+  void xora_arena_reset(xora_arena_t *a);
+
+  /* Free all chunks; the arena is empty and reusable with the same settings */
+  void xora_arena_release(xora_arena_t *a);
+
+#define XORA_ARENA_ALLOC_ARRAY(a, T, n) ((T *)xora_arena_alloc((a), xora_size_mul((n), sizeof(T))))
+#define XORA_ARENA_CALLOC_ARRAY(a, T, n) ((T *)xora_arena_calloc((a), (n), sizeof(T)))
+
+  /* stb_ds on an arena
+   *
+   * xora_stbds.h routes STBDS_REALLOC/STBDS_FREE here. While a thread has an
+   * arena installed with xora_arena_use(), new stb_ds arrays, hash maps and
+   * strings are carved from it; each block remembers its owner, so later
+   * growth stays in that arena (which must outlive the container), arrfree()
+   * on it is a no-op, and heap-born containers stay on the heap.
+   *
+   *  xora_arena_t *prev = xora_arena_use(&a);
+   *  xora_emp_fetch_vect(h, &rows, 0);
+   *  xora_arena_use(prev);
+   */
+  xora_arena_t *xora_arena_use(xora_arena_t *a); /* returns the previous one */
+  xora_arena_t *xora_arena_current(void);
+
+  void *xora_stbds_realloc(void *p, size_t size);
+  void xora_stbds_free(void *p);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
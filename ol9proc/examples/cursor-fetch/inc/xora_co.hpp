@@ -0,0 +1,785 @@
+#ifndef XORA_CO_HPP
+#define XORA_CO_HPP
+/* xora_co.hpp — C++20 coroutines over xora.hpp
+ *
+ * Summary:
+ *   - Executor owns a fixed set of worker threads, each with its own open
+ *     session. Statements run only on the worker that owns the session, so
+ *     each session stays on one thread.
+ *   - A flow is a Task<T> coroutine. `Conn c = co_await ex.connect()` leases
+ *     a session. Every `co_await c.get_by_id(..)` / `c.create(..)` /
+ *     `tx.commit()` queues the call on that session's worker and suspends.
+ *     The worker resumes the flow when the call returns. Flows waiting for
+ *     a session, or for their statement, hold no thread. Thousands of them
+ *     can be in flight on a few workers.
+ *   - Sessions are leased exclusively, so a flow's statements form one
+ *     transaction. Tx rolls back on scope exit unless committed. Releasing
+ *     a Conn hands the session to the next waiting flow in FIFO order.
+ *   - Cursor::fetch_batch() is the awaitable array FETCH. Conn::batches()
+ *     is an async generator: `while (auto *b = co_await g.next())`. A
+ *     yielded batch is valid until the next next().
+ *   - Errors are xora::Error, thrown from the co_await that ran the call.
+ *
+ * Lifetimes: a Conn must outlive its Tx, Cursors and generators; declare it
+ * first. Its destructor does not wait. Rollback, cursor close and the
+ * session release are queued behind the flow's last call.
+ * Executor::block_on must not be called from a worker.
+ */
+
+#if __cplusplus < 202002L || !defined(__cpp_impl_coroutine)
+#error "xora_co.hpp needs C++20 coroutines"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "xora.hpp"
+
+namespace xora::co
+{
+
+  class Executor;
+  class Conn;
+
+  namespace detail
+  {
+    /* Intrusive queue node: awaiters embed one, so queuing a call does not
+     * allocate. */
+    struct Job
+    {
+      void (*exec)(Job *) = nullptr;
+      Job *next = nullptr;
+    };
+
+    struct Worker
+    {
+      xora::Connection conn;
+      std::thread th;
+      std::mutex mu;
+      std::condition_variable cv;
+      Job *head = nullptr;
+      Job *tail = nullptr;
+      bool stop = false;
+
+      void post(Job *j)
+      {
+        j->next = nullptr;
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          if (tail)
+            tail->next = j;
+          else
+            head = j;
+          tail = j;
+        }
+        cv.notify_one();
+      }
+
+      /* Runs jobs until stopped and drained */
+      void loop()
+      {
+        for (;;)
+        {
+          Job *j;
+          {
+            std::unique_lock<std::mutex> lk(mu);
+            cv.wait(lk, [this] { return head || stop; });
+            if (!head)
+              return;
+            j = head;
+            head = j->next;
+            if (!head)
+              tail = nullptr;
+          }
+          j->exec(j);
+        }
+      }
+    };
+
+    /* Fire-and-forget job (rollback, close, release); f must not throw */
+    template <class F>
+    struct FnJob : Job
+    {
+      F f;
+      explicit FnJob(F &&fn) : f(std::move(fn)) { exec = &run; }
+      static void run(Job *j)
+      {
+        FnJob *self = static_cast<FnJob *>(j);
+        self->f();
+        delete self;
+      }
+    };
+
+    template <class F>
+    void post_fn(Worker &w, F f)
+    {
+      w.post(new FnJob<F>(std::move(f)));
+    }
+
+    struct PromiseBase
+    {
+      std::coroutine_handle<> cont = std::noop_coroutine();
+      std::exception_ptr err;
+
+      std::suspend_always initial_suspend() noexcept { return {}; }
+
+      struct Final
+      {
+        bool await_ready() noexcept { return false; }
+        template <class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept { return h.promise().cont; }
+        void await_resume() noexcept {}
+      };
+      Final final_suspend() noexcept { return {}; }
+
+      void unhandled_exception() noexcept { err = std::current_exception(); }
+    };
+
+    template <class T>
+    struct TaskPromise;
+
+    /* Started by Executor::spawn/block_on; frees itself when done */
+    struct Detached
+    {
+      struct promise_type
+      {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+      };
+    };
+  } // namespace detail
+
+  /*  Task: lazy, started by co_await (or Executor::spawn/block_on)  */
+
+  template <class T = void>
+  class [[nodiscard]] Task
+  {
+  public:
+    using promise_type = detail::TaskPromise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+    explicit Task(handle_type h) noexcept : h_(h) {}
+    ~Task()
+    {
+      if (h_)
+        h_.destroy();
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    Task(Task &&o) noexcept : h_(std::exchange(o.h_, {})) {}
+    Task &operator=(Task &&o) noexcept
+    {
+      if (this != &o)
+      {
+        if (h_)
+          h_.destroy();
+        h_ = std::exchange(o.h_, {});
+      }
+      return *this;
+    }
+
+    auto operator co_await() const noexcept
+    {
+      struct Awaiter
+      {
+        handle_type h;
+        bool await_ready() const noexcept { return !h || h.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> c) noexcept
+        {
+          h.promise().cont = c;
+          return h;
+        }
+        T await_resume() { return h.promise().result(); }
+      };
+      return Awaiter{h_};
+    }
+
+  private:
+    handle_type h_;
+  };
+
+  namespace detail
+  {
+    template <class T>
+    struct TaskPromise : PromiseBase
+    {
+      std::optional<T> value;
+
+      Task<T> get_return_object() noexcept { return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this)); }
+      template <class U>
+      void return_value(U &&v) { value.emplace(std::forward<U>(v)); }
+      T result()
+      {
+        if (err)
+          std::rethrow_exception(err);
+        return std::move(*value);
+      }
+    };
+
+    template <>
+    struct TaskPromise<void> : PromiseBase
+    {
+      Task<void> get_return_object() noexcept { return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this)); }
+      void return_void() noexcept {}
+      void result()
+      {
+        if (err)
+          std::rethrow_exception(err);
+      }
+    };
+  } // namespace detail
+
+  /*  Op: one call on a session's worker  */
+
+  template <class F>
+  class [[nodiscard]] Op : private detail::Job
+  {
+  public:
+    using result_type = std::invoke_result_t<F &, xora::Connection &>;
+
+    Op(detail::Worker *w, F f) : w_(w), f_(std::move(f)) { exec = &run; }
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+      h_ = h;
+      w_->post(this); /* may resume h before this returns: no member access after */
+    }
+    result_type await_resume()
+    {
+      if (err_)
+        std::rethrow_exception(err_);
+      if constexpr (!std::is_void_v<result_type>)
+        return std::move(*val_);
+    }
+
+  private:
+    using slot_type = std::conditional_t<std::is_void_v<result_type>, std::monostate, result_type>;
+
+    static void run(detail::Job *j)
+    {
+      Op *self = static_cast<Op *>(j);
+      try
+      {
+        if constexpr (std::is_void_v<result_type>)
+          self->f_(self->w_->conn);
+        else
+          self->val_.emplace(self->f_(self->w_->conn));
+      }
+      catch (...)
+      {
+        self->err_ = std::current_exception();
+      }
+      self->h_.resume();
+    }
+
+    detail::Worker *w_;
+    F f_;
+    std::coroutine_handle<> h_;
+    std::optional<slot_type> val_;
+    std::exception_ptr err_;
+  };
+
+  /*  Generator: async stream of values, pulled with co_await next()  */
+
+  template <class T>
+  class [[nodiscard]] Generator
+  {
+  public:
+    struct promise_type
+    {
+      const T *cur = nullptr;
+      std::coroutine_handle<> consumer;
+      std::exception_ptr err;
+
+      Generator get_return_object() noexcept { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+
+      struct Yield
+      {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept { return h.promise().consumer; }
+        void await_resume() noexcept {}
+      };
+      /* The value lives in the producer's frame until it is resumed */
+      Yield yield_value(const T &v) noexcept
+      {
+        cur = &v;
+        return {};
+      }
+      Yield final_suspend() noexcept
+      {
+        cur = nullptr;
+        return {};
+      }
+      void return_void() noexcept {}
+      void unhandled_exception() noexcept { err = std::current_exception(); }
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    explicit Generator(handle_type h) noexcept : h_(h) {}
+    ~Generator()
+    {
+      if (h_)
+        h_.destroy();
+    }
+
+    Generator(const Generator &) = delete;
+    Generator &operator=(const Generator &) = delete;
+    Generator(Generator &&o) noexcept : h_(std::exchange(o.h_, {})) {}
+    Generator &operator=(Generator &&o) noexcept
+    {
+      if (this != &o)
+      {
+        if (h_)
+          h_.destroy();
+        h_ = std::exchange(o.h_, {});
+      }
+      return *this;
+    }
+
+    /* Next value, or nullptr once the producer has returned */
+    auto next() noexcept
+    {
+      struct Awaiter
+      {
+        handle_type h;
+        bool await_ready() const noexcept { return !h || h.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> c) noexcept
+        {
+          h.promise().consumer = c;
+          return h;
+        }
+        const T *await_resume()
+        {
+          if (!h)
+            return nullptr;
+          if (h.promise().err)
+            std::rethrow_exception(std::exchange(h.promise().err, nullptr));
+          return h.done() ? nullptr : h.promise().cur;
+        }
+      };
+      return Awaiter{h_};
+    }
+
+  private:
+    handle_type h_;
+  };
+
+  /*  Cursor: streaming scan on a leased session  */
+
+  class Cursor
+  {
+  public:
+    Cursor(Cursor &&o) noexcept : w_(std::exchange(o.w_, nullptr)), c_(std::move(o.c_)) {}
+    Cursor &operator=(Cursor &&o) noexcept
+    {
+      if (this != &o)
+      {
+        close();
+        w_ = std::exchange(o.w_, nullptr);
+        c_ = std::move(o.c_);
+      }
+      return *this;
+    }
+    Cursor(const Cursor &) = delete;
+    Cursor &operator=(const Cursor &) = delete;
+    ~Cursor() { close(); }
+
+    /* Next array FETCH; nullopt once exhausted. The batch is valid until the
+     * next fetch_batch. */
+    auto fetch_batch()
+    {
+      xora::Cursor *c = &c_;
+      return Op(w_, [c](xora::Connection &) -> std::optional<xora::Batch>
+                {
+                  xora::Batch b;
+                  if (c->next(b))
+                    return b;
+                  return std::nullopt; });
+    }
+
+    int batch_size() const noexcept { return c_.batch_size(); }
+
+  private:
+    friend class Conn;
+    Cursor(detail::Worker *w, xora::Cursor c) noexcept : w_(w), c_(std::move(c)) {}
+
+    /* CLOSE runs on the worker, after any fetch already queued */
+    void close() noexcept
+    {
+      if (w_ && c_.get())
+        detail::post_fn(*w_, [c = std::move(c_)]() mutable
+                        { xora::Cursor done(std::move(c)); });
+      w_ = nullptr;
+    }
+
+    detail::Worker *w_ = nullptr;
+    xora::Cursor c_;
+  };
+
+  /*  Conn: a session leased from the Executor  */
+
+  class Conn
+  {
+  public:
+    Conn(Conn &&o) noexcept : ex_(o.ex_), w_(std::exchange(o.w_, nullptr)) {}
+    Conn &operator=(Conn &&o) noexcept
+    {
+      if (this != &o)
+      {
+        release();
+        ex_ = o.ex_;
+        w_ = std::exchange(o.w_, nullptr);
+      }
+      return *this;
+    }
+    Conn(const Conn &) = delete;
+    Conn &operator=(const Conn &) = delete;
+    inline ~Conn();
+
+    /* co_await c.run(f) runs f(xora::Connection&) on the session's worker */
+    template <class F>
+    auto run(F f) { return Op<F>(w_, std::move(f)); }
+
+    auto get_by_id(int id)
+    {
+      return run([id](xora::Connection &c) { return c.get_by_id(id); });
+    }
+    /* MAX(id)+1: not for tables using xora_idalloc_t (see xora_idalloc.h) */
+    auto create(const xora_emp_row_t &row)
+    {
+      return run([row](xora::Connection &c) { return c.create(row); });
+    }
+    auto create(const xora_emp_row_t &row, int id)
+    {
+      return run([row, id](xora::Connection &c) { c.create(row, id); });
+    }
+    auto create(const xora_emp_row_t &row, xora_idalloc_t *ids)
+    {
+      return run([row, ids](xora::Connection &c) { return c.create(row, ids); });
+    }
+    auto update(const xora_emp_row_t &row)
+    {
+      return run([row](xora::Connection &c) { c.update(row); });
+    }
+    auto commit()
+    {
+      return run([](xora::Connection &c) { c.commit(); });
+    }
+    auto rollback()
+    {
+      return run([](xora::Connection &c) { c.rollback(); });
+    }
+
+    /* opts is copied; may be NULL */
+    auto open_cursor(const xora_fetch_opts_t *opts = nullptr)
+    {
+      std::optional<xora_fetch_opts_t> o;
+      if (opts)
+        o = *opts;
+      detail::Worker *w = w_;
+      return run([w, o](xora::Connection &c) { return Cursor(w, xora::Cursor(c, o ? &*o : nullptr)); });
+    }
+
+    /* Async generator over the scan's batches */
+    Generator<xora::Batch> batches(std::optional<xora_fetch_opts_t> opts = std::nullopt)
+    {
+      Cursor cur = co_await open_cursor(opts ? &*opts : nullptr);
+      while (std::optional<xora::Batch> b = co_await cur.fetch_batch())
+        co_yield *b;
+    }
+
+    /* Queued ROLLBACK, for destructors */
+    void post_rollback() noexcept
+    {
+      detail::Worker *w = w_;
+      if (w)
+        detail::post_fn(*w, [w]() noexcept { (void)xora_tx_rollback(w->conn.get()); });
+    }
+
+  private:
+    friend class Executor;
+    Conn(Executor *ex, detail::Worker *w) noexcept : ex_(ex), w_(w) {}
+    inline void release() noexcept;
+
+    Executor *ex_ = nullptr;
+    detail::Worker *w_ = nullptr;
+  };
+
+  /*  Tx: rolls back on scope exit unless committed  */
+
+  class Tx
+  {
+  public:
+    explicit Tx(Conn &c) noexcept : c_(&c) {}
+    ~Tx()
+    {
+      if (c_)
+        c_->post_rollback();
+    }
+
+    Tx(Tx &&o) noexcept : c_(std::exchange(o.c_, nullptr)) {}
+    Tx &operator=(Tx &&o) noexcept
+    {
+      if (this != &o)
+      {
+        if (c_)
+          c_->post_rollback();
+        c_ = std::exchange(o.c_, nullptr);
+      }
+      return *this;
+    }
+    Tx(const Tx &) = delete;
+    Tx &operator=(const Tx &) = delete;
+
+    /* The transaction is over once either is awaited, even if it throws */
+    auto commit() { return std::exchange(c_, nullptr)->commit(); }
+    auto rollback() { return std::exchange(c_, nullptr)->rollback(); }
+
+    bool active() const noexcept { return c_ != nullptr; }
+
+  private:
+    Conn *c_;
+  };
+
+  /*  Executor  */
+
+  class Executor
+  {
+  public:
+    /* Opens `threads` sessions up front; throws xora::Error if any fails */
+    Executor(const char *user, const char *pass, const char *db, int threads = 4)
+    {
+      if (threads < 1)
+        threads = 1;
+      workers_.reserve((std::size_t)threads);
+      for (int i = 0; i < threads; ++i)
+      {
+        auto w = std::make_unique<detail::Worker>();
+        w->conn = xora::Connection(user, pass, db);
+        workers_.push_back(std::move(w));
+      }
+      for (auto &w : workers_)
+      {
+        free_.push_back(w.get());
+        detail::Worker *p = w.get();
+        w->th = std::thread([p] { p->loop(); });
+      }
+    }
+
+    /* Waits for spawned flows, then stops the workers */
+    ~Executor()
+    {
+      wait_idle();
+      for (auto &w : workers_)
+      {
+        {
+          std::lock_guard<std::mutex> lk(w->mu);
+          w->stop = true;
+        }
+        w->cv.notify_one();
+      }
+      for (auto &w : workers_)
+        w->th.join();
+    }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    int threads() const noexcept { return (int)workers_.size(); }
+
+    /* Resume on a worker (round robin) */
+    auto schedule() noexcept
+    {
+      struct Awaiter : detail::Job
+      {
+        Executor *ex;
+        std::coroutine_handle<> h;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> c) noexcept
+        {
+          h = c;
+          exec = &run;
+          ex->pick().post(this);
+        }
+        void await_resume() noexcept {}
+        static void run(detail::Job *j) { static_cast<Awaiter *>(j)->h.resume(); }
+      };
+      Awaiter a;
+      a.ex = this;
+      return a;
+    }
+
+    /* Lease a session; waits (suspended) while all are in use */
+    auto connect() noexcept
+    {
+      struct Awaiter
+      {
+        Executor *ex;
+        detail::Worker *w = nullptr;
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> c) noexcept
+        {
+          std::lock_guard<std::mutex> lk(ex->mu_);
+          if (!ex->free_.empty())
+          {
+            w = ex->free_.back();
+            ex->free_.pop_back();
+            return false;
+          }
+          ex->waiters_.push_back({&w, c});
+          return true;
+        }
+        Conn await_resume() noexcept { return Conn(ex, w); }
+      };
+      return Awaiter{this};
+    }
+
+    /* Run t detached; an exception it lets escape is counted in errors() */
+    void spawn(Task<void> t)
+    {
+      {
+        std::lock_guard<std::mutex> lk(idle_mu_);
+        ++outstanding_;
+      }
+      drive(this, std::move(t));
+    }
+
+    /* Run t on the workers and wait for its result (not from a worker) */
+    template <class T>
+    T block_on(Task<T> t)
+    {
+      std::promise<T> p;
+      std::future<T> f = p.get_future();
+      drive_to(this, std::move(t), &p);
+      return f.get();
+    }
+
+    void wait_idle()
+    {
+      std::unique_lock<std::mutex> lk(idle_mu_);
+      idle_cv_.wait(lk, [this] { return outstanding_ == 0; });
+    }
+
+    long long errors() const noexcept { return errors_.load(std::memory_order_relaxed); }
+
+  private:
+    friend class Conn;
+
+    struct Waiter
+    {
+      detail::Worker **slot;
+      std::coroutine_handle<> h;
+    };
+
+    detail::Worker &pick() noexcept
+    {
+      unsigned i = rr_.fetch_add(1, std::memory_order_relaxed);
+      return *workers_[i % workers_.size()];
+    }
+
+    /* On w's thread, once its queued calls are done: next waiter or free */
+    void hand_over(detail::Worker *w) noexcept
+    {
+      std::unique_lock<std::mutex> lk(mu_);
+      if (waiters_head_ == waiters_.size())
+      {
+        free_.push_back(w);
+        return;
+      }
+      Waiter wt = waiters_[waiters_head_++];
+      if (waiters_head_ == waiters_.size())
+      {
+        waiters_.clear();
+        waiters_head_ = 0;
+      }
+      lk.unlock();
+      *wt.slot = w;
+      wt.h.resume();
+    }
+
+    void release(detail::Worker *w) noexcept
+    {
+      detail::post_fn(*w, [this, w]() noexcept { hand_over(w); });
+    }
+
+    static detail::Detached drive(Executor *ex, Task<void> t)
+    {
+      co_await ex->schedule();
+      try
+      {
+        co_await t;
+      }
+      catch (...)
+      {
+        ex->errors_.fetch_add(1, std::memory_order_relaxed);
+      }
+      std::lock_guard<std::mutex> lk(ex->idle_mu_);
+      if (--ex->outstanding_ == 0)
+        ex->idle_cv_.notify_all();
+    }
+
+    template <class T>
+    static detail::Detached drive_to(Executor *ex, Task<T> t, std::promise<T> *p)
+    {
+      co_await ex->schedule();
+      try
+      {
+        if constexpr (std::is_void_v<T>)
+        {
+          co_await t;
+          p->set_value();
+        }
+        else
+          p->set_value(co_await t);
+      }
+      catch (...)
+      {
+        p->set_exception(std::current_exception());
+      }
+    }
+
+    std::vector<std::unique_ptr<detail::Worker>> workers_;
+    std::atomic<unsigned> rr_{0};
+
+    std::mutex mu_; /* free_, waiters_ */
+    std::vector<detail::Worker *> free_;
+    std::vector<Waiter> waiters_; /* FIFO from waiters_head_ */
+    std::size_t waiters_head_ = 0;
+
+    std::mutex idle_mu_;
+    std::condition_variable idle_cv_;
+    long long outstanding_ = 0;
+    std::atomic<long long> errors_{0};
+  };
+
+  inline Conn::~Conn() { release(); }
+
+  inline void Conn::release() noexcept
+  {
+    if (w_)
+      ex_->release(std::exchange(w_, nullptr));
+  }
+
+} // namespace xora::co
+
+#endif
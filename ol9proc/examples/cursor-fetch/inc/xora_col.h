@@ -0,0 +1,49 @@
+#ifndef XORA_COL_H
+#define XORA_COL_H
+/* xora_col.h — vector kernels over plain column arrays
+ *
+ * Summary:
+ *   - Aggregates (sum, min/max), range counts and range filters over double
+ *     and int columns, exact int64 sums (money in cents), plus sums over a
+ *     selection vector.
+ *   - AVX2 and scalar versions, dispatched per call on xora_simd_level().
+ *   - Double sums accumulate in 16 fixed lanes that are reduced in a fixed
+ *     order on every path, so a total is bit-identical whichever ISA ran it.
+ *   - Ranges are inclusive: lo <= v <= hi. Double columns must not hold NaN.
+ *   - A selection vector lists qualifying row indexes in ascending order; the
+ *     caller sizes it for n entries.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  double xora_col_sum_f64(const double *v, size_t n);
+  int64_t xora_col_sum_i32(const int *v, size_t n);
+  int64_t xora_col_sum_i64(const int64_t *v, size_t n); /* wraps on overflow */
+
+  /* 0 (outputs untouched) when n == 0, else 1. */
+  int xora_col_minmax_f64(const double *v, size_t n, double *out_min, double *out_max);
+  int xora_col_minmax_i32(const int *v, size_t n, int *out_min, int *out_max);
+
+  size_t xora_col_count_range_f64(const double *v, size_t n, double lo, double hi);
+  size_t xora_col_count_range_i32(const int *v, size_t n, int lo, int hi);
+
+  /* Write the indexes i with lo <= v[i] <= hi to sel; returns how many. */
+  size_t xora_col_filter_range_f64(const double *v, size_t n, double lo, double hi, uint32_t *sel);
+  size_t xora_col_filter_range_i32(const int *v, size_t n, int lo, int hi, uint32_t *sel);
+
+  /* Aggregates over v[sel[0..nsel)]. */
+  double xora_col_sum_f64_sel(const double *v, const uint32_t *sel, size_t nsel);
+  int64_t xora_col_sum_i64_sel(const int64_t *v, const uint32_t *sel, size_t nsel);
+  int xora_col_minmax_f64_sel(const double *v, const uint32_t *sel, size_t nsel,
+                              double *out_min, double *out_max);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -29,6 +29,11 @@ xora_err_t xora_conn_is_open( xora_conn_t* ctx);
 /* Destroy the handle and free resources. Closes if still open. */
 void       xora_conn_destroy(xora_conn_t** ctxp);
 
+/* sqlcode of the last statement on this handle: 0 ok, 1403 or 100 no data,
+ * <0 error. Each handle keeps its own status, so threads on separate handles
+ * never see each other's. msg (optional) receives the Oracle message text. */
+long       xora_conn_sqlcode(const xora_conn_t* ctx, char* msg, size_t msg_cap);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -0,0 +1,66 @@
+#ifndef XORA_DECIMAL_H
+#define XORA_DECIMAL_H
+/* xora_decimal.h — exact money: Oracle NUMBER <-> int64 cents
+ *
+ * Summary:
+ *   - Salaries are NUMBER(8,2). Fetched as VARNUM (the NUMBER bytes behind a
+ *     length byte) they convert to scaled int64 cents with integer
+ *     arithmetic only: no binary floating point anywhere between the
+ *     database and the total.
+ *   - VARNUM layout: [len][exponent][base-100 digits...]. Positive: exponent
+ *     byte 193 + e, digit byte d + 1. Negative: exponent byte 62 - e, digit
+ *     byte 101 - d, then a 102 terminator when there is room. Zero is [1][0x80].
+ *   - Values with more than two decimals are rounded half away from zero.
+ *     Magnitudes of 10^16 and up do not fit (returned as errors).
+ *   - Results do not depend on the SIMD level.
+ *   - The same conversion from decimal strings (e.g. TO_CHAR output).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define XORA_VARNUM_SIZE 22
+
+  typedef unsigned char xora_varnum_t[XORA_VARNUM_SIZE];
+
+  /* 0 on success; -1 (and *out = 0) for malformed bytes, +/-infinity or
+   * overflow. vn is a whole xora_varnum_t: all XORA_VARNUM_SIZE bytes are
+   * read, whatever its length byte says. */
+  int xora_varnum_to_cents(const unsigned char *vn, int64_t *out);
+
+  /* Encode cents as VARNUM (binds, simulator, tests); -1 when |cents| >= 10^18. */
+  int xora_varnum_from_cents(int64_t cents, unsigned char *vn);
+
+  /* Bulk decode of a fetched host array (AVX2 when available); failed
+   * entries become 0. Returns the number of failures. */
+  int xora_varnum_to_cents_batch(const xora_varnum_t *vn, int n, int64_t *out);
+
+  /* "[ ][+|-]digits[.digits][ ]" -> cents; 0 or -1 (syntax, overflow). */
+  int xora_dec_to_cents(const char *s, size_t len, int64_t *out);
+
+  /* Bulk parse of n NUL-terminated fields, `stride` bytes apart (a STRING
+   * host array); failed entries become 0. Returns the number of failures. */
+  int xora_dec_to_cents_batch(const char *base, size_t stride, int n, int64_t *out);
+
+  /* cents / 100 rounded to the nearest double. */
+  void xora_cents_to_double_batch(const int64_t *cents, int n, double *out);
+
+  /* Nearest cents of a double (exact for any value that came from cents). */
+  static inline int64_t xora_cents_from_double(double v)
+  {
+    double c = v * 100.0;
+    return (int64_t)(c < 0 ? c - 0.5 : c + 0.5);
+  }
+
+  /* "-1234.56"; returns the length (snprintf semantics). */
+  int xora_cents_format(int64_t cents, char *buf, size_t size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,106 @@
+#ifndef XORA_EMP_CACHE_H
+#define XORA_EMP_CACHE_H
+/* xora_emp_cache.h — sharded in-process row cache for employees by id
+ *
+ * Summary:
+ *   - nshards independent tables, each behind its own mutex; the shard is
+ *     picked from the id hash, so hot ids spread over locks.
+ *   - Per shard: fixed slot array of entries + open-addressing index
+ *     (linear probing, backward-shift delete); no allocation after create.
+ *   - CLOCK eviction (one reference bit per entry) and a per-entry TTL.
+ *   - Once installed, xora_emp_get_by_id reads through the cache. The CRUD
+ *     writers record the ids they touch on the session (xora_emp_dirty_t);
+ *     xora_tx_commit / xora_tx_rollback invalidate them once the outcome is
+ *     settled. Invalidating at DML time would let other sessions re-cache
+ *     the old committed row before the commit, and the writer could cache
+ *     its own uncommitted row. Until then the writing session bypasses the
+ *     cache for those ids, neither reading nor filling it.
+ *
+ * Staleness: invalidation is per process. Writes from other processes (or
+ * other libraries) are only picked up when the entry expires, so ttl_ms is
+ * the bound on staleness for those.
+ */
+
+#include <stddef.h>
+#include "xora_error.h"
+#include "xora_proc_emp.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct xora_emp_cache xora_emp_cache_t;
+
+  typedef struct XoraEmpCacheConfig
+  {
+    int capacity; /* total entries across shards; <=0 = 4096 */
+    int nshards;  /* rounded up to a power of two; <=0 = 16 */
+    int ttl_ms;   /* entry lifetime; <=0 = never expires */
+  } xora_emp_cache_config_t;
+
+  typedef struct XoraEmpCacheStats
+  {
+    long long hits;
+    long long misses;
+    long long evictions;     /* pushed out by CLOCK to make room */
+    long long expirations;   /* found past their TTL */
+    long long invalidations; /* dropped by update/delete */
+    long long inserts;
+    int size;
+    int capacity;
+  } xora_emp_cache_stats_t;
+
+  void xora_emp_cache_config_init(xora_emp_cache_config_t *cfg);
+
+  xora_err_t xora_emp_cache_create(xora_emp_cache_t **out, const xora_emp_cache_config_t *cfg);
+
+  /* Copy a live entry into *out; XORA_NO_DATA_FOUND on a miss. */
+  xora_err_t xora_emp_cache_lookup(xora_emp_cache_t *c, int empno, xora_emp_row_t *out);
+
+  /* Invalidation generation of empno's shard. Read it before going to the
+   * database and pass it to xora_emp_cache_fill: a fill that raced with an
+   * invalidation of the same shard is dropped instead of caching a stale row. */
+  unsigned xora_emp_cache_gen(xora_emp_cache_t *c, int empno);
+
+  /* Insert or refresh an entry (no-op if the shard generation moved past gen). */
+  void xora_emp_cache_fill(xora_emp_cache_t *c, const xora_emp_row_t *row, unsigned gen);
+
+  void xora_emp_cache_invalidate(xora_emp_cache_t *c, int empno);
+  void xora_emp_cache_clear(xora_emp_cache_t *c);
+
+  void xora_emp_cache_get_stats(xora_emp_cache_t *c, xora_emp_cache_stats_t *out);
+
+  /* Ids a session has written in its open transaction. Zero-initialised is
+   * empty; past XORA_EMP_DIRTY_MAX ids only `all` is kept, and the whole
+   * cache is cleared at the end of the transaction. */
+#ifndef XORA_EMP_DIRTY_MAX
+#define XORA_EMP_DIRTY_MAX 4096
+#endif
+  typedef struct XoraEmpDirty
+  {
+    int *slots;    /* open-addressed set, cap entries */
+    unsigned cap;  /* power of two, 0 = nothing allocated */
+    int n;
+    int all;       /* overflowed: treat every id as written */
+  } xora_emp_dirty_t;
+
+  void xora_emp_dirty_add(xora_emp_dirty_t *d, int empno);
+  int xora_emp_dirty_has(const xora_emp_dirty_t *d, int empno);
+
+  /* Transaction over: invalidate the recorded ids in c (may be NULL) and
+   * empty the set. Keeps the buffer. */
+  void xora_emp_dirty_flush(xora_emp_dirty_t *d, xora_emp_cache_t *c);
+  void xora_emp_dirty_free(xora_emp_dirty_t *d);
+
+  /* Process-wide cache used by the employee CRUD functions (NULL = none).
+   * Uninstall, and let in-flight calls finish, before destroying it. */
+  void xora_emp_cache_install(xora_emp_cache_t *c);
+  xora_emp_cache_t *xora_emp_cache_installed(void);
+
+  void xora_emp_cache_destroy(xora_emp_cache_t **c);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
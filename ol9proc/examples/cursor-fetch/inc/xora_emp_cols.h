@@ -0,0 +1,97 @@
+#ifndef XORA_EMP_COLS_H
+#define XORA_EMP_COLS_H
+/* xora_emp_cols.h — columnar (struct-of-arrays) employee result sets
+ *
+ * Summary:
+ *   - One array per column: empno[], salary[], a NULL bitmap for ename and
+ *     the names packed into one byte blob addressed by offsets. A salary scan
+ *     touches 8 bytes per row instead of a 72-byte xora_emp_row_t.
+ *   - salary_cents holds the exact fetched value; sums are taken over it,
+ *     the double column serves ranges and min/max.
+ *   - Filled straight from the cursor's host arrays (column to column, no
+ *     row structs in between).
+ *   - Aggregates run on the xora_col.h kernels (AVX2 when available).
+ *   - Names are stored NUL-terminated; a NULL name is an empty string with
+ *     its bit set.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xora_error.h"
+#include "xora_contex.h"
+#include "xora_proc_emp.h"
+#include "xora_proc_emp_fetch.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct XoraEmpCols
+  {
+    int count;            /* rows held */
+    int cap;              /* rows allocated */
+    int *empno;
+    double *salary;
+    int64_t *salary_cents;
+    uint64_t *ename_null; /* bit i set: ename of row i is NULL */
+    uint32_t *ename_off;  /* cap + 1 entries; row i is ename_bytes[off[i] .. off[i+1]) incl. NUL */
+    char *ename_bytes;
+    size_t bytes_len;
+    size_t bytes_cap;
+  } xora_emp_cols_t;
+
+  void xora_emp_cols_init(xora_emp_cols_t *c);
+  void xora_emp_cols_free(xora_emp_cols_t *c);
+
+  /* Drop the rows, keep the memory. */
+  void xora_emp_cols_clear(xora_emp_cols_t *c);
+
+  /* Make room for `rows` more rows (and about avg_name bytes per name). */
+  xora_err_t xora_emp_cols_reserve(xora_emp_cols_t *c, int rows, size_t avg_name);
+
+  /* Append one fetched batch. XORA_ALLOCATION_FAILED if the name blob would
+   * pass 4 GiB (offsets are 32-bit). */
+  xora_err_t xora_emp_cols_append(xora_emp_cols_t *c, const xora_emp_batch_view_t *v);
+
+  /* Fetch all rows (ORDER BY id) and append them; on error c is left as it
+   * was. opts may be NULL. */
+  xora_err_t xora_emp_fetch_cols(xora_conn_t *h, xora_emp_cols_t *c, const xora_fetch_opts_t *opts);
+
+  static inline int xora_emp_cols_is_null(const xora_emp_cols_t *c, int i)
+  {
+    return (int)((c->ename_null[i >> 6] >> (i & 63)) & 1u);
+  }
+
+  /* Name of row i (NUL-terminated); *len (may be NULL) excludes the NUL. */
+  static inline const char *xora_emp_cols_name(const xora_emp_cols_t *c, int i, size_t *len)
+  {
+    if (len)
+      *len = c->ename_off[i + 1] - c->ename_off[i] - 1;
+    return c->ename_bytes + c->ename_off[i];
+  }
+
+  /* Materialise row i. */
+  void xora_emp_cols_get_row(const xora_emp_cols_t *c, int i, xora_emp_row_t *out);
+
+  typedef struct XoraEmpSalarySummary
+  {
+    long long count;
+    int64_t sum_cents; /* exact */
+    double sum;        /* sum_cents / 100 */
+    double min; /* 0 when count == 0 */
+    double max;
+  } xora_emp_salary_summary_t;
+
+  /* Salary count/sum/min/max over rows with id_lo <= empno <= id_hi. */
+  void xora_emp_cols_salary_by_id(const xora_emp_cols_t *c, int id_lo, int id_hi,
+                                  xora_emp_salary_summary_t *out);
+
+  /* Rows with sal_lo <= salary <= sal_hi. */
+  long long xora_emp_cols_count_salary(const xora_emp_cols_t *c, double sal_lo, double sal_hi);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,61 @@
+#ifndef XORA_EMP_PIPE_H
+#define XORA_EMP_PIPE_H
+/* xora_emp_pipe.h — double/N-buffered prefetch pipeline over the streaming cursor
+ *
+ * Summary:
+ *   - A dedicated fetch thread fills the next host-array buffer while the
+ *     consumer works on the current one.
+ *   - nbuf buffers (>= 2) bound memory and give backpressure: the fetch thread
+ *     blocks when every buffer is ready or held by the consumer.
+ *   - The connection belongs to the fetch thread between open and close;
+ *     do not use it for anything else meanwhile.
+ */
+
+#include "xora_error.h"
+#include "xora_contex.h"
+#include "xora_proc_emp_fetch.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct xora_emp_pipe xora_emp_pipe_t;
+
+  typedef struct XoraPipeStats
+  {
+    long long batches;
+    long long rows;
+    long long producer_stall_us; /* fetch thread waiting for a free buffer */
+    long long consumer_stall_us; /* consumer waiting for a ready buffer */
+  } xora_pipe_stats_t;
+
+  /* Open the cursor on the caller's thread, then start the fetch thread.
+   * nbuf < 2 is raised to 2; opts may be NULL for defaults. */
+  xora_err_t xora_emp_pipe_open(xora_conn_t *h,
+                                xora_emp_pipe_t **out,
+                                int nbuf,
+                                const xora_fetch_opts_t *opts);
+
+  /* Same over one partition of the scan (part == NULL: whole table). */
+  xora_err_t xora_emp_pipe_open_part(xora_conn_t *h,
+                                     xora_emp_pipe_t **out,
+                                     int nbuf,
+                                     const xora_fetch_opts_t *opts,
+                                     const xora_emp_part_t *part);
+
+  /* Hand back the previous batch and wait for the next one.
+   * *view stays valid until the next call or close.
+   * Returns XORA_NO_DATA_FOUND at end; if the fetch thread failed, the
+   * fetch error (XORA_CONN_ERR when the session is gone, XORA_ERR else). */
+  xora_err_t xora_emp_pipe_next(xora_emp_pipe_t *p, xora_emp_batch_view_t *view);
+
+  void xora_emp_pipe_get_stats(xora_emp_pipe_t *p, xora_pipe_stats_t *out);
+
+  /* Stop the fetch thread (after its in-flight FETCH), close the cursor, free buffers. */
+  void xora_emp_pipe_close(xora_emp_pipe_t **p);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
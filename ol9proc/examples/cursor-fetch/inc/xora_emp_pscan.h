@@ -0,0 +1,70 @@
+#ifndef XORA_EMP_PSCAN_H
+#define XORA_EMP_PSCAN_H
+/* xora_emp_pscan.h — parallel partitioned scan of employees over pooled sessions
+ *
+ * Summary:
+ *   - The scan is split into nparts partitions, by id range (MIN..MAX cut into
+ *     equal spans) or by ORA_HASH(id, nparts - 1) bucket.
+ *   - Every partition runs on its own pooled session and its own thread.
+ *   - Unordered: each partition thread hands its batches to the callback as
+ *     they arrive (highest throughput; callback runs concurrently).
+ *   - Ordered: batches arrive on the caller's thread in id order. Range
+ *     partitions are replayed back to back (no copy); hash partitions are
+ *     k-way merged into output batches.
+ */
+
+#include "xora_error.h"
+#include "xora_contex.h"
+#include "xora_pool.h"
+#include "xora_proc_emp_fetch.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef enum XORA_PSCAN_SPLIT
+  {
+    XORA_PSCAN_RANGE = 0, /* id BETWEEN lo AND hi; skewed ids give skewed partitions */
+    XORA_PSCAN_HASH = 1   /* ORA_HASH(id, n - 1) = i; even spread, full scan per session */
+  } xora_pscan_split_t;
+
+  /* Batch callback. `part` is the partition index, or -1 for merged batches.
+   * The view is only valid during the call. Return non-zero to stop the scan. */
+  typedef int (*xora_pscan_cb_t)(void *ud, int part, const xora_emp_batch_view_t *view);
+
+  typedef struct XoraPscanOpts
+  {
+    int nparts;             /* partitions = sessions = threads; <=0 = 4 */
+    xora_pscan_split_t split;
+    int ordered;            /* deliver in ORDER BY id on the caller's thread */
+    int nbuf;               /* ordered: prefetch buffers per partition; <2 = 2 */
+    int merge_batch;        /* ordered + hash: rows per merged batch; <=0 = XORA_MAX_BATCH */
+    int acquire_timeout_ms; /* per session checkout; <0 = wait forever */
+    xora_fetch_opts_t fetch;
+  } xora_pscan_opts_t;
+
+  typedef struct XoraPscanStats
+  {
+    int parts;
+    long long rows;
+    long long batches;     /* callback invocations */
+    long long max_part_rows;
+    long long min_part_rows; /* max/min shows partition skew */
+  } xora_pscan_stats_t;
+
+  void xora_pscan_opts_init(xora_pscan_opts_t *opts);
+
+  /* Run the scan. All nparts sessions are checked out up front (the pool must
+   * allow that many); XORA_TIMEOUT if they could not be had in time.
+   * A callback stop is not an error. stats may be NULL. */
+  xora_err_t xora_emp_pscan(xora_pool_t *pool,
+                            const xora_pscan_opts_t *opts,
+                            xora_pscan_cb_t cb,
+                            void *ud,
+                            xora_pscan_stats_t *stats);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,90 @@
+#ifndef XORA_EMP_WBQ_H
+#define XORA_EMP_WBQ_H
+/* xora_emp_wbq.h — group-commit write-behind queue for employee creation
+ *
+ * Summary:
+ *   - Any number of threads submit rows; submission is a lock-free push onto
+ *     an intrusive MPSC queue (no database work on the caller's thread).
+ *   - One writer thread owns one connection. It drains up to max_batch rows
+ *     (waiting at most linger_ms for a group to fill), assigns ids from the
+ *     block allocator, array-inserts the group and COMMITs once.
+ *   - Each submission is resolved with its id and status, either through a
+ *     ticket the caller waits on or through a callback on the writer thread.
+ *
+ * A row is durable only once its ticket/callback reports XORA_OK.
+ */
+
+#include "xora_error.h"
+#include "xora_contex.h"
+#include "xora_idalloc.h"
+#include "xora_proc_emp.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct xora_emp_wbq xora_emp_wbq_t;
+  typedef struct xora_wb_ticket xora_wb_ticket_t;
+
+  /* Completion callback; runs on the writer thread after the group's COMMIT
+   * (or failure). Keep it short: the next group waits for it. */
+  typedef void (*xora_wb_done_cb_t)(void *ud, xora_err_t rc, int empno);
+
+  typedef struct XoraWbqConfig
+  {
+    int max_batch; /* rows per group (1..XORA_BULK_MAX_CHUNK); <=0 = XORA_BULK_CHUNK */
+    int linger_ms; /* wait for a group to fill after its first row; 0 = commit what is there */
+
+    /* Writer session: owned by the writer thread between create and destroy. */
+    xora_conn_t *conn;
+
+    /* Id source. NULL = MAX(id)+1 per group, only safe while this queue is
+     * the sole writer of employees. */
+    xora_idalloc_t *ids;
+  } xora_wbq_config_t;
+
+  typedef struct XoraWbqStats
+  {
+    long long submitted;
+    long long rows_ok;
+    long long rows_failed;
+    long long groups;  /* = commits attempted */
+    int max_group;
+    int pending;       /* submitted, not yet resolved */
+  } xora_wbq_stats_t;
+
+  void xora_wbq_config_init(xora_wbq_config_t *cfg);
+
+  xora_err_t xora_wbq_create(xora_emp_wbq_t **out, const xora_wbq_config_t *cfg);
+
+  /* Queue a copy of row; *out_ticket must later go to xora_wb_ticket_free. */
+  xora_err_t xora_wbq_submit(xora_emp_wbq_t *q, const xora_emp_row_t *row,
+                             xora_wb_ticket_t **out_ticket);
+
+  /* Queue a copy of row; cb(ud, rc, empno) is called exactly once. */
+  xora_err_t xora_wbq_submit_cb(xora_emp_wbq_t *q, const xora_emp_row_t *row,
+                                xora_wb_done_cb_t cb, void *ud);
+
+  /* Wait for the ticket's group to commit.
+   * timeout_ms: 0 = poll, <0 = wait forever. Returns XORA_TIMEOUT while
+   * still pending, else the row's outcome (XORA_OK + *out_empno on success). */
+  xora_err_t xora_wb_ticket_wait(xora_wb_ticket_t *t, int timeout_ms, int *out_empno);
+
+  /* Free a resolved ticket (a pending ticket is released by the writer once resolved). */
+  void xora_wb_ticket_free(xora_wb_ticket_t **t);
+
+  /* Blocking convenience: submit + wait + free. */
+  xora_err_t xora_wbq_create_employee(xora_emp_wbq_t *q, const xora_emp_row_t *row,
+                                      int *out_empno);
+
+  void xora_wbq_get_stats(xora_emp_wbq_t *q, xora_wbq_stats_t *out);
+
+  /* Stop accepting rows, write out everything already queued, join the writer.
+   * No thread may still be inside xora_wb_ticket_wait on this queue. */
+  void xora_wbq_destroy(xora_emp_wbq_t **q);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,75 @@
+#ifndef XORA_IDALLOC_H
+#define XORA_IDALLOC_H
+/* xora_idalloc.h — block id allocator (public API; no Pro*C tokens/types here)
+ *
+ * Summary:
+ *   - Reserves a range of block_size ids per round trip and hands them out
+ *     locally with a lock-free CAS; the mutex is only taken to refill.
+ *   - SEQUENCE: SELECT employees_seq.NEXTVAL; the sequence INCREMENT BY must
+ *     equal block_size (see example_data.sql). Create reads it and rejects a
+ *     mismatch, or takes it as block_size when none is given.
+ *   - HILO: bumps the counter row xora_id_blocks(name) inside an autonomous
+ *     PL/SQL block, so the reservation commits on its own and never holds a
+ *     row lock inside the caller's transaction.
+ *   - Ids are unique, increasing per block, not gap-free (unused ids of a
+ *     block are lost when the allocator is destroyed).
+ *   - Rows already there never collide: create lifts the HILO counter row
+ *     above MAX(employees.id), and refuses a sequence that is not above it.
+ *     From then on the allocator must be
+ *     the only source of new ids for the table, in every process: its
+ *     reserved but unused ids lie above MAX(id), so a MAX(id)+1 writer
+ *     (xora_emp_next_id, create_autoid, bulk_create without ids,
+ *     create_employee_with_lock*) would collide with them. All writers of a
+ *     table switch together; the library does not check it.
+ */
+
+#include "xora_error.h"
+#include "xora_contex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct xora_idalloc xora_idalloc_t;
+
+  typedef enum XORA_IDALLOC_MODE
+  {
+    XORA_IDALLOC_SEQUENCE = 0,
+    XORA_IDALLOC_HILO = 1
+  } xora_idalloc_mode_t;
+
+  typedef struct XoraIdAllocConfig
+  {
+    xora_idalloc_mode_t mode;
+    int block_size;   /* ids per reservation (>0); SEQUENCE: 0 = INCREMENT BY */
+    const char *name; /* HILO counter key; NULL = "employees" */
+  } xora_idalloc_config_t;
+
+  /* `h` is used at create only, to check the id source (the session's
+   * transaction is neither joined nor committed).
+   * SEQUENCE: XORA_NO_DATA_FOUND without employees_seq, XORA_ERR when its
+   * INCREMENT BY differs from a non-zero block_size. The first block is
+   * reserved here; XORA_ERR if it is not above MAX(id). The sequence is never
+   * altered: provision it above the existing ids (START WITH / RESTART).
+   * HILO: lifts the counter row above MAX(id) (autonomous, serialized by the
+   * row lock); XORA_NO_DATA_FOUND without the counter row. */
+  xora_err_t xora_idalloc_create(xora_idalloc_t **out, const xora_idalloc_config_t *cfg,
+                                 xora_conn_t *h);
+
+  /* Next id. `h` is only used when the current block is exhausted;
+   * any open session works, the reservation does not join its transaction. */
+  xora_err_t xora_idalloc_next(xora_idalloc_t *a, xora_conn_t *h, int *out_id);
+
+  /* n ids into out_ids (not necessarily contiguous across blocks). */
+  xora_err_t xora_idalloc_next_n(xora_idalloc_t *a, xora_conn_t *h, int n, int *out_ids);
+
+  /* Round trips spent on reservations so far. */
+  long long xora_idalloc_refills(xora_idalloc_t *a);
+
+  void xora_idalloc_destroy(xora_idalloc_t **a);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,89 @@
+#ifndef XORA_LOG_H
+#define XORA_LOG_H
+/* xora_log.h — structured error/trace log, written off the calling thread
+ *
+ * Summary:
+ *   - One key=value line per record, with bounded fields:
+ *       ts=1700000000.123456 level=ERR tid=3 src=ora step=FETCH code=-3113 msg=ORA-03113: ...
+ *     Strings are capped (%.Ns) and newlines in messages become spaces, so a
+ *     record is always exactly one line of at most XORA_LOG_LINE bytes.
+ *   - The caller formats into a per-thread buffer, then copies the line into
+ *     a bounded lock-free ring. A single writer thread drains the ring and
+ *     writes whole batches with one fwrite.
+ *   - A full ring drops the record and counts it. The writer then reports
+ *     how many were lost. Logging never waits for the writer or the output.
+ *   - Before xora_log_start (and after xora_log_stop) records are written
+ *     synchronously, with one fwrite per line. XORA_ORA_OK and friends
+ *     (xora_proc_helper.h) log through here either way.
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include "xora_error.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef XORA_LOG_LINE
+#define XORA_LOG_LINE 256 /* bytes per record, '\n' included */
+#endif
+
+  typedef enum XORA_LOG_LEVEL
+  {
+    XORA_LOG_DEBUG = 0,
+    XORA_LOG_INFO = 1,
+    XORA_LOG_WARN = 2,
+    XORA_LOG_ERR = 3
+  } xora_log_level_t;
+
+  typedef struct XoraLogConfig
+  {
+    FILE *out;         /* NULL = stderr */
+    int ring_slots;    /* records buffered; rounded up to a power of two; <=0 = 4096 */
+    int idle_sleep_us; /* writer poll interval when the ring is empty; <=0 = 1000 */
+  } xora_log_config_t;
+
+  typedef struct XoraLogStats
+  {
+    long long written;   /* records written by the writer thread */
+    long long dropped;   /* records lost to a full ring */
+    long long truncated; /* records cut at XORA_LOG_LINE */
+    long long sync;      /* records written on the calling thread */
+  } xora_log_stats_t;
+
+  void xora_log_config_init(xora_log_config_t *cfg);
+
+  /* Start the writer thread; XORA_ERR if already started or out of memory. */
+  xora_err_t xora_log_start(const xora_log_config_t *cfg);
+
+  /* Write what is buffered, stop the writer and go back to synchronous
+   * output. Records being logged concurrently land in one or the other. */
+  void xora_log_stop(void);
+
+  /* Output for synchronous records (and the default for xora_log_start).
+   * NULL = stderr. Set it before logging starts. */
+  void xora_log_set_output(FILE *out);
+
+  /* Records below level are discarded (default XORA_LOG_INFO). */
+  void xora_log_set_level(xora_log_level_t level);
+
+  /* An Oracle status: step and msg (msg_len bytes, not NUL-terminated) as in
+   * the sqlca. */
+  void xora_log_ora(xora_log_level_t level, const char *step, long code,
+                    const char *msg, int msg_len);
+
+  /* Free-form record from src; fmt should produce key=value pairs. */
+  void xora_logf(xora_log_level_t level, const char *src, const char *fmt, ...)
+#if defined(__GNUC__) && !defined(ORA_PROC)
+      __attribute__((format(printf, 3, 4)))
+#endif
+      ;
+
+  void xora_log_get_stats(xora_log_stats_t *out);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,115 @@
+#ifndef XORA_POOL_H
+#define XORA_POOL_H
+/* xora_pool.h — thread-safe connection pool (public API; no Pro*C tokens/types here)
+ *
+ * Summary:
+ *   - Fixed [min_size, max_size] set of xora_conn_t sessions shared by worker threads.
+ *   - Checkout/return hit a lock-free idle stack; the mutex is only taken to grow,
+ *     to wait for a free session, or to wake a waiter.
+ *   - min_size sessions are opened in parallel at create time (warm-up).
+ *   - Sessions idle above min_size longer than idle_timeout_ms are evicted.
+ *   - Each slot tracks health; broken sessions are destroyed and re-created lazily.
+ *   - After a failed logon the pool does not grow again for 50 ms, doubling per
+ *     further failure up to 5 s; checkouts wait (within their timeout) meanwhile.
+ *
+ * Connections are produced by a factory. The default factory uses
+ * xora_conn_create/xora_conn_open/xora_conn_is_open/xora_conn_destroy with the
+ * credentials from the config; a stub factory can be passed instead so the pool
+ * can be exercised (and benchmarked) without a database.
+ */
+
+#include <stddef.h>
+#include "xora_error.h"
+#include "xora_contex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct xora_pool xora_pool_t;
+
+  typedef enum XORA_CONN_HEALTH
+  {
+    XORA_HEALTH_OK = 0,      /* session is fine, return to idle set */
+    XORA_HEALTH_SUSPECT = 1, /* caller saw an error; ping before next checkout */
+    XORA_HEALTH_BROKEN = 2   /* session is unusable; destroy it */
+  } xora_conn_health_t;
+
+  /* Connection factory. All callbacks may run concurrently from several threads. */
+  typedef struct XoraPoolFactory
+  {
+    void *ud;
+    /* Create + open a session. */
+    xora_err_t (*connect)(void *ud, xora_conn_t **out);
+    /* Cheap liveness probe; XORA_OK when usable. May be NULL (never probe). */
+    xora_err_t (*ping)(void *ud, xora_conn_t *conn);
+    /* Close + free a session; sets *conn to NULL. */
+    void (*destroy)(void *ud, xora_conn_t **conn);
+  } xora_pool_factory_t;
+
+  typedef struct XoraPoolConfig
+  {
+    int min_size;          /* sessions opened at create and never evicted */
+    int max_size;          /* hard ceiling (1..XORA_POOL_MAX_SIZE) */
+    int idle_timeout_ms;   /* evict idle sessions above min_size; 0 = never */
+    int validate_after_ms; /* ping on checkout if idle longer than this; <0 = never */
+    int max_failures;      /* SUSPECT releases in a row before a slot is recycled; 0 = 3 */
+    int warmup_threads;    /* parallel warm-up fan-out; 0 = min_size */
+
+    /* Used by the default factory only */
+    const char *user;
+    const char *pass;
+    const char *db;
+
+    /* NULL = default factory (xora_conn_*) */
+    const xora_pool_factory_t *factory;
+  } xora_pool_config_t;
+
+  typedef struct XoraPoolStats
+  {
+    int size;   /* sessions currently owned by the pool (idle + busy + opening) */
+    int idle;
+    int busy;
+    long long acquires;
+    long long waits;    /* checkouts that had to block */
+    long long timeouts; /* checkouts that gave up */
+    long long created;
+    long long destroyed;
+    long long ping_failures;
+  } xora_pool_stats_t;
+
+#ifndef XORA_POOL_MAX_SIZE
+#define XORA_POOL_MAX_SIZE 256
+#endif
+
+  /* Fill cfg with defaults (min 1, max 8, no eviction, validate after 30s). */
+  void xora_pool_config_init(xora_pool_config_t *cfg);
+
+  /* Create the pool and warm up min_size sessions in parallel.
+   * Returns XORA_CONN_ERR if min_size > 0 and no session could be opened. */
+  xora_err_t xora_pool_create(xora_pool_t **out, const xora_pool_config_t *cfg);
+
+  /* Check out a session.
+   * timeout_ms: 0 = do not wait, <0 = wait forever.
+   * Returns XORA_TIMEOUT when none became available in time. */
+  xora_err_t xora_pool_acquire(xora_pool_t *pool, xora_conn_t **out, int timeout_ms);
+
+  /* Return a session checked out from this pool with the caller's view of its health. */
+  void xora_pool_release(xora_pool_t *pool, xora_conn_t *conn, xora_conn_health_t health);
+
+  /* Evict idle sessions above min_size older than idle_timeout_ms.
+   * Also run by the pool's maintenance thread when idle_timeout_ms > 0.
+   * Returns the number of sessions destroyed. */
+  int xora_pool_evict_idle(xora_pool_t *pool);
+
+  void xora_pool_get_stats(xora_pool_t *pool, xora_pool_stats_t *out);
+
+  /* Stop maintenance and destroy every session.
+   * All sessions must have been released before this call. */
+  void xora_pool_destroy(xora_pool_t **pool);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -1,11 +1,40 @@
 #ifndef XORA_PROC_CTX_H
 #define XORA_PROC_CTX_H
+
+/* Pro*C defines ORA_PROC while precompiling; keep the C11 atomics out of
+ * its parser. It only needs ctx, the generated C sees the full struct. */
+#ifndef ORA_PROC
+#include "xora_proc_stats.h"
+#include "xora_emp_cache.h"
+#endif
+
 typedef struct xora_conn {
   sql_context ctx;
   char        user[32];
   char        pass[32];
   char        db[128];
   int         broken;
+#ifndef ORA_PROC
+  struct sqlca ca;              /* status of the last statement on this handle */
+  xora_conn_stats_t stats;
+  xora_emp_dirty_t dirty;       /* ids written in the open transaction */
+  unsigned prepared;            /* XORA_PREP_* statements parsed on this session */
+#endif
 } xora_conn_t;
 
+/* xora_conn.prepared bits; cleared on open/close and after a failed EXECUTE */
+#define XORA_PREP_CREATE_LOCK 0x1u
+
+#ifndef ORA_PROC
+/* Precompiled with threads=yes and SQLCA_NONE: there is no global sqlca.
+ * Every function that runs SQL binds one first (normally the handle's own,
+ * XORA_SQLCA_USE(h)); the generated code and the helpers then name `sqlca`
+ * and get that one. Spell the type xora_sqlca_t below this point. */
+typedef struct sqlca xora_sqlca_t;
+
+#define XORA_SQLCA_BIND(p) xora_sqlca_t *const xora__sqlca = (p)
+#define XORA_SQLCA_USE(h) XORA_SQLCA_BIND(&(h)->ca)
+#define sqlca (*xora__sqlca)
+#endif
+
 #endif
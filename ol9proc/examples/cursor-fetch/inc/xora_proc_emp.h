@@ -19,11 +19,14 @@ extern "C"
   } xora_emp_row_t;
 
 
+  /* Indicator row matching xora_emp_row_t member-for-member
+   * (used by the zero-copy host struct array fetch). */
   typedef struct __XoraEmpRowInd
   {
     short empno;
     short sal;
     short ename;
+    short ename_is_null;
   } emp_row_ind_t;
 
 
@@ -5,6 +5,7 @@
 #include "xora_error.h"
 #include "xora_contex.h"
 #include "xora_proc_emp.h"
+#include "xora_idalloc.h"
 #ifdef __cplusplus
 extern "C"
 {
@@ -14,6 +15,13 @@ extern "C"
 xora_err_t xora_tx_commit(xora_conn_t *h);
 xora_err_t xora_tx_rollback(xora_conn_t *h);
 
+/* MAX(id)+1 helpers: next_id, create_autoid, batch_create_autoid,
+ * bulk_create without ids and create_employee_with_lock*.
+ * They do not mix with xora_idalloc_t (or anything else that hands out ids
+ * ahead of the insert) on the same table: once any process allocates ids
+ * from blocks, every writer of the table must (see xora_idalloc.h). Not
+ * checked here. */
+
 /* Next-id (MAX(id)+1) — no locks here */
 xora_err_t xora_emp_next_id(xora_conn_t *h, int *out_empno);
 
@@ -30,17 +38,140 @@ xora_err_t xora_emp_create_with_id(xora_conn_t *h,
                                    int explicit_empno,
                                    int *out_empno);
 
-/* Batch helper (no commit, no locks): does MAX+1 + INSERT for each row */
+/* Batch helper (no commit, no locks): one MAX+1, then array-bound INSERTs
+ * of XORA_BULK_CHUNK rows per execute. Returns XORA_ERR if any row failed. */
 xora_err_t xora_emp_batch_create_autoid(xora_conn_t *h,
                                         const xora_emp_row_t *rows,
                                         int count);
 
+/* Array DML */
+#ifndef XORA_BULK_CHUNK
+#define XORA_BULK_CHUNK 256 /* default rows per execute */
+#endif
+#ifndef XORA_BULK_MAX_CHUNK
+#define XORA_BULK_MAX_CHUNK 1024 /* host array bound (compile-time) */
+#endif
+
+/* Per-call outcome of an array DML helper.
+ * failed_idx/failed_cap and affected are caller-owned (optional);
+ * offsets index the input. */
+typedef struct XoraBulkReport
+{
+    int rows_ok;       /* rows whose statement succeeded (matched or not) */
+    int rows_failed;
+    int rows_affected; /* rows actually inserted/changed/removed */
+    int round_trips;
+    int first_id;   /* first id used when the helper assigned ids itself */
+    int *failed_idx;
+    int failed_cap;
+    int *affected;  /* count entries: rows changed by input row i (0/1), -1 = failed */
+} xora_bulk_report_t;
+
+/* Bulk INSERT (no commit, no locks)
+ * - ids: explicit ids (count entries), or NULL to use MAX(id)+1 .. +count-1
+ * - chunk_size: rows per execute, clamped to 1..XORA_BULK_MAX_CHUNK (<=0 = default)
+ * - A failing row is located via the array error offset (sqlerrd[2]),
+ *   reported, skipped, and the load resumes with the next row.
+ * - Stops early if the session is lost.
+ * Returns XORA_OK when every row was inserted, XORA_ERR otherwise. */
+xora_err_t xora_emp_bulk_create(xora_conn_t *h,
+                                const xora_emp_row_t *rows,
+                                int count,
+                                const int *ids,
+                                int chunk_size,
+                                xora_bulk_report_t *report);
+
+/* Bulk UPDATE (name, sal by id) / DELETE by id (no commit, no locks)
+ * - chunk_size rows per FOR :n execute, clamped to 1..XORA_BULK_MAX_CHUNK
+ * - per-row affected counts come from RETURNING id INTO an array
+ * - one round trip per chunk; when the array execute fails, the rows it
+ *   applied are kept, the failing row is located from the returned ids and
+ *   run alone (one more round trip), and the chunk resumes after it, so
+ *   failed rows and counts are exact
+ * - an installed row cache is invalidated for every id in the input when
+ *   the transaction ends (xora_tx_commit / xora_tx_rollback)
+ * Returns XORA_OK when no row failed (ids that matched nothing are not failures). */
+xora_err_t xora_emp_update_many(xora_conn_t *h,
+                                const xora_emp_row_t *rows,
+                                int count,
+                                int chunk_size,
+                                xora_bulk_report_t *report);
+
+xora_err_t xora_emp_delete_many(xora_conn_t *h,
+                                const int *ids,
+                                int count,
+                                int chunk_size,
+                                xora_bulk_report_t *report);
+
+/* Bulk upsert: FOR :n MERGE INTO employees, one execute per chunk (no commit)
+ * - a row whose id exists is updated (name, sal), otherwise inserted
+ * - a failing row is reported and skipped as in xora_emp_bulk_create
+ * - out_inserted/out_updated (optional): asking for the split costs one
+ *   id-only probe query per chunk; exact unless another session inserts
+ *   the same ids concurrently
+ * Returns XORA_OK when every row was merged. */
+xora_err_t xora_emp_upsert_many(xora_conn_t *h,
+                                const xora_emp_row_t *rows,
+                                int count,
+                                int chunk_size,
+                                int *out_inserted,
+                                int *out_updated,
+                                xora_bulk_report_t *report);
+
 xora_err_t xora_create_employee_with_lock(xora_conn_t *conn,xora_emp_row_t *row, int *empid);
 
-/* Read / Update / Delete */
+/* Where the create-with-lock sequence runs */
+typedef enum XORA_CREATE_MODE
+{
+    XORA_CREATE_CLIENT = 0, /* SET TRANSACTION, LOCK, MAX+1, INSERT, COMMIT: ~5 round trips */
+    XORA_CREATE_SERVER = 1  /* one PL/SQL block, PREPAREd once per session: 1 round trip */
+} xora_create_mode_t;
+
+/* Same contract as xora_create_employee_with_lock.
+ * XORA_CREATE_SERVER falls back to the client path only when the block never
+ * started (PREPARE failed, PL/SQL did not compile); an error raised inside the
+ * block is rolled back there and returned as XORA_TX_ROLLBACK without a retry.
+ * A failed EXECUTE (lost session, timeout, cancel) is returned as is
+ * (XORA_CONN_ERR / XORA_ERR): the block may have committed.
+ * The block commits or rolls back the session's whole transaction, so it
+ * invalidates the cached ids written before it, as xora_tx_commit does. */
+xora_err_t xora_create_employee_with_lock_ex(xora_conn_t *conn,
+                                             xora_emp_row_t *row,
+                                             int *empid,
+                                             xora_create_mode_t mode);
+
+/* Create + COMMIT with an id from the block allocator:
+ * no LOCK TABLE, no MAX scan; concurrent writers do not serialize. */
+xora_err_t xora_create_employee(xora_conn_t *conn,
+                                xora_idalloc_t *ids,
+                                xora_emp_row_t *row,
+                                int *empid);
+
+/* Read / Update / Delete
+ * With a cache installed (xora_emp_cache_install) get_by_id reads through it.
+ * Every write records its ids on the session; they are invalidated when the
+ * transaction ends, and until then this session does not use the cache for
+ * them. End transactions with xora_tx_commit / xora_tx_rollback (not raw
+ * COMMIT) so the cache hears about it. */
 xora_err_t xora_emp_get_by_id(xora_conn_t *h, int empno,
                               xora_emp_row_t *out, int *found);
 
+/* Multi-row lookup: one OPEN + array FETCH per chunk of ids instead of one
+ * SELECT per id. The id list travels as one comma-separated bind of up to
+ * XORA_GET_MANY_CSV bytes (a few hundred ids) and is split server side.
+ * - out_rows[i] / found_mask[i] line up with ids[i]; duplicates are all filled
+ * - found_mask: n bytes, 1 = found, 0 = no such id (may be NULL)
+ * - cached ids (installed cache) are not sent at all
+ * Missing ids are not an error. */
+#ifndef XORA_GET_MANY_CSV
+#define XORA_GET_MANY_CSV 4000 /* VARCHAR2 bind limit in SQL */
+#endif
+xora_err_t xora_emp_get_many(xora_conn_t *h,
+                             const int *ids,
+                             int n,
+                             xora_emp_row_t *out_rows,
+                             unsigned char *found_mask);
+
 xora_err_t xora_emp_update(xora_conn_t *h, const xora_emp_row_t *in);
 
 xora_err_t xora_emp_delete(xora_conn_t *h, int empno);
@@ -3,17 +3,16 @@
 /* xora_emp.h — public API */
 
 #include "xora_error.h"
+#include "xora_alloc.h"
 #include "xora_contex.h"
+#include "xora_decimal.h"
+#include "xora_proc_emp.h"
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-  xora_err_t xora_emp_fetch_vect(xora_conn_t *h,
-                                 xora_emp_row_t **rows,
-                                 int reserve_hint);
-
   /* Array-fetch up to `cap` rows; fills rows and sets *out_count (0..cap). */
   xora_err_t xora_emp_fetch_arrst(xora_conn_t *ctx,
                                   xora_emp_row_t *rows,
@@ -21,6 +20,164 @@ extern "C"
                                   int *out_count,
                                   int batch_size);
 
+  /* Zero-copy array fetch: rows land directly in `rows` (host struct array
+   * bound over the caller's buffer), no per-row copy loop.
+   * Same contract as xora_emp_fetch_arrst, including XORA_ERR on a NULL sal. */
+  xora_err_t xora_emp_fetch_direct(xora_conn_t *h,
+                                   xora_emp_row_t *rows,
+                                   int cap,
+                                   int *out_count,
+                                   int batch_size);
+
+  /* Zero-copy variant of xora_emp_fetch_vect: each batch is fetched straight
+   * into the spare capacity at the tail of the stb_ds vector. */
+  xora_err_t xora_emp_fetch_vect_direct(xora_conn_t *h,
+                                        xora_emp_row_t **rows,
+                                        int reserve_hint,
+                                        int batch_size);
+
+#ifndef XORA_MAX_BATCH
+#define XORA_MAX_BATCH 1024 /* default rows per round trip */
+#endif
+#ifndef XORA_FETCH_MEM_BUDGET
+#define XORA_FETCH_MEM_BUDGET (8u << 20) /* default host-array bytes per cursor */
+#endif
+
+  /* Batch sizing for cursor fetches.
+   * Host arrays are heap-allocated and bound with FOR :n, so the batch size is
+   * a runtime value; the only ceiling is mem_budget / host row width. */
+  typedef struct XoraFetchOpts
+  {
+    int batch_size;        /* rows per round trip (start size when adaptive); <=0 = XORA_MAX_BATCH */
+    int adaptive;          /* retune after every full batch from row width and round-trip time */
+    int min_batch;         /* adaptive floor; <=0 = 64 */
+    size_t mem_budget;     /* host-array bytes; 0 = XORA_FETCH_MEM_BUDGET */
+    int latency_share_pct; /* adaptive target share of fixed round-trip cost per fetch; 0 = 10 */
+  } xora_fetch_opts_t;
+
+  void xora_fetch_opts_init(xora_fetch_opts_t *opts);
+
+  /* Fetch all rows, appending to an stb_ds vector (*rows may be NULL).
+   * The vector comes from the library's stb_ds hooks: its blocks carry a
+   * header in front of stb_ds's own (xora_arena.c). arrlen() and indexing
+   * work anywhere, but free it with xora_emp_rows_free() (or grow/free it in
+   * code that includes xora_stbds.h); stb_ds.h's own arrfree/arrput would
+   * hand an interior pointer to free()/realloc(). */
+  xora_err_t xora_emp_fetch_vect(xora_conn_t *h,
+                                 xora_emp_row_t **rows,
+                                 int reserve_hint);
+
+  xora_err_t xora_emp_fetch_vect_ex(xora_conn_t *h,
+                                    xora_emp_row_t **rows,
+                                    int reserve_hint,
+                                    const xora_fetch_opts_t *opts);
+
+  /* Free a fetch_vect result (heap or arena-born) and set *rows to NULL. */
+  void xora_emp_rows_free(xora_emp_row_t **rows);
+
+  /* Fetch all rows into one contiguous array carved from `arena`.
+   * The array grows in place while it is the arena's last block; *out_rows
+   * lives until the arena is reset, rewound past it or released, so there is
+   * nothing to free per result. On error the arena is rewound and *out_rows
+   * is NULL. */
+  xora_err_t xora_emp_fetch_arena(xora_conn_t *h,
+                                  xora_arena_t *arena,
+                                  xora_emp_row_t **out_rows,
+                                  int *out_count,
+                                  int reserve_hint,
+                                  const xora_fetch_opts_t *opts);
+
+  /* One batch of host arrays, column-major exactly as Pro*C fills them.
+   * ename entries are NUL-terminated; ename_ind < 0 means NULL.
+   * sal is fetched as VARNUM into salary_num and decoded in bulk: salary_cents
+   * is exact, salary is salary_cents / 100 for double consumers. */
+  typedef struct XoraEmpBatch
+  {
+    int count; /* rows valid */
+    int cap;   /* rows allocated */
+    int *empno;
+    double *salary;
+    int64_t *salary_cents;
+    xora_varnum_t *salary_num;
+    char (*ename)[51];
+    short *ename_ind;
+  } xora_emp_batch_t;
+
+  /* Read-only view over a batch owned by somebody else (cursor, pipeline). */
+  typedef struct XoraEmpBatchView
+  {
+    int count;
+    const int *empno;
+    const double *salary;
+    const int64_t *salary_cents;
+    const char (*ename)[51];
+    const short *ename_ind;
+  } xora_emp_batch_view_t;
+
+  /* Heap host arrays for `cap` rows. */
+  xora_err_t xora_emp_batch_alloc(xora_emp_batch_t *b, int cap);
+  void xora_emp_batch_free(xora_emp_batch_t *b);
+
+  /* Streaming cursor over employees ORDER BY id.
+   * Memory is one batch regardless of result size.
+   * One open stream per connection at a time (the cursor is bound to the
+   * handle's SQL context). */
+  typedef struct xora_emp_cursor xora_emp_cursor_t;
+
+  xora_err_t xora_emp_cursor_open(xora_conn_t *h,
+                                  xora_emp_cursor_t **out,
+                                  int batch_size);
+
+  /* Same, with explicit sizing (opts may be NULL for defaults). */
+  xora_err_t xora_emp_cursor_open_ex(xora_conn_t *h,
+                                     xora_emp_cursor_t **out,
+                                     const xora_fetch_opts_t *opts);
+
+  /* Rows the next fetch will ask for (changes over time when adaptive). */
+  int xora_emp_cursor_batch_size(const xora_emp_cursor_t *c);
+
+  /* Fetch the next batch into the cursor's own buffer.
+   * *view stays valid until the next call or close.
+   * Returns XORA_NO_DATA_FOUND (view->count == 0) once exhausted. */
+  xora_err_t xora_emp_cursor_next_batch(xora_emp_cursor_t *c,
+                                        xora_emp_batch_view_t *view);
+
+  /* Fetch up to b->cap rows (adaptive: up to the tuned size) into a
+   * caller-owned batch (b->count set).
+   * Returns XORA_NO_DATA_FOUND with b->count == 0 once exhausted,
+   * XORA_CONN_ERR when the session is gone. */
+  xora_err_t xora_emp_cursor_fetch_into(xora_emp_cursor_t *c,
+                                        xora_emp_batch_t *b);
+
+  void xora_emp_cursor_close(xora_emp_cursor_t **c);
+
+  /* Slice of the employees scan; each slice is still ORDER BY id. */
+  typedef enum XORA_EMP_PART_KIND
+  {
+    XORA_PART_ALL = 0,   /* whole table */
+    XORA_PART_RANGE = 1, /* lo <= id <= hi */
+    XORA_PART_HASH = 2   /* ORA_HASH(id, nbuckets - 1) = bucket */
+  } xora_emp_part_kind_t;
+
+  typedef struct XoraEmpPart
+  {
+    xora_emp_part_kind_t kind;
+    int lo, hi;       /* RANGE, inclusive */
+    int bucket;       /* HASH, 0..nbuckets-1 */
+    int nbuckets;
+  } xora_emp_part_t;
+
+  /* Open a stream over one partition (part == NULL: whole table).
+   * Cursors of different partitions must be on different connections.
+   * XORA_CONN_ERR when the session is gone. */
+  xora_err_t xora_emp_cursor_open_part(xora_conn_t *h,
+                                       xora_emp_cursor_t **out,
+                                       const xora_fetch_opts_t *opts,
+                                       const xora_emp_part_t *part);
+
+  /* MIN(id)/MAX(id) for range splitting; XORA_NO_DATA_FOUND on an empty table. */
+  xora_err_t xora_emp_id_bounds(xora_conn_t *h, int *out_min, int *out_max);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,6 +5,9 @@
 #include <string.h>
 #include <stddef.h>
 
+#include "xora_proc_contex.h"
+#include "xora_log.h"
+
 
 
 #ifdef __cplusplus
@@ -21,41 +24,66 @@ extern "C"
       break;                                           \
   } while (0)
 
-  /* Error only (sqlcode < 0) */
-#define XORA_ORA_OK(step)                                                               \
-  ((sqlca.sqlcode < 0) ? (fprintf(stderr, "[ORA-ERR] step=%s code=%ld msg=%.*s\n",      \
-                                  (step), (long)sqlca.sqlcode,                          \
-                                  (int)sqlca.sqlerrm.sqlerrml, sqlca.sqlerrm.sqlerrmc), \
-                          0)                                                            \
+  /* Error only (sqlcode < 0). Failures are logged through xora_log, which
+   * never blocks the caller once xora_log_start has run. */
+#define XORA_ORA_OK(step)                                                         \
+  ((sqlca.sqlcode < 0) ? (xora_log_ora(XORA_LOG_ERR, (step), (long)sqlca.sqlcode, \
+                                       sqlca.sqlerrm.sqlerrmc,                    \
+                                       (int)sqlca.sqlerrm.sqlerrml),              \
+                          0)                                                      \
                        : 1)
 
 /* Error and Warning (sqlcode != 0) */
-#define XORA_ORA_OK_STRICT(step)                                                         \
-  ((sqlca.sqlcode != 0) ? (fprintf(stderr, "[ORA-%s] step=%s code=%ld msg=%.*s\n",       \
-                                   (sqlca.sqlcode < 0 ? "ERR" : "WARN"),                 \
-                                   (step), (long)sqlca.sqlcode,                          \
-                                   (int)sqlca.sqlerrm.sqlerrml, sqlca.sqlerrm.sqlerrmc), \
-                           0)                                                            \
+#define XORA_ORA_OK_STRICT(step)                                                            \
+  ((sqlca.sqlcode != 0) ? (xora_log_ora((sqlca.sqlcode < 0 ? XORA_LOG_ERR : XORA_LOG_WARN), \
+                                        (step), (long)sqlca.sqlcode,                        \
+                                        sqlca.sqlerrm.sqlerrmc,                             \
+                                        (int)sqlca.sqlerrm.sqlerrml),                       \
+                           0)                                                               \
                         : 1)
 
-  static inline int xora_ora_ok(const char *step)
+  /* The functions take the sqlca explicitly; the lowercase macros pass the
+   * one bound in the calling function (see xora_proc_contex.h). */
+  static inline int xora__ora_ok(const xora_sqlca_t *ca, const char *step)
   {
-    if (sqlca.sqlcode < 0)
+    if (ca->sqlcode < 0)
     {
-      fprintf(stderr, "[ORA] step=%s code=%ld msg=%.*s\n",
-              step, (long)sqlca.sqlcode,
-              (int)sqlca.sqlerrm.sqlerrml, sqlca.sqlerrm.sqlerrmc);
+      xora_log_ora(XORA_LOG_ERR, step, (long)ca->sqlcode,
+                   ca->sqlerrm.sqlerrmc, (int)ca->sqlerrm.sqlerrml);
       return 0;
     }
     return 1;
   }
 
-  static inline int xora_ora_truncated(void)
+  static inline int xora__ora_truncated(const xora_sqlca_t *ca)
+  {
+    return (ca->sqlwarn[0] == 'W' && ca->sqlwarn[1] == 'W');
+  }
+
+  static inline long xora__ora_rows(const xora_sqlca_t *ca) { return ca->sqlerrd[2]; }
+
+  /* Session-level failures: retrying the next row on this handle is pointless */
+  static inline int xora__ora_conn_lost(const xora_sqlca_t *ca)
   {
-    return (sqlca.sqlwarn[0] == 'W' && sqlca.sqlwarn[1] == 'W');
+    switch (ca->sqlcode)
+    {
+    case -28:    /* session killed */
+    case -1012:  /* not logged on */
+    case -1092:  /* instance terminated */
+    case -3113:  /* end-of-file on communication channel */
+    case -3114:  /* not connected */
+    case -3135:  /* connection lost contact */
+    case -12541: /* no listener */
+      return 1;
+    default:
+      return 0;
+    }
   }
 
-  static inline long xora_ora_rows(void) { return sqlca.sqlerrd[2]; }
+#define xora_ora_ok(step) xora__ora_ok(&sqlca, (step))
+#define xora_ora_truncated() xora__ora_truncated(&sqlca)
+#define xora_ora_rows() xora__ora_rows(&sqlca)
+#define xora_ora_conn_lost() xora__ora_conn_lost(&sqlca)
 
     static inline void xora_varchar_set(VARCHAR *v, size_t cap, const char *s)
   {
@@ -0,0 +1,62 @@
+#ifndef XORA_PROC_STATS_H
+#define XORA_PROC_STATS_H
+/* xora_proc_stats.h — recording side of xora_stats (library internal, C only)
+ *
+ * Usage in an instrumented call:
+ *   XORA_STAT_BEGIN();                              at the top
+ *   XORA_STAT_END(op, &h->stats, rows, rts, ok);    on each exit path
+ * or, right after a single embedded statement (in a .pc file):
+ *   XORA_STAT_SQL(op, &h->stats);                   rows/ok from sqlca
+ *
+ * Coverage: every query, DML, PL/SQL block (a PREPARE issued by the same
+ * call adds a round trip to it), COMMIT / ROLLBACK, connect, close and ping.
+ * Not recorded: SET TRANSACTION, LOCK TABLE, xora_tx_savepoint /
+ * xora_tx_rollback_to, cursor CLOSE and the best-effort release in destroy;
+ * none of them has an op of its own.
+ */
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "xora_stats.h"
+
+/* Per-connection counters, embedded in struct xora_conn (relaxed atomics). */
+typedef struct XoraConnStats
+{
+  _Atomic long long calls;
+  _Atomic long long round_trips;
+  _Atomic long long rows;
+  _Atomic long long errors;
+  _Atomic long long busy_ns;
+} xora_conn_stats_t;
+
+extern atomic_int xora__stats_on;
+
+static inline int xora_stats_enabled(void)
+{
+  return atomic_load_explicit(&xora__stats_on, memory_order_relaxed);
+}
+
+/* Record one call. cs may be NULL (no connection). */
+void xora_stats_record(xora_stat_op_t op, xora_conn_stats_t *cs,
+                       uint64_t ns, long rows, int round_trips, int ok);
+
+#ifndef XORA_NO_STATS
+#define XORA_STAT_BEGIN() \
+  uint64_t xora__st0 = xora_stats_enabled() ? xora_stats_now_ns() : 0
+#define XORA_STAT_END(op, cs, rows, rts, ok)                                        \
+  do                                                                               \
+  {                                                                                \
+    if (xora__st0)                                                                 \
+      xora_stats_record((op), (cs), xora_stats_now_ns() - xora__st0, (long)(rows), \
+                        (rts), (ok));                                              \
+  } while (0)
+/* sqlerrd[2] is per statement for DML/SELECT INTO, cumulative for FETCH */
+#define XORA_STAT_SQL(op, cs) \
+  XORA_STAT_END((op), (cs), (sqlca.sqlcode < 0 ? 0 : sqlca.sqlerrd[2]), 1, (sqlca.sqlcode >= 0))
+#else
+#define XORA_STAT_BEGIN() ((void)0)
+#define XORA_STAT_END(op, cs, rows, rts, ok) ((void)0)
+#define XORA_STAT_SQL(op, cs) ((void)0)
+#endif
+
+#endif
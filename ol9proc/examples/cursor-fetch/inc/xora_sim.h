@@ -0,0 +1,57 @@
+#ifndef XORA_SIM_H
+#define XORA_SIM_H
+/* xora_sim.h — in-process simulated backend (public API; no Pro*C tokens/types here)
+ *
+ * Summary:
+ *   - xora_sim.c implements the connection, transaction, fetch and basic CRUD
+ *     entry points of xora_db over an in-memory employees table, so the plain C
+ *     layers (pool, pipe, pscan, cache, write-behind queue, stats) and the
+ *     benchmarks link and run without Oracle (library xora_db_sim).
+ *   - Every statement is charged rtt_us + rows * row_ns; connect costs
+ *     connect_us. Costs are slept by default (a round trip is a wait, not CPU
+ *     work), or spun when spin != 0 for sub-10us accuracy.
+ *   - Statements autocommit; ROLLBACK costs a round trip but undoes nothing.
+ *   - Hash partitions use a multiplicative hash, not ORA_HASH.
+ *   - Not covered: fetch_vect*, get_many, update/delete/upsert (single and
+ *     array), create-with-lock.
+ */
+
+#include "xora_error.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct XoraSimConfig
+  {
+    int rtt_us;     /* fixed cost per round trip */
+    int row_ns;     /* transfer cost per row sent or received */
+    int connect_us; /* session setup */
+    int rows;       /* employees seeded (ids 1..rows) */
+    int spin;       /* busy-wait instead of sleeping */
+  } xora_sim_config_t;
+
+  /* Defaults (200us, 50ns/row, 2ms connect, 100000 rows), then the
+   * XORA_SIM_RTT_US / _ROW_NS / _CONNECT_US / _ROWS / _SPIN environment
+   * variables. */
+  void xora_sim_config_init(xora_sim_config_t *cfg);
+
+  /* Apply cfg and reseed the table. No session may be in use. */
+  void xora_sim_configure(const xora_sim_config_t *cfg);
+
+  /* Change costs only (table untouched); safe between workloads. */
+  void xora_sim_set_latency(int rtt_us, int row_ns);
+
+  void xora_sim_get_config(xora_sim_config_t *out);
+
+  /* Round trips charged by all sessions so far. */
+  long long xora_sim_round_trips(void);
+
+  /* Rows currently in the simulated table. */
+  int xora_sim_row_count(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,41 @@
+#ifndef XORA_SIMD_H
+#define XORA_SIMD_H
+/* xora_simd.h — runtime SIMD dispatch level shared by the vector kernels
+ *
+ * Summary:
+ *   - Kernels are compiled for several instruction sets in one binary
+ *     (target attributes, no global -mavx2) and pick one per call from
+ *     xora_simd_level().
+ *   - Detected once with __builtin_cpu_supports; the XORA_SIMD environment
+ *     variable (scalar | sse2 | avx2) caps it, e.g. to compare paths.
+ *   - Non-x86 targets and other compilers always run the scalar code.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef enum XORA_SIMD_LEVEL
+  {
+    XORA_SIMD_SCALAR = 0,
+    XORA_SIMD_SSE2 = 1,
+    XORA_SIMD_AVX2 = 2
+  } xora_simd_level_t;
+
+  /* Level the kernels run at now. */
+  xora_simd_level_t xora_simd_level(void);
+
+  /* Best level this CPU supports (ignores XORA_SIMD and set_level). */
+  xora_simd_level_t xora_simd_detect(void);
+
+  /* Cap dispatch at lvl (never above xora_simd_detect()); returns the level
+   * now in effect. Process-wide; meant for benchmarks and cross-checks. */
+  xora_simd_level_t xora_simd_set_level(xora_simd_level_t lvl);
+
+  const char *xora_simd_level_name(xora_simd_level_t lvl);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,104 @@
+#ifndef XORA_STATS_H
+#define XORA_STATS_H
+/* xora_stats.h — hot-path instrumentation: per-op counters + latency histograms
+ *
+ * Summary:
+ *   - Every instrumented API call records (op, latency, rows, round trips, ok).
+ *   - Global stats live in per-thread shards: the recording thread is the only
+ *     writer of its shard (relaxed load + store, no lock, no RMW); snapshots
+ *     sum all shards.
+ *   - Latency histograms are log-linear (HDR-style): XORA_STATS_SUB_BITS
+ *     sub-buckets per power of two of nanoseconds, ~6% relative error.
+ *   - Per-connection counters sit in the connection handle.
+ *   - Off by default; when off a call costs one relaxed load. Build with
+ *     -DXORA_NO_STATS to compile the hooks out entirely.
+ *   - Recording hooks live in xora_proc_stats.h (library internal).
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "xora_error.h"
+#include "xora_contex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef enum XORA_STAT_OP
+  {
+    XORA_OP_CONN_OPEN = 0,
+    XORA_OP_CONN_CLOSE,
+    XORA_OP_PING,
+    XORA_OP_CURSOR_OPEN,
+    XORA_OP_FETCH,
+    XORA_OP_SELECT,
+    XORA_OP_INSERT,
+    XORA_OP_UPDATE,
+    XORA_OP_DELETE,
+    XORA_OP_MERGE,
+    XORA_OP_PLSQL,
+    XORA_OP_COMMIT,
+    XORA_OP_ROLLBACK,
+    XORA_OP__COUNT
+  } xora_stat_op_t;
+
+#ifndef XORA_STATS_SUB_BITS
+#define XORA_STATS_SUB_BITS 3 /* 8 sub-buckets per octave */
+#endif
+#define XORA_STATS_OCTAVES 40 /* 1 ns .. ~18 min */
+#define XORA_STATS_BUCKETS (XORA_STATS_OCTAVES << XORA_STATS_SUB_BITS)
+
+  typedef struct XoraConnStatsSnapshot
+  {
+    long long calls;
+    long long round_trips;
+    long long rows;
+    long long errors;
+    long long busy_ns;
+  } xora_conn_stats_snapshot_t;
+
+  typedef struct XoraStatOpSnapshot
+  {
+    long long calls;
+    long long errors;
+    long long rows;
+    long long round_trips;
+    long long total_ns;
+    long long max_ns;
+    long long p50_ns;
+    long long p90_ns;
+    long long p99_ns;
+    long long p999_ns;
+  } xora_stat_op_snapshot_t;
+
+  typedef struct XoraStatsSnapshot
+  {
+    int enabled;
+    int shards; /* threads that ever recorded */
+    xora_stat_op_snapshot_t ops[XORA_OP__COUNT];
+  } xora_stats_snapshot_t;
+
+  void xora_stats_enable(int on);
+  int xora_stats_is_enabled(void);
+
+  uint64_t xora_stats_now_ns(void);
+
+  /* Sum every shard. Percentiles are bucket upper bounds. */
+  void xora_stats_snapshot(xora_stats_snapshot_t *out);
+
+  /* Zero global shards (not connection counters). Not atomic w.r.t. recorders. */
+  void xora_stats_reset(void);
+
+  const char *xora_stats_op_name(xora_stat_op_t op);
+
+  /* key=value lines, one per op with calls > 0 */
+  void xora_stats_dump(FILE *f);
+
+  /* Per-connection counters of a handle */
+  void xora_conn_get_stats(xora_conn_t *h, xora_conn_stats_snapshot_t *out);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
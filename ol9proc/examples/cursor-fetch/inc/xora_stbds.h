@@ -0,0 +1,18 @@
+#ifndef XORA_STBDS_H
+#define XORA_STBDS_H
+/* xora_stbds.h — stb_ds wired to the library allocator (include this, not stb_ds.h)
+ *
+ * Every translation unit must see the same STBDS_REALLOC/STBDS_FREE, or a
+ * container grown in one file is freed with the wrong allocator in another.
+ * The implementation (STB_DS_IMPLEMENTATION) lives in xora_arena.c.
+ * The hooks put a header in front of every block, so code that includes
+ * stb_ds.h directly must not grow or free containers made here.
+ */
+
+#include "xora_alloc.h"
+
+#define STBDS_REALLOC(c, p, s) xora_stbds_realloc((p), (s))
+#define STBDS_FREE(c, p) xora_stbds_free((p))
+#include "stb_ds.h"
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef XORA_UTF8_H
+#define XORA_UTF8_H
+/* xora_utf8.h — UTF-8 bounded copy and validation with SIMD fast paths
+ *
+ * Summary:
+ *   - xora_utf8_copy_bounded is a drop-in for xora_ut8_copy_bounded
+ *     (xora_alloc.h): same cut rule, same resulting string, for every input.
+ *     ASCII and well-formed UTF-8 take the fast path (strnlen, SIMD ASCII
+ *     scan, boundary fix-up at the cut); anything malformed falls back to the
+ *     byte walk of the reference.
+ *   - Unlike the reference it never reads past the terminating NUL when a
+ *     multi-byte lead claims bytes the string does not have.
+ *   - xora_utf8_valid checks well-formedness (RFC 3629: no overlongs, no
+ *     surrogates, nothing above U+10FFFF, no truncated sequences), skipping
+ *     ASCII runs 16/32 bytes at a time.
+ *   - SSE2/AVX2 chosen per call from xora_simd_level().
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /* Copy src into dst (dst_size bytes incl. NUL) without splitting a UTF-8
+   * sequence; always NUL-terminates when dst_size > 0. Returns strlen(dst). */
+  size_t xora_utf8_copy_bounded(char *dst, const char *src, size_t dst_size);
+
+  /* 1 if s[0..len) is well-formed UTF-8, else 0. */
+  int xora_utf8_valid(const char *s, size_t len);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -0,0 +1,108 @@
+#ifndef XORA_UV_H
+#define XORA_UV_H
+/* xora_uv.h — asynchronous calls completed on a libuv loop (XORA_WITH_UV)
+ *
+ * Summary:
+ *   - Requests are queued from any thread and run on a fixed set of worker
+ *     threads; each worker checks a session out of an xora_pool_t for the
+ *     call and returns it afterwards.
+ *   - Completion callbacks always run on the loop thread, woken through one
+ *     uv_async_t. The loop never blocks on the database, so one loop can
+ *     keep max_pending requests in flight with only `workers` threads.
+ *   - The number of requests in flight is bounded: past max_pending a
+ *     submit fails at once with XORA_TIMEOUT instead of queueing.
+ *
+ * Sessions: conn == NULL runs the call on a pooled session, and the call is
+ * its own transaction (xora_async_insert commits, or rolls back on failure;
+ * an xora_async_call body must end whatever it started).
+ * A session the caller checked out itself may be passed instead; calls on it
+ * leave the transaction open until xora_async_commit. Keep at most one
+ * request in flight per such session.
+ */
+
+#include <uv.h>
+
+#include "xora_error.h"
+#include "xora_contex.h"
+#include "xora_pool.h"
+#include "xora_idalloc.h"
+#include "xora_proc_emp.h"
+#include "xora_proc_emp_fetch.h"
+#include "xora_emp_cols.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct xora_uv xora_uv_t;
+
+  /* Runs on the loop thread, exactly once per accepted request. */
+  typedef void (*xora_async_cb_t)(void *ud, xora_err_t rc);
+
+  /* The body of xora_async_call; runs on a worker thread. */
+  typedef xora_err_t (*xora_async_fn_t)(xora_conn_t *conn, void *arg);
+
+  typedef struct XoraUvConfig
+  {
+    xora_pool_t *pool;      /* sessions for conn == NULL requests (required) */
+    int workers;            /* threads running calls; <=0 = 4. No use above the pool's max_size */
+    int max_pending;        /* accepted, not yet completed; <=0 = 1024 */
+    int acquire_timeout_ms; /* pool checkout per request, <0 = wait forever; completes with XORA_TIMEOUT */
+
+    /* Id source for xora_async_insert. NULL = MAX(id)+1, only safe while
+     * nothing else inserts employees. */
+    xora_idalloc_t *ids;
+  } xora_uv_config_t;
+
+  typedef struct XoraUvStats
+  {
+    long long submitted;
+    long long completed;
+    long long rejected; /* submits refused because max_pending were in flight */
+    int pending;        /* accepted, callback not yet run */
+    int max_pending_seen;
+  } xora_uv_stats_t;
+
+  void xora_uv_config_init(xora_uv_config_t *cfg);
+
+  /* Starts the workers and registers a uv_async_t on loop. Call from the
+   * loop thread. The handle keeps uv_run(UV_RUN_DEFAULT) from returning until
+   * xora_uv_destroy; drive the loop with UV_RUN_ONCE to wait for results. */
+  xora_err_t xora_uv_create(xora_uv_t **out, uv_loop_t *loop, const xora_uv_config_t *cfg);
+
+  /* Run fn(conn, arg) on a worker, then cb(ud, fn's result) on the loop. */
+  xora_err_t xora_async_call(xora_uv_t *a, xora_conn_t *conn,
+                             xora_async_fn_t fn, void *arg,
+                             xora_async_cb_t cb, void *ud);
+
+  /* Fetch all rows (as xora_emp_fetch_cols) and append them to out, which
+   * must stay valid and untouched until cb. opts may be NULL. */
+  xora_err_t xora_async_fetch(xora_uv_t *a, xora_conn_t *conn,
+                              xora_emp_cols_t *out, const xora_fetch_opts_t *opts,
+                              xora_async_cb_t cb, void *ud);
+
+  /* Insert a copy of rows[0..count), ids from the configured source.
+   * out_ids (optional, count entries) receives the ids and must stay valid
+   * until cb. On a pooled session the rows are committed together, or
+   * rolled back together when any of them fails. */
+  xora_err_t xora_async_insert(xora_uv_t *a, xora_conn_t *conn,
+                               const xora_emp_row_t *rows, int count, int *out_ids,
+                               xora_async_cb_t cb, void *ud);
+
+  /* COMMIT on a caller-held session (conn is required). */
+  xora_err_t xora_async_commit(xora_uv_t *a, xora_conn_t *conn,
+                               xora_async_cb_t cb, void *ud);
+
+  void xora_uv_get_stats(xora_uv_t *a, xora_uv_stats_t *out);
+
+  /* Stop accepting requests, let the workers finish the queued ones and run
+   * every outstanding callback before returning. Call from the loop thread;
+   * the uv_async_t is closed and freed by the loop, so let it run once more
+   * before uv_loop_close. */
+  void xora_uv_destroy(xora_uv_t **a);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif
@@ -1,8 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 
-#include "stb_ds.h"
+#include "xora_stbds.h"
 #include "xora_error.h"
 #include "xora_alloc.h"
 #include "xora_alloc.h"
@@ -10,6 +11,10 @@
 #include "xora_proc_emp.h"
 #include "xora_proc_emp_fetch.h"
 #include "xora_proc_emp_crud.h"
+#include "xora_pool.h"
+#include "xora_emp_pscan.h"
+#include "xora_stats.h"
+#include "xora_log.h"
 
 
 static const char *get_env_or(const char *key, const char *defv)
@@ -64,7 +69,7 @@ static int fetch_emp_vect(xora_conn_t *conn)
     if (rc != XORA_OK)
     {
         fprintf(stderr, "xora_emp_vfetch failed (rc=%d)\n", rc);
-        arrfree(rows);
+        xora_emp_rows_free(&rows);
         return 1;
     }
 
@@ -82,10 +87,89 @@ static int fetch_emp_vect(xora_conn_t *conn)
     }
     printf("\n%d records(s)\n", n);
 
-    arrfree(rows); // ALWAYS free when done
+    xora_emp_rows_free(&rows); // ALWAYS free when done
     return XORA_OK;
 }
 
+static int fetch_emp_stream(xora_conn_t *conn, int batch)
+{
+    xora_emp_cursor_t *cur = NULL;
+    if (xora_emp_cursor_open(conn, &cur, batch) != XORA_OK)
+    {
+        fprintf(stderr, "xora_emp_cursor_open failed\n");
+        return 1;
+    }
+
+    printf("%-6s  %-50s  %10s\n", "EMPNO", "ENAME", "SAL");
+    printf("------  --------------------------------------------------  ----------\n");
+
+    /* Only one batch is resident; rows are used straight from the host arrays */
+    int n = 0;
+    xora_emp_batch_view_t v;
+    xora_err_t rc;
+    while ((rc = xora_emp_cursor_next_batch(cur, &v)) == XORA_OK)
+    {
+        for (int i = 0; i < v.count; ++i)
+        {
+            printf("%-6d  %-50s  %10.2f\n", v.empno[i],
+                   v.ename_ind[i] < 0 ? "" : v.ename[i], v.salary[i]);
+        }
+        n += v.count;
+    }
+    xora_emp_cursor_close(&cur);
+
+    if (rc != XORA_NO_DATA_FOUND)
+    {
+        fprintf(stderr, "xora_emp_cursor_next_batch failed (rc=%d)\n", rc);
+        return 1;
+    }
+    printf("\n%d records(s)\n", n);
+    return 0;
+}
+
+static int pscan_count_cb(void *ud, int part, const xora_emp_batch_view_t *v)
+{
+    (void)part;
+    atomic_fetch_add_explicit((atomic_llong *)ud, (long long)v->count, memory_order_relaxed);
+    return 0;
+}
+
+static int scan_emp_parallel(const char *user, const char *pass, const char *db, int nparts)
+{
+    xora_pool_config_t pc;
+    xora_pool_config_init(&pc);
+    pc.min_size = nparts;
+    pc.max_size = nparts;
+    pc.user = user;
+    pc.pass = pass;
+    pc.db = db;
+
+    xora_pool_t *pool = NULL;
+    if (xora_pool_create(&pool, &pc) != XORA_OK)
+    {
+        fprintf(stderr, "xora_pool_create failed\n");
+        return 1;
+    }
+
+    xora_pscan_opts_t po;
+    xora_pscan_opts_init(&po);
+    po.nparts = nparts;
+
+    atomic_llong rows = 0;
+    xora_pscan_stats_t st;
+    xora_err_t rc = xora_emp_pscan(pool, &po, pscan_count_cb, &rows, &st);
+    xora_pool_destroy(&pool);
+
+    if (rc != XORA_OK)
+    {
+        fprintf(stderr, "xora_emp_pscan failed (rc=%d)\n", rc);
+        return 1;
+    }
+    printf("%lld records(s) over %d partitions (min %lld / max %lld per partition)\n",
+           (long long)atomic_load(&rows), st.parts, st.min_part_rows, st.max_part_rows);
+    return 0;
+}
+
 static int create_new_emp(xora_conn_t *conn,xora_emp_row_t *row){
     if(!row){
         printf("[Create] Err create new employee failed. \n"   );
@@ -93,7 +177,7 @@ static int create_new_emp(xora_conn_t *conn,xora_emp_row_t *row){
     }
 
     int empid = 0;
-    xora_err_t rc = xora_create_employee_with_lock(conn, row, &empid);
+    xora_err_t rc = xora_create_employee_with_lock_ex(conn, row, &empid, XORA_CREATE_SERVER);
     if(rc == XORA_TX_ROLLBACK ){
         printf("[Create] Err create new employee with name %.*s failed & rollback.\n", strlen(row->ename),row->ename);
         return 2;
@@ -130,6 +214,9 @@ int main(int argc, char **argv)
     if (batch <= 0)
         batch = 128;
 
+    /* XORA_STATS=1: record per-op latencies, dumped to stderr at exit */
+    xora_stats_enable(atoi(get_env_or("XORA_STATS", "0")) != 0);
+
     xora_conn_t *conn = NULL;
 
     /* Create handle */
@@ -147,6 +234,10 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    /* XORA_LOG_ASYNC=1: ORA error lines go through the background writer */
+    if (atoi(get_env_or("XORA_LOG_ASYNC", "0")) != 0)
+        xora_log_start(NULL);
+
     printf("Static Array Fetch\n\n");
     fetch_emp_arrst(conn, cap, batch);
     printf("\n");
@@ -174,10 +265,28 @@ int main(int argc, char **argv)
     fetch_emp_vect(conn);
     printf("\n");
 
+    printf("\n\nStreaming Cursor Fetch\n\n");
+    fetch_emp_stream(conn, batch);
+    printf("\n");
+
+    printf("\n\nParallel Scan\n\n");
+    scan_emp_parallel(user, pass, db, 4);
+    printf("\n");
+
     
 
+    if (xora_stats_is_enabled())
+    {
+        xora_conn_stats_snapshot_t cs;
+        xora_conn_get_stats(conn, &cs);
+        fprintf(stderr, "conn calls=%lld round_trips=%lld rows=%lld errors=%lld busy_us=%.1f\n",
+                cs.calls, cs.round_trips, cs.rows, cs.errors, cs.busy_ns / 1e3);
+        xora_stats_dump(stderr);
+    }
+
     xora_conn_close(conn);
     xora_conn_destroy(&conn);
+    xora_log_stop();
 
     return 0;
 }
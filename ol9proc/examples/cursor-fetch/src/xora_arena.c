@@ -0,0 +1,180 @@
+/* xora_arena.c
+ *
+ * Arena allocator slow paths and the stb_ds allocation hooks.
+ * Notes:
+ *  - The bump fast path is inline in xora_alloc.h; this file only runs when a
+ *    chunk is full, on reset/rewind/release, and for stb_ds.
+ *  - Huge-page chunks are mapped 2 MiB larger than needed and trimmed to a
+ *    2 MiB boundary, so the kernel can back them with whole huge pages.
+ *  - stb_ds blocks carry a 16-byte header {size, owner}: owner NULL = heap.
+ *  - This file is the one stb_ds implementation of the library.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define STB_DS_IMPLEMENTATION
+#include "xora_stbds.h"
+
+#define XORA__HUGE_PAGE ((size_t)2u << 20)
+
+/*  chunks  */
+
+static xora_arena_chunk_t *xora__chunk_new(xora_arena_t *a, size_t cap)
+{
+  size_t total = sizeof(xora_arena_chunk_t) + cap;
+  xora_arena_chunk_t *c = NULL;
+  size_t map_len = 0;
+
+#if defined(MAP_ANONYMOUS) && defined(MADV_HUGEPAGE)
+  if ((a->flags & XORA_ARENA_HUGEPAGES) && total >= XORA__HUGE_PAGE)
+  {
+    size_t len = (total + XORA__HUGE_PAGE - 1) & ~(XORA__HUGE_PAGE - 1);
+    char *raw = (char *)mmap(NULL, len + XORA__HUGE_PAGE, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw != MAP_FAILED)
+    {
+      char *base = (char *)(((uintptr_t)raw + XORA__HUGE_PAGE - 1) & ~(uintptr_t)(XORA__HUGE_PAGE - 1));
+      size_t head = (size_t)(base - raw);
+      if (head)
+        munmap(raw, head);
+      munmap(base + len, XORA__HUGE_PAGE - head);
+      madvise(base, len, MADV_HUGEPAGE); /* advisory; THP may be off */
+      c = (xora_arena_chunk_t *)base;
+      map_len = len;
+      cap = len - sizeof(xora_arena_chunk_t);
+    }
+  }
+#endif
+
+  if (!c)
+    c = (xora_arena_chunk_t *)xora_malloc(total);
+
+  c->prev = NULL;
+  c->cap = cap;
+  c->used = 0;
+  c->map_len = map_len;
+  a->reserved += cap;
+  return c;
+}
+
+static void xora__chunk_free(xora_arena_t *a, xora_arena_chunk_t *c)
+{
+  a->reserved -= c->cap;
+  if (c->map_len)
+    munmap(c, c->map_len);
+  else
+    free(c);
+}
+
+void *xora_arena_alloc_slow(xora_arena_t *a, size_t size)
+{
+  size_t cap = a->next_size;
+  if (cap < size)
+    cap = size;
+  if (a->next_size < XORA_ARENA_CHUNK_MAX)
+    a->next_size *= 2;
+
+  xora_arena_chunk_t *c = xora__chunk_new(a, cap);
+  c->prev = a->cur;
+  a->cur = c;
+
+  void *p = (char *)(c + 1);
+  c->used = size;
+  a->last = p;
+  return p;
+}
+
+void xora_arena_rewind(xora_arena_t *a, xora_arena_mark_t m)
+{
+  while (a->cur && a->cur != m.chunk)
+  {
+    xora_arena_chunk_t *prev = a->cur->prev;
+    xora__chunk_free(a, a->cur);
+    a->cur = prev;
+  }
+  if (a->cur)
+    a->cur->used = m.used;
+  a->last = NULL;
+}
+
+void xora_arena_reset(xora_arena_t *a)
+{
+  if (!a->cur)
+    return;
+  if (a->cur->prev)
+  {
+    /* several chunks: replace them with one that holds what was handed out */
+    size_t total = 0;
+    for (xora_arena_chunk_t *c = a->cur; c; c = c->prev)
+      total += c->used;
+    xora_arena_release(a);
+    a->cur = xora__chunk_new(a, total);
+    a->next_size = total < XORA_ARENA_CHUNK_MAX ? total : XORA_ARENA_CHUNK_MAX;
+  }
+  a->cur->used = 0;
+  a->last = NULL;
+}
+
+void xora_arena_release(xora_arena_t *a)
+{
+  xora_arena_mark_t none;
+  none.chunk = NULL;
+  none.used = 0;
+  xora_arena_rewind(a, none);
+  a->next_size = a->chunk_size;
+}
+
+/*  stb_ds hooks  */
+
+typedef struct XoraStbdsHdr
+{
+  size_t size;
+  xora_arena_t *owner; /* NULL: heap block */
+} xora__stbds_hdr_t;
+
+static _Thread_local xora_arena_t *xora__arena_cur = NULL;
+
+xora_arena_t *xora_arena_use(xora_arena_t *a)
+{
+  xora_arena_t *prev = xora__arena_cur;
+  xora__arena_cur = a;
+  return prev;
+}
+
+xora_arena_t *xora_arena_current(void)
+{
+  return xora__arena_cur;
+}
+
+void *xora_stbds_realloc(void *p, size_t size)
+{
+  xora__stbds_hdr_t *h = p ? (xora__stbds_hdr_t *)p - 1 : NULL;
+  xora_arena_t *a = h ? h->owner : xora__arena_cur;
+  size_t total = sizeof(*h) + size;
+  if (total < size)
+  {
+    fprintf(stderr, "FATAL: stb_ds size overflow (%zu)\n", size);
+    abort();
+  }
+
+  xora__stbds_hdr_t *n;
+  if (a)
+    n = (xora__stbds_hdr_t *)xora_arena_realloc(a, h, h ? sizeof(*h) + h->size : 0, total);
+  else
+    n = (xora__stbds_hdr_t *)xora_realloc(h, total);
+  n->size = size;
+  n->owner = a;
+  return n + 1;
+}
+
+void xora_stbds_free(void *p)
+{
+  if (!p)
+    return;
+  xora__stbds_hdr_t *h = (xora__stbds_hdr_t *)p - 1;
+  if (!h->owner)
+    free(h);
+  /* arena blocks go with the next reset */
+}
@@ -0,0 +1,1889 @@
+/* xora_bench.c
+ *
+ * Micro and macro benchmarks for xora_db. Built twice from this file:
+ *   xora_bench      against Oracle (credentials as for the demo)
+ *   xora_bench_sim  against the in-process simulated backend (XORA_BENCH_SIM)
+ *
+ * Scenarios:
+ *   fetch   streaming cursor throughput vs. batch size (+ adaptive)
+ *   copy    row copy/conversion cost: column batch -> rows, and host arrays
+ *           + copy vs. direct fetch over the whole table
+ *   insert  single-row vs. array INSERT vs. write-behind group commit
+ *   pool    checkout throughput and wait latency vs. thread count
+ *   scan    parallel partitioned scan vs. partitions
+ *   stats   instrumentation overhead, recording off vs. on
+ *   arena   arena vs. malloc: small blocks, and whole result sets (heap
+ *           stb_ds vector vs. xora_emp_fetch_arena vs. stb_ds on an arena)
+ *   cols    columnar kernels per SIMD level (results cross-checked) vs. a
+ *           row-array scan, and fetch into columns vs. rows
+ *   utf8    bounded UTF-8 copy: corpus self-check against the reference at
+ *           every SIMD level, then reference vs. fast per level
+ *   decimal salary decoding: VARNUM and text to cents (round-trip checked)
+ *           vs. the old float bind, and how many NUMBER(8,2) values a float
+ *           cannot carry
+ *   mt      get_by_id throughput vs. threads, one connection each, checking
+ *           every call's sqlcode against its outcome (per-handle sqlca)
+ *   log     ORA error records from many threads at once, written on the
+ *           calling thread vs. through the async ring (latency, drops)
+ *   async   (XORA_WITH_UV) get_by_id kept in flight on a libuv loop vs.
+ *           blocking calls, async fetch, async inserts + COMMIT on a
+ *           caller-held session
+ *
+ * Output is one key=value line per measurement; times are the median of
+ * --repeat runs. Round trips come from the per-connection stats, so
+ * recording is on unless --no-stats is given.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_stbds.h"
+#include "xora_contex.h"
+#include "xora_proc_emp.h"
+#include "xora_proc_emp_fetch.h"
+#include "xora_proc_emp_crud.h"
+#include "xora_pool.h"
+#include "xora_emp_pscan.h"
+#include "xora_emp_wbq.h"
+#include "xora_stats.h"
+#include "xora_simd.h"
+#include "xora_col.h"
+#include "xora_emp_cols.h"
+#include "xora_utf8.h"
+#include "xora_decimal.h"
+#include "xora_log.h"
+#ifdef XORA_WITH_UV
+#include "xora_uv.h"
+#endif
+#ifdef XORA_BENCH_SIM
+#include "xora_sim.h"
+#endif
+
+typedef struct BenchCtx
+{
+  const char *user;
+  const char *pass;
+  const char *db;
+  int repeat;
+  int threads;     /* upper bound for thread sweeps */
+  int fetch_rows;  /* rows per fetch measurement */
+  int inserts;     /* rows per insert measurement */
+  int calls;       /* calls per stats measurement */
+  int allow_commit;
+  int stats;
+} bench_ctx_t;
+
+static volatile long long bench_sink;
+
+static const char *get_env_or(const char *key, const char *defv)
+{
+  const char *v = getenv(key);
+  return (v && *v) ? v : defv;
+}
+
+static void usage(const char *prog)
+{
+  fprintf(stderr,
+          "Usage: %s [options] [fetch|copy|insert|pool|scan|stats|arena|cols|utf8|decimal|mt|log|async ...]\n"
+          "  --repeat N      runs per measurement, median reported (3)\n"
+          "  --threads N     largest thread count in sweeps (16)\n"
+          "  --fetch-rows N  rows per fetch measurement (50000)\n"
+          "  --inserts N     rows per insert measurement (2000)\n"
+          "  --calls N       calls per stats measurement, a tenth per thread for mt,\n"
+          "                  records per thread for log (20000)\n"
+          "  --commit        allow committing inserts (always on for the simulator)\n"
+          "  --no-stats      do not record stats (round_trips then reads 0)\n"
+#ifdef XORA_BENCH_SIM
+          "  --rtt-us N --row-ns N --connect-us N --rows N --spin\n"
+          "                  simulated costs (env XORA_SIM_*)\n"
+#else
+          "  --user U --pass P --db //host:1521/SERVICE   (env ORA_USER, ORA_PASS, ORA_DB)\n"
+#endif
+          "No scenario = all.\n",
+          prog);
+}
+
+static double bench_ms(uint64_t ns)
+{
+  return (double)ns / 1e6;
+}
+
+static int bench_ll_cmp(const void *a, const void *b)
+{
+  long long x = *(const long long *)a, y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+/* Sorts v */
+static long long bench_pct(long long *v, int n, double q)
+{
+  if (n <= 0)
+    return 0;
+  qsort(v, (size_t)n, sizeof(*v), bench_ll_cmp);
+  int i = (int)(q * (n - 1) + 0.5);
+  return v[i];
+}
+
+static long long bench_round_trips(xora_conn_t *h)
+{
+  xora_conn_stats_snapshot_t cs;
+  xora_conn_get_stats(h, &cs);
+  return cs.round_trips;
+}
+
+static xora_conn_t *bench_connect(const bench_ctx_t *ctx)
+{
+  xora_conn_t *h = NULL;
+  if (xora_conn_create(&h, ctx->user, ctx->pass, ctx->db) != XORA_OK)
+    return NULL;
+  if (xora_conn_open(h) != XORA_CONN_OPEN_OK)
+  {
+    xora_conn_destroy(&h);
+    return NULL;
+  }
+  return h;
+}
+
+static void bench_fill_row(xora_emp_row_t *r, int i)
+{
+  memset(r, 0, sizeof(*r));
+  r->salary = 2000.0 + (i % 1000);
+  if (i % 97 == 0)
+    r->ename_is_null = 1;
+  else
+    snprintf(r->ename, sizeof(r->ename), "BENCH_%d", i);
+}
+
+/*  fetch: batch size sweep  */
+
+/* One cursor pass, stopped after max_rows rows; returns elapsed ns */
+static uint64_t bench_fetch_pass(xora_conn_t *h, const xora_fetch_opts_t *opts, int max_rows,
+                                 long long *out_rows, int *out_final_batch)
+{
+  xora_emp_cursor_t *c = NULL;
+  uint64_t t0 = xora_stats_now_ns();
+  if (xora_emp_cursor_open_ex(h, &c, opts) != XORA_OK)
+    return 0;
+
+  xora_emp_batch_view_t v;
+  long long rows = 0;
+  while (rows < max_rows && xora_emp_cursor_next_batch(c, &v) == XORA_OK)
+  {
+    rows += v.count;
+    bench_sink += v.empno[v.count - 1];
+  }
+  *out_final_batch = xora_emp_cursor_batch_size(c);
+  xora_emp_cursor_close(&c);
+  *out_rows = rows;
+  return xora_stats_now_ns() - t0;
+}
+
+static int bench_fetch(const bench_ctx_t *ctx)
+{
+  static const int sizes[] = {1, 8, 32, 128, 512, 1024, 4096, 0 /* adaptive */};
+  xora_conn_t *h = bench_connect(ctx);
+  if (!h)
+    return 1;
+
+  long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+  {
+    xora_fetch_opts_t opts;
+    xora_fetch_opts_init(&opts);
+    opts.batch_size = sizes[s] ? sizes[s] : 64;
+    opts.adaptive = (sizes[s] == 0);
+
+    /* small batches pay one round trip per few rows: cap them */
+    int max_rows = ctx->fetch_rows;
+    if (sizes[s] && max_rows > sizes[s] * 2000)
+      max_rows = sizes[s] * 2000;
+
+    long long rows = 0, rts = 0;
+    int final_batch = 0;
+    for (int r = 0; r < ctx->repeat; ++r)
+    {
+      long long rt0 = bench_round_trips(h);
+      t[r] = (long long)bench_fetch_pass(h, &opts, max_rows, &rows, &final_batch);
+      rts = bench_round_trips(h) - rt0;
+    }
+    long long ns = bench_pct(t, ctx->repeat, 0.5);
+    printf("bench=fetch batch=%s%d rows=%lld round_trips=%lld ms=%.2f rows_per_s=%.0f us_per_round_trip=%.1f\n",
+           opts.adaptive ? "adaptive:" : "", opts.adaptive ? final_batch : sizes[s],
+           rows, rts, bench_ms((uint64_t)ns), ns ? rows * 1e9 / ns : 0.0,
+           rts ? ns / 1e3 / rts : 0.0);
+  }
+
+  xora_free(t);
+  xora_conn_destroy(&h);
+  return 0;
+}
+
+/*  copy: conversion cost  */
+
+static int bench_copy(const bench_ctx_t *ctx)
+{
+  enum
+  {
+    N = 4096
+  };
+  const int iters = 200;
+
+  /* A batch shaped like a fetch result: varied name lengths, some NULLs */
+  xora_emp_batch_t b;
+  xora_emp_batch_alloc(&b, N);
+  for (int i = 0; i < N; ++i)
+  {
+    b.empno[i] = i + 1;
+    b.salary[i] = 1000.0 + (double)(i % 500);
+    b.ename_ind[i] = (i % 97 == 0) ? -1 : 0;
+    memset(b.ename[i], 0, sizeof(b.ename[i]));
+    snprintf(b.ename[i], sizeof(b.ename[i]), "%.*s", 4 + i % 40,
+             "EMPLOYEE_NAME_WITH_A_FAIRLY_LONG_TAIL_0123456789");
+  }
+  b.count = N;
+
+  xora_emp_row_t *rows = XORA_ALLOC_ARRAY(xora_emp_row_t, N);
+  xora_emp_row_t *rows2 = XORA_ALLOC_ARRAY(xora_emp_row_t, N);
+  memset(rows, 0, sizeof(xora_emp_row_t) * N);
+  long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+
+  /* What xora_emp_fetch_arrst does per row */
+  for (int r = 0; r < ctx->repeat; ++r)
+  {
+    uint64_t t0 = xora_stats_now_ns();
+    for (int it = 0; it < iters; ++it)
+      for (int i = 0; i < N; ++i)
+      {
+        xora_emp_row_t *o = &rows[i];
+        o->empno = b.empno[i];
+        o->salary = b.salary[i];
+        o->ename_is_null = (b.ename_ind[i] < 0);
+        xora_utf8_copy_bounded(o->ename, b.ename[i], sizeof(o->ename));
+      }
+    t[r] = (long long)(xora_stats_now_ns() - t0);
+  }
+  bench_sink += rows[N - 1].empno;
+  printf("bench=copy kind=columns_to_rows_utf8 rows=%d ns_per_row=%.2f\n", N,
+         (double)bench_pct(t, ctx->repeat, 0.5) / ((double)iters * N));
+
+  /* Same, fixed-width name copy (no scan) */
+  for (int r = 0; r < ctx->repeat; ++r)
+  {
+    uint64_t t0 = xora_stats_now_ns();
+    for (int it = 0; it < iters; ++it)
+      for (int i = 0; i < N; ++i)
+      {
+        xora_emp_row_t *o = &rows[i];
+        o->empno = b.empno[i];
+        o->salary = b.salary[i];
+        o->ename_is_null = (b.ename_ind[i] < 0);
+        memcpy(o->ename, b.ename[i], sizeof(o->ename));
+      }
+    t[r] = (long long)(xora_stats_now_ns() - t0);
+  }
+  bench_sink += rows[N - 1].empno;
+  printf("bench=copy kind=columns_to_rows_memcpy rows=%d ns_per_row=%.2f\n", N,
+         (double)bench_pct(t, ctx->repeat, 0.5) / ((double)iters * N));
+
+  /* Row array move (the direct fetch lands rows in place; this is the floor) */
+  for (int r = 0; r < ctx->repeat; ++r)
+  {
+    uint64_t t0 = xora_stats_now_ns();
+    for (int it = 0; it < iters; ++it)
+    {
+      memcpy(rows2, rows, sizeof(xora_emp_row_t) * N);
+      bench_sink += rows2[it % N].empno;
+    }
+    t[r] = (long long)(xora_stats_now_ns() - t0);
+  }
+  printf("bench=copy kind=row_memcpy rows=%d ns_per_row=%.2f\n", N,
+         (double)bench_pct(t, ctx->repeat, 0.5) / ((double)iters * N));
+
+  xora_free(rows2);
+  xora_free(rows);
+  xora_emp_batch_free(&b);
+
+  /* End to end: host arrays + copy vs. host struct array */
+  xora_conn_t *h = bench_connect(ctx);
+  if (!h)
+  {
+    xora_free(t);
+    return 1;
+  }
+  int cap = ctx->fetch_rows;
+  xora_emp_row_t *out = XORA_ALLOC_ARRAY(xora_emp_row_t, cap);
+  for (int direct = 0; direct < 2; ++direct)
+  {
+    int got = 0;
+    for (int r = 0; r < ctx->repeat; ++r)
+    {
+      uint64_t t0 = xora_stats_now_ns();
+      xora_err_t rc = direct ? xora_emp_fetch_direct(h, out, cap, &got, XORA_MAX_BATCH)
+                             : xora_emp_fetch_arrst(h, out, cap, &got, XORA_MAX_BATCH);
+      t[r] = (long long)(xora_stats_now_ns() - t0);
+      if (rc != XORA_OK)
+        fprintf(stderr, "bench=copy fetch failed rc=%d\n", (int)rc);
+    }
+    long long ns = bench_pct(t, ctx->repeat, 0.5);
+    printf("bench=copy kind=%s rows=%d ms=%.2f rows_per_s=%.0f\n",
+           direct ? "fetch_direct" : "fetch_arrst", got, bench_ms((uint64_t)ns),
+           ns ? got * 1e9 / ns : 0.0);
+  }
+  xora_free(out);
+  xora_free(t);
+  xora_conn_destroy(&h);
+  return 0;
+}
+
+/*  insert: single vs. array vs. group commit  */
+
+typedef struct BenchWbqArg
+{
+  xora_emp_wbq_t *q;
+  int from, to;
+  int failed;
+} bench_wbq_arg_t;
+
+static void *bench_wbq_producer(void *p)
+{
+  bench_wbq_arg_t *a = (bench_wbq_arg_t *)p;
+  int n = a->to - a->from;
+  xora_wb_ticket_t **tk = XORA_CALLOC_ARRAY(xora_wb_ticket_t *, n);
+  for (int i = 0; i < n; ++i)
+  {
+    xora_emp_row_t row;
+    bench_fill_row(&row, a->from + i);
+    if (xora_wbq_submit(a->q, &row, &tk[i]) != XORA_OK)
+      a->failed++;
+  }
+  for (int i = 0; i < n; ++i)
+  {
+    if (!tk[i])
+      continue;
+    int id = 0;
+    if (xora_wb_ticket_wait(tk[i], -1, &id) != XORA_OK)
+      a->failed++;
+    xora_wb_ticket_free(&tk[i]);
+  }
+  xora_free(tk);
+  return NULL;
+}
+
+static void bench_insert_line(const char *mode, int chunk, int rows, long long rts, long long ns,
+                              int failed)
+{
+  printf("bench=insert mode=%s chunk=%d rows=%d failed=%d round_trips=%lld ms=%.2f rows_per_s=%.0f\n",
+         mode, chunk, rows, failed, rts, bench_ms((uint64_t)ns), ns ? rows * 1e9 / ns : 0.0);
+}
+
+static int bench_insert(const bench_ctx_t *ctx)
+{
+  static const int chunks[] = {16, 128, 1024};
+  xora_conn_t *h = bench_connect(ctx);
+  if (!h)
+    return 1;
+
+  int n = ctx->inserts;
+  xora_emp_row_t *rows = XORA_ALLOC_ARRAY(xora_emp_row_t, n);
+  int *ids = XORA_ALLOC_ARRAY(int, n);
+  for (int i = 0; i < n; ++i)
+    bench_fill_row(&rows[i], i);
+
+  /* Committing modes only run when allowed; the rest roll back */
+  for (int commit_each = 0; commit_each <= ctx->allow_commit; ++commit_each)
+  {
+    int base = 0, failed = 0;
+    xora_emp_next_id(h, &base);
+    long long rt0 = bench_round_trips(h);
+    uint64_t t0 = xora_stats_now_ns();
+    for (int i = 0; i < n; ++i)
+    {
+      int id = 0;
+      if (xora_emp_create_with_id(h, &rows[i], base + i, &id) != XORA_OK)
+        failed++;
+      if (commit_each)
+        xora_tx_commit(h);
+    }
+    uint64_t ns = xora_stats_now_ns() - t0;
+    long long rts = bench_round_trips(h) - rt0;
+    if (!commit_each)
+      xora_tx_rollback(h);
+    bench_insert_line(commit_each ? "single_commit_each" : "single", 1, n, rts, (long long)ns, failed);
+  }
+
+  for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c)
+  {
+    long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+    long long rts = 0;
+    int failed = 0;
+    for (int r = 0; r < ctx->repeat; ++r)
+    {
+      int base = 0;
+      xora_emp_next_id(h, &base);
+      for (int i = 0; i < n; ++i)
+        ids[i] = base + i;
+
+      xora_bulk_report_t rep;
+      memset(&rep, 0, sizeof(rep));
+      long long rt0 = bench_round_trips(h);
+      uint64_t t0 = xora_stats_now_ns();
+      xora_emp_bulk_create(h, rows, n, ids, chunks[c], &rep);
+      t[r] = (long long)(xora_stats_now_ns() - t0);
+      rts = bench_round_trips(h) - rt0;
+      failed = rep.rows_failed;
+      if (ctx->allow_commit)
+        xora_tx_commit(h);
+      else
+        xora_tx_rollback(h);
+    }
+    bench_insert_line("bulk", chunks[c], n, rts, bench_pct(t, ctx->repeat, 0.5), failed);
+    xora_free(t);
+  }
+
+  /* Write-behind: producers submit, one writer groups and commits */
+  if (ctx->allow_commit)
+  {
+    for (int nt = 1; nt <= ctx->threads; nt *= 4)
+    {
+      xora_wbq_config_t cfg;
+      xora_wbq_config_init(&cfg);
+      cfg.max_batch = 256;
+      cfg.linger_ms = 1;
+      cfg.conn = bench_connect(ctx);
+      cfg.ids = NULL; /* the bench is the only writer */
+      xora_emp_wbq_t *q = NULL;
+      if (!cfg.conn || xora_wbq_create(&q, &cfg) != XORA_OK)
+      {
+        xora_conn_destroy(&cfg.conn);
+        break;
+      }
+
+      pthread_t *th = XORA_ALLOC_ARRAY(pthread_t, nt);
+      bench_wbq_arg_t *args = XORA_CALLOC_ARRAY(bench_wbq_arg_t, nt);
+      long long rt0 = bench_round_trips(cfg.conn);
+      uint64_t t0 = xora_stats_now_ns();
+      for (int i = 0; i < nt; ++i)
+      {
+        args[i].q = q;
+        args[i].from = (int)((long long)n * i / nt);
+        args[i].to = (int)((long long)n * (i + 1) / nt);
+        pthread_create(&th[i], NULL, bench_wbq_producer, &args[i]);
+      }
+      int failed = 0;
+      for (int i = 0; i < nt; ++i)
+      {
+        pthread_join(th[i], NULL);
+        failed += args[i].failed;
+      }
+      uint64_t ns = xora_stats_now_ns() - t0;
+      long long rts = bench_round_trips(cfg.conn) - rt0;
+
+      xora_wbq_stats_t ws;
+      xora_wbq_get_stats(q, &ws);
+      xora_wbq_destroy(&q);
+      xora_conn_destroy(&cfg.conn);
+
+      char mode[48];
+      snprintf(mode, sizeof(mode), "write_behind_%dthr", nt);
+      bench_insert_line(mode, ws.max_group, n, rts, (long long)ns, failed);
+      xora_free(args);
+      xora_free(th);
+    }
+  }
+
+  xora_free(ids);
+  xora_free(rows);
+  xora_conn_destroy(&h);
+  return 0;
+}
+
+/*  pool: checkout contention  */
+
+typedef struct BenchPoolArg
+{
+  xora_pool_t *pool;
+  int ops;
+  int hold; /* ping while holding the session */
+  long long *wait_ns;
+  int timeouts;
+} bench_pool_arg_t;
+
+static void *bench_pool_worker(void *p)
+{
+  bench_pool_arg_t *a = (bench_pool_arg_t *)p;
+  for (int i = 0; i < a->ops; ++i)
+  {
+    xora_conn_t *c = NULL;
+    uint64_t t0 = xora_stats_now_ns();
+    if (xora_pool_acquire(a->pool, &c, 5000) != XORA_OK)
+    {
+      a->timeouts++;
+      a->wait_ns[i] = 0;
+      continue;
+    }
+    a->wait_ns[i] = (long long)(xora_stats_now_ns() - t0);
+    xora_conn_health_t hl = XORA_HEALTH_OK;
+    if (a->hold && xora_conn_is_open(c) != XORA_CONN_OPEN_OK)
+      hl = XORA_HEALTH_SUSPECT;
+    xora_pool_release(a->pool, c, hl);
+  }
+  return NULL;
+}
+
+static int bench_pool(const bench_ctx_t *ctx)
+{
+  const int pool_size = 4;
+  xora_pool_config_t cfg;
+  xora_pool_config_init(&cfg);
+  cfg.min_size = pool_size;
+  cfg.max_size = pool_size;
+  cfg.validate_after_ms = -1;
+  cfg.user = ctx->user;
+  cfg.pass = ctx->pass;
+  cfg.db = ctx->db;
+
+  xora_pool_t *pool = NULL;
+  if (xora_pool_create(&pool, &cfg) != XORA_OK)
+    return 1;
+
+  for (int hold = 0; hold < 2; ++hold)
+  {
+    int total = hold ? 2000 : 200000;
+    for (int nt = 1; nt <= ctx->threads; nt *= 2)
+    {
+      int per = total / nt;
+      pthread_t *th = XORA_ALLOC_ARRAY(pthread_t, nt);
+      bench_pool_arg_t *args = XORA_CALLOC_ARRAY(bench_pool_arg_t, nt);
+      long long *waits = XORA_ALLOC_ARRAY(long long, (size_t)per * nt);
+
+      xora_pool_stats_t s0, s1;
+      xora_pool_get_stats(pool, &s0);
+      uint64_t t0 = xora_stats_now_ns();
+      for (int i = 0; i < nt; ++i)
+      {
+        args[i].pool = pool;
+        args[i].ops = per;
+        args[i].hold = hold;
+        args[i].wait_ns = waits + (size_t)per * i;
+        pthread_create(&th[i], NULL, bench_pool_worker, &args[i]);
+      }
+      int timeouts = 0;
+      for (int i = 0; i < nt; ++i)
+      {
+        pthread_join(th[i], NULL);
+        timeouts += args[i].timeouts;
+      }
+      uint64_t ns = xora_stats_now_ns() - t0;
+      xora_pool_get_stats(pool, &s1);
+
+      int nops = per * nt;
+      printf("bench=pool work=%s pool=%d threads=%d ops=%d ops_per_s=%.0f waits=%lld timeouts=%d "
+             "acquire_p50_us=%.2f acquire_p99_us=%.2f\n",
+             hold ? "ping" : "none", pool_size, nt, nops, ns ? nops * 1e9 / ns : 0.0,
+             s1.waits - s0.waits, timeouts,
+             bench_pct(waits, nops, 0.50) / 1e3, bench_pct(waits, nops, 0.99) / 1e3);
+
+      xora_free(waits);
+      xora_free(args);
+      xora_free(th);
+    }
+  }
+
+  xora_pool_destroy(&pool);
+  return 0;
+}
+
+/*  scan: parallel partitioned scan  */
+
+/* Unordered scans call back on the worker threads */
+static int bench_scan_cb(void *ud, int part, const xora_emp_batch_view_t *view)
+{
+  (void)part;
+  atomic_fetch_add_explicit((atomic_llong *)ud, view->count, memory_order_relaxed);
+  return 0;
+}
+
+static int bench_scan(const bench_ctx_t *ctx)
+{
+  xora_pool_config_t cfg;
+  xora_pool_config_init(&cfg);
+  cfg.min_size = 1;
+  cfg.max_size = ctx->threads;
+  cfg.validate_after_ms = -1;
+  cfg.user = ctx->user;
+  cfg.pass = ctx->pass;
+  cfg.db = ctx->db;
+
+  xora_pool_t *pool = NULL;
+  if (xora_pool_create(&pool, &cfg) != XORA_OK)
+    return 1;
+
+  long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+  for (int ordered = 0; ordered < 2; ++ordered)
+    for (int np = 1; np <= ctx->threads; np *= 2)
+    {
+      xora_pscan_opts_t o;
+      xora_pscan_opts_init(&o);
+      o.nparts = np;
+      o.split = XORA_PSCAN_RANGE;
+      o.ordered = ordered;
+      o.fetch.batch_size = XORA_MAX_BATCH;
+
+      xora_pscan_stats_t st;
+      memset(&st, 0, sizeof(st));
+      atomic_llong seen = 0;
+      for (int r = 0; r < ctx->repeat; ++r)
+      {
+        uint64_t t0 = xora_stats_now_ns();
+        if (xora_emp_pscan(pool, &o, bench_scan_cb, &seen, &st) != XORA_OK)
+          fprintf(stderr, "bench=scan pscan failed parts=%d\n", np);
+        t[r] = (long long)(xora_stats_now_ns() - t0);
+      }
+      bench_sink += atomic_load(&seen);
+      long long ns = bench_pct(t, ctx->repeat, 0.5);
+      printf("bench=scan split=range ordered=%d parts=%d rows=%lld ms=%.2f rows_per_s=%.0f skew=%.2f\n",
+             ordered, np, st.rows, bench_ms((uint64_t)ns), ns ? st.rows * 1e9 / ns : 0.0,
+             st.min_part_rows ? (double)st.max_part_rows / st.min_part_rows : 0.0);
+    }
+
+  xora_free(t);
+  xora_pool_destroy(&pool);
+  return 0;
+}
+
+/*  stats: instrumentation overhead  */
+
+static int bench_stats(const bench_ctx_t *ctx)
+{
+  xora_conn_t *h = bench_connect(ctx);
+  if (!h)
+    return 1;
+
+#ifdef XORA_BENCH_SIM
+  /* With no simulated latency only the client path is left to measure */
+  xora_sim_config_t saved;
+  xora_sim_get_config(&saved);
+  xora_sim_set_latency(0, 0);
+#endif
+
+  int was = xora_stats_is_enabled();
+  long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+  double per_call[2] = {0, 0};
+  for (int on = 0; on < 2; ++on)
+  {
+    xora_stats_enable(on);
+    for (int r = 0; r < ctx->repeat; ++r)
+    {
+      uint64_t t0 = xora_stats_now_ns();
+      for (int i = 0; i < ctx->calls; ++i)
+      {
+        xora_emp_row_t row;
+        int found = 0;
+        xora_emp_get_by_id(h, 1 + i % 1000, &row, &found);
+        bench_sink += found;
+      }
+      t[r] = (long long)(xora_stats_now_ns() - t0);
+    }
+    per_call[on] = (double)bench_pct(t, ctx->repeat, 0.5) / ctx->calls;
+    printf("bench=stats recording=%s op=get_by_id calls=%d ns_per_call=%.1f\n",
+           on ? "on" : "off", ctx->calls, per_call[on]);
+  }
+  printf("bench=stats overhead_ns_per_call=%.1f overhead_pct=%.2f\n",
+         per_call[1] - per_call[0],
+         per_call[0] > 0 ? 100.0 * (per_call[1] - per_call[0]) / per_call[0] : 0.0);
+  xora_stats_enable(was);
+
+#ifdef XORA_BENCH_SIM
+  xora_sim_set_latency(saved.rtt_us, saved.row_ns);
+#endif
+  xora_free(t);
+  xora_conn_destroy(&h);
+  return 0;
+}
+
+/*  arena: region allocation vs. malloc  */
+
+/* What xora_emp_fetch_vect_ex does (the simulator has no fetch_vect) */
+static xora_err_t bench_fetch_stbds(xora_conn_t *h, xora_emp_row_t **vec)
+{
+  xora_emp_cursor_t *c = NULL;
+  if (xora_emp_cursor_open_ex(h, &c, NULL) != XORA_OK)
+    return XORA_ERR;
+  xora_emp_row_t *rows = *vec;
+  xora_emp_batch_view_t v;
+  xora_err_t rc;
+  while ((rc = xora_emp_cursor_next_batch(c, &v)) == XORA_OK)
+    for (int i = 0; i < v.count; ++i)
+    {
+      xora_emp_row_t row;
+      row.empno = v.empno[i];
+      row.salary = v.salary[i];
+      row.ename_is_null = (v.ename_ind[i] < 0);
+      xora_utf8_copy_bounded(row.ename, v.ename[i], sizeof(row.ename));
+      arrpush(rows, row);
+    }
+  xora_emp_cursor_close(&c);
+  *vec = rows;
+  return rc == XORA_NO_DATA_FOUND ? XORA_OK : XORA_ERR;
+}
+
+static int bench_arena(const bench_ctx_t *ctx)
+{
+  enum
+  {
+    NBLK = 100000
+  };
+  long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+  void **blk = XORA_ALLOC_ARRAY(void *, NBLK);
+
+  /* Small blocks (row-sized strings): malloc + free each vs. bump + reset */
+  for (int kind = 0; kind < 2; ++kind)
+  {
+    xora_arena_t a;
+    xora_arena_init(&a, 0, 0);
+    for (int r = 0; r < ctx->repeat; ++r)
+    {
+      uint64_t t0 = xora_stats_now_ns();
+      for (int it = 0; it < 10; ++it)
+      {
+        for (int i = 0; i < NBLK; ++i)
+        {
+          size_t sz = 8 + (size_t)(i % 57);
+          blk[i] = kind ? xora_arena_alloc(&a, sz) : xora_malloc(sz);
+          *(char *)blk[i] = (char)i;
+        }
+        bench_sink += *(char *)blk[NBLK - 1];
+        if (kind)
+          xora_arena_reset(&a);
+        else
+          for (int i = 0; i < NBLK; ++i)
+            free(blk[i]);
+      }
+      t[r] = (long long)(xora_stats_now_ns() - t0);
+    }
+    printf("bench=arena kind=%s blocks=%d ns_per_block=%.2f\n",
+           kind ? "arena_alloc_reset" : "malloc_free", NBLK,
+           (double)bench_pct(t, ctx->repeat, 0.5) / (10.0 * NBLK));
+    xora_arena_release(&a);
+  }
+  xora_free(blk);
+
+  /* Whole result sets, one request after another */
+  xora_conn_t *h = bench_connect(ctx);
+  if (!h)
+  {
+    xora_free(t);
+    return 1;
+  }
+#ifdef XORA_BENCH_SIM
+  /* allocation is client work: leave the simulated wire out */
+  xora_sim_config_t saved;
+  xora_sim_get_config(&saved);
+  xora_sim_set_latency(0, 0);
+#endif
+
+  static const char *const kinds[] = {"heap_stbds_vect", "fetch_arena", "arena_stbds_vect"};
+  const int requests = 5;
+  for (int kind = 0; kind < 3; ++kind)
+  {
+    xora_arena_t a;
+    xora_arena_init(&a, 0, 0);
+    long long got = 0;
+    for (int r = 0; r < ctx->repeat; ++r)
+    {
+      uint64_t t0 = xora_stats_now_ns();
+      for (int q = 0; q < requests; ++q)
+      {
+        xora_emp_row_t *rows = NULL;
+        int n = 0;
+        xora_err_t rc;
+        if (kind == 1)
+          rc = xora_emp_fetch_arena(h, &a, &rows, &n, 0, NULL);
+        else
+        {
+          xora_arena_t *prev = xora_arena_use(kind == 2 ? &a : NULL);
+          rc = bench_fetch_stbds(h, &rows);
+          xora_arena_use(prev);
+          n = (int)arrlen(rows);
+        }
+        if (rc != XORA_OK)
+          fprintf(stderr, "bench=arena fetch failed rc=%d\n", (int)rc);
+        got = n;
+        if (n)
+          bench_sink += rows[n - 1].empno;
+        if (kind == 0)
+          arrfree(rows);
+        else
+          xora_arena_reset(&a);
+      }
+      t[r] = (long long)(xora_stats_now_ns() - t0);
+    }
+    long long ns = bench_pct(t, ctx->repeat, 0.5) / requests;
+    printf("bench=arena kind=%s rows=%lld ms_per_request=%.2f rows_per_s=%.0f arena_reserved_kb=%zu\n",
+           kinds[kind], got, bench_ms((uint64_t)ns), ns ? got * 1e9 / ns : 0.0,
+           a.reserved >> 10);
+    xora_arena_release(&a);
+  }
+
+#ifdef XORA_BENCH_SIM
+  xora_sim_set_latency(saved.rtt_us, saved.row_ns);
+#endif
+  xora_free(t);
+  xora_conn_destroy(&h);
+  return 0;
+}
+
+/*  cols: columnar kernels  */
+
+typedef struct BenchColsResult
+{
+  double sum, min, max;
+  int64_t sum_cents;
+  size_t cnt, nsel;
+  xora_emp_salary_summary_t by_id;
+} bench_cols_result_t;
+
+static int bench_cols(const bench_ctx_t *ctx)
+{
+  const int N = 1 << 20;
+  const int iters = 20;
+  long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+
+  /* Synthetic result set appended batch by batch: ids ascending, salaries
+   * 1000..9000.75, names of 8..27 bytes, some NULL */
+  xora_emp_cols_t c;
+  xora_emp_cols_init(&c);
+  xora_emp_cols_reserve(&c, N, 16);
+  xora_emp_batch_t b;
+  xora_emp_batch_alloc(&b, 4096);
+  for (int i = 0; i < N;)
+  {
+    b.count = 0;
+    for (; b.count < b.cap && i < N; ++b.count, ++i)
+    {
+      b.empno[b.count] = i + 1;
+      b.salary[b.count] = 1000.0 + (double)(((long long)i * 7919) % 8001) + 0.25 * (double)(i % 4);
+      b.ename_ind[b.count] = (i % 97 == 0) ? -1 : 0;
+      snprintf(b.ename[b.count], sizeof(b.ename[0]), "EMP_%.*s", 4 + i % 20, "ABCDEFGHIJKLMNOPQRSTUVWX");
+    }
+    xora_emp_batch_view_t v = {b.count, b.empno, b.salary, NULL, (const char(*)[51])b.ename, b.ename_ind};
+    xora_emp_cols_append(&c, &v);
+  }
+  xora_emp_batch_free(&b);
+  uint32_t *sel = XORA_ALLOC_ARRAY(uint32_t, N);
+
+  xora_simd_level_t hw = xora_simd_detect();
+  xora_simd_level_t was = xora_simd_level();
+  bench_cols_result_t res[XORA_SIMD_AVX2 + 1];
+  memset(res, 0, sizeof(res));
+
+  for (int lvl = XORA_SIMD_SCALAR; lvl <= (int)hw; ++lvl)
+  {
+    if (lvl == XORA_SIMD_SSE2)
+      continue; /* no SSE2 column kernels */
+    xora_simd_set_level((xora_simd_level_t)lvl);
+    const char *name = xora_simd_level_name((xora_simd_level_t)lvl);
+    bench_cols_result_t *o = &res[lvl];
+
+#define BENCH_COLS_TIME(kernel, stmt)                                                        \
+  do                                                                                         \
+  {                                                                                          \
+    for (int r = 0; r < ctx->repeat; ++r)                                                    \
+    {                                                                                        \
+      uint64_t t0 = xora_stats_now_ns();                                                     \
+      for (int it = 0; it < iters; ++it)                                                     \
+      {                                                                                      \
+        stmt;                                                                                \
+      }                                                                                      \
+      t[r] = (long long)(xora_stats_now_ns() - t0);                                          \
+    }                                                                                        \
+    printf("bench=cols simd=%s kernel=%s rows=%d ns_per_row=%.3f\n", name, kernel, N,        \
+           (double)bench_pct(t, ctx->repeat, 0.5) / ((double)iters * N));                    \
+  } while (0)
+
+    BENCH_COLS_TIME("sum_salary", o->sum = xora_col_sum_f64(c.salary, (size_t)N));
+    BENCH_COLS_TIME("sum_salary_cents", o->sum_cents = xora_col_sum_i64(c.salary_cents, (size_t)N));
+    BENCH_COLS_TIME("minmax_salary", xora_col_minmax_f64(c.salary, (size_t)N, &o->min, &o->max));
+    BENCH_COLS_TIME("count_salary_range",
+                    o->cnt = xora_col_count_range_f64(c.salary, (size_t)N, 3000.0, 7000.0));
+    BENCH_COLS_TIME("filter_salary_range",
+                    o->nsel = xora_col_filter_range_f64(c.salary, (size_t)N, 3000.0, 7000.0, sel));
+    BENCH_COLS_TIME("salary_by_id", xora_emp_cols_salary_by_id(&c, N / 4, N / 4 * 3, &o->by_id));
+#undef BENCH_COLS_TIME
+  }
+
+  if (hw >= XORA_SIMD_AVX2)
+  {
+    const bench_cols_result_t *a = &res[XORA_SIMD_SCALAR], *b = &res[XORA_SIMD_AVX2];
+    int match = a->sum == b->sum && a->sum_cents == b->sum_cents && a->min == b->min && a->max == b->max && a->cnt == b->cnt &&
+                a->nsel == b->nsel && a->by_id.count == b->by_id.count &&
+                a->by_id.sum_cents == b->by_id.sum_cents && a->by_id.min == b->by_id.min &&
+                a->by_id.max == b->by_id.max;
+    char exact[32];
+    xora_cents_format(b->sum_cents, exact, sizeof(exact));
+    printf("bench=cols check=scalar_vs_avx2 match=%d sum=%.2f sum_exact=%s count=%zu\n", match, b->sum,
+           exact, b->cnt);
+    if (!match)
+      fprintf(stderr, "bench=cols scalar and avx2 results differ\n");
+  }
+  xora_simd_set_level(was);
+
+  /* The same sum over a row array drags every name through the cache */
+  xora_emp_row_t *rows = XORA_ALLOC_ARRAY(xora_emp_row_t, N);
+  for (int i = 0; i < N; ++i)
+    xora_emp_cols_get_row(&c, i, &rows[i]);
+  for (int r = 0; r < ctx->repeat; ++r)
+  {
+    uint64_t t0 = xora_stats_now_ns();
+    double s = 0;
+    for (int it = 0; it < iters; ++it)
+      for (int i = 0; i < N; ++i)
+        s += rows[i].salary;
+    t[r] = (long long)(xora_stats_now_ns() - t0);
+    bench_sink += (long long)s;
+  }
+  printf("bench=cols simd=scalar kernel=sum_salary_rows rows=%d ns_per_row=%.3f\n", N,
+         (double)bench_pct(t, ctx->repeat, 0.5) / ((double)iters * N));
+  xora_free(rows);
+  xora_free(sel);
+  xora_emp_cols_free(&c);
+
+  /* End to end: fetch into columns vs. into a row array */
+  xora_conn_t *h = bench_connect(ctx);
+  if (!h)
+  {
+    xora_free(t);
+    return 1;
+  }
+#ifdef XORA_BENCH_SIM
+  xora_sim_config_t saved;
+  xora_sim_get_config(&saved);
+  xora_sim_set_latency(0, 0);
+#endif
+  for (int kind = 0; kind < 2; ++kind)
+  {
+    xora_arena_t a;
+    xora_arena_init(&a, 0, 0);
+    xora_emp_cols_init(&c);
+    long long got = 0;
+    for (int r = 0; r < ctx->repeat; ++r)
+    {
+      uint64_t t0 = xora_stats_now_ns();
+      xora_err_t rc;
+      if (kind)
+      {
+        xora_emp_cols_clear(&c);
+        rc = xora_emp_fetch_cols(h, &c, NULL);
+        got = c.count;
+      }
+      else
+      {
+        xora_emp_row_t *out = NULL;
+        int n = 0;
+        xora_arena_reset(&a);
+        rc = xora_emp_fetch_arena(h, &a, &out, &n, 0, NULL);
+        got = n;
+      }
+      t[r] = (long long)(xora_stats_now_ns() - t0);
+      if (rc != XORA_OK)
+        fprintf(stderr, "bench=cols fetch failed rc=%d\n", (int)rc);
+    }
+    long long ns = bench_pct(t, ctx->repeat, 0.5);
+    printf("bench=cols kind=%s rows=%lld ms=%.2f rows_per_s=%.0f\n",
+           kind ? "fetch_cols" : "fetch_rows", got, bench_ms((uint64_t)ns),
+           ns ? got * 1e9 / ns : 0.0);
+    xora_emp_cols_free(&c);
+    xora_arena_release(&a);
+  }
+#ifdef XORA_BENCH_SIM
+  xora_sim_set_latency(saved.rtt_us, saved.row_ns);
+#endif
+  xora_free(t);
+  xora_conn_destroy(&h);
+  return 0;
+}
+
+/*  utf8: bounded copy  */
+
+/* Well-formed, malformed, and sequences straddling every cut position */
+static const char *const bench_utf8_corpus[] = {
+    "",
+    "A",
+    "SMITH",
+    "ALLEN_WITH_A_NAME_THAT_IS_LONGER_THAN_FIFTY_BYTES_0123456789",
+    "M\xC3\xBCller",
+    "\xC3\x89lise Fran\xC3\xA7oise",
+    "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x83\x86\xE3\x82\xAD\xE3\x82\xB9\xE3\x83\x88",
+    "\xF0\x9F\x98\x80x\xF0\x9F\x98\x80y\xF0\x9F\x98\x80z",
+    "abcdefghijklmnop\xE2\x82\xAC" "abcdefghijklmnop\xC3\xA9" "abcdefghijklmnop\xF0\x9F\x98\x80",
+    "\x80" "abc",                     /* lone continuation */
+    "\xBF\xBF\xBF\xBF\xBF",           /* continuation run */
+    "\xC0\xAF" "x",                   /* overlong '/' */
+    "\xE0\x80\xAF" "x",               /* overlong, 3 bytes */
+    "\xED\xA0\x80" "x",               /* surrogate */
+    "\xF4\x90\x80\x80" "x",           /* above U+10FFFF */
+    "\xF8\x88\x80\x80\x80" "x",       /* 5-byte form */
+    "\xFF\xFE" "x",
+    "abc\xE2\x82",                    /* truncated at the end */
+    "\xE2" "AB" "\xE2\x82\xAC",       /* lead followed by ASCII */
+    "\xC2\x80\x80\x80" "abc",         /* extra continuation bytes */
+    "ab\xF0\x9F\x98",                 /* 4-byte lead, string ends inside */
+};
+
+static int bench_utf8(const bench_ctx_t *ctx)
+{
+  const int ncorpus = (int)(sizeof(bench_utf8_corpus) / sizeof(bench_utf8_corpus[0]));
+  xora_simd_level_t hw = xora_simd_detect();
+  xora_simd_level_t was = xora_simd_level();
+
+  /* Self-check: same string as the reference for every dst size. The
+   * reference can read past a NUL inside a claimed sequence, so inputs sit
+   * in zero-padded buffers. */
+  for (int lvl = XORA_SIMD_SCALAR; lvl <= (int)hw; ++lvl)
+  {
+    xora_simd_set_level((xora_simd_level_t)lvl);
+    int cases = 0, bad = 0;
+    for (int k = 0; k < ncorpus; ++k)
+    {
+      char in[96], ref[80], out[80];
+      memset(in, 0, sizeof(in));
+      xora_str_copy_bounded(in, bench_utf8_corpus[k], 80);
+      for (size_t ds = 1; ds <= 72; ++ds)
+      {
+        xora_ut8_copy_bounded(ref, in, ds);
+        size_t n = xora_utf8_copy_bounded(out, in, ds);
+        cases++;
+        if (strcmp(ref, out) != 0 || n != strlen(out))
+        {
+          if (bad++ < 3)
+            fprintf(stderr, "bench=utf8 mismatch simd=%s corpus=%d dst_size=%zu\n",
+                    xora_simd_level_name((xora_simd_level_t)lvl), k, ds);
+        }
+      }
+    }
+    printf("bench=utf8 check=corpus simd=%s cases=%d mismatches=%d\n",
+           xora_simd_level_name((xora_simd_level_t)lvl), cases, bad);
+  }
+
+  /* Throughput on fetch-shaped names: mostly ASCII, some accented/CJK */
+  enum
+  {
+    N = 4096
+  };
+  const int iters = 200;
+  static char names[N][51];
+  for (int i = 0; i < N; ++i)
+  {
+    memset(names[i], 0, sizeof(names[i]));
+    if (i % 10 == 0)
+      snprintf(names[i], sizeof(names[i]), "M\xC3\xBCller-%d \xE6\x97\xA5\xE6\x9C\xAC", i);
+    else
+      snprintf(names[i], sizeof(names[i]), "%.*s_%d", 4 + i % 40,
+               "EMPLOYEE_NAME_WITH_A_FAIRLY_LONG_TAIL_0123456789", i);
+  }
+  char dst[51];
+  long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+
+  for (int r = 0; r < ctx->repeat; ++r)
+  {
+    uint64_t t0 = xora_stats_now_ns();
+    for (int it = 0; it < iters; ++it)
+      for (int i = 0; i < N; ++i)
+      {
+        xora_ut8_copy_bounded(dst, names[i], sizeof(dst));
+        bench_sink += dst[0];
+      }
+    t[r] = (long long)(xora_stats_now_ns() - t0);
+  }
+  printf("bench=utf8 impl=reference names=%d ns_per_copy=%.2f\n", N,
+         (double)bench_pct(t, ctx->repeat, 0.5) / ((double)iters * N));
+
+  for (int lvl = XORA_SIMD_SCALAR; lvl <= (int)hw; ++lvl)
+  {
+    xora_simd_set_level((xora_simd_level_t)lvl);
+    for (int r = 0; r < ctx->repeat; ++r)
+    {
+      uint64_t t0 = xora_stats_now_ns();
+      for (int it = 0; it < iters; ++it)
+        for (int i = 0; i < N; ++i)
+          bench_sink += (long long)xora_utf8_copy_bounded(dst, names[i], sizeof(dst));
+      t[r] = (long long)(xora_stats_now_ns() - t0);
+    }
+    printf("bench=utf8 impl=fast simd=%s names=%d ns_per_copy=%.2f\n",
+           xora_simd_level_name((xora_simd_level_t)lvl), N,
+           (double)bench_pct(t, ctx->repeat, 0.5) / ((double)iters * N));
+  }
+
+  xora_simd_set_level(was);
+  xora_free(t);
+  return 0;
+}
+
+/*  decimal: exact salary decoding  */
+
+static int bench_decimal(const bench_ctx_t *ctx)
+{
+  enum
+  {
+    N = 4096,
+    TXT = 24 /* STRING host element for TO_CHAR(sal) */
+  };
+  const int iters = 500;
+
+  /* Round trip through VARNUM and text: edges, then a spread of magnitudes */
+  static const int64_t edge[] = {0, 1, -1, 5, 10, 99, 100, 101, -100, 12345, -12345,
+                                 99999999, -99999999, 100000000, 999999999999999999LL,
+                                 -999999999999999999LL};
+  long cases = 0, bad = 0;
+  uint64_t x = 88172645463325252ull;
+  for (int i = 0; i < 200000; ++i)
+  {
+    int64_t c;
+    if (i < (int)(sizeof(edge) / sizeof(edge[0])))
+      c = edge[i];
+    else
+    {
+      x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+      uint64_t mod = 1;
+      for (int d = (int)(x % 18) + 1; d > 0; --d)
+        mod *= 10;
+      c = (int64_t)((x >> 8) % mod);
+      if (x & 1)
+        c = -c;
+    }
+    xora_varnum_t vn;
+    char txt[32];
+    int64_t a = 0, b = 0;
+    int ok = xora_varnum_from_cents(c, vn) == 0 && xora_varnum_to_cents(vn, &a) == 0;
+    int len = xora_cents_format(c, txt, sizeof(txt));
+    ok = ok && xora_dec_to_cents(txt, (size_t)len, &b) == 0 && a == c && b == c;
+    cases++;
+    if (!ok && bad++ < 3)
+      fprintf(stderr, "bench=decimal round trip failed cents=%lld\n", (long long)c);
+  }
+  printf("bench=decimal check=round_trip cases=%ld mismatches=%ld\n", cases, bad);
+
+  /* The old bind: every NUMBER(8,2) value through a float */
+  long lost = 0;
+  int64_t first_lost = -1;
+  for (int64_t c = 0; c < 100000000; ++c)
+  {
+    float f = (float)((double)c / 100.0);
+    if (xora_cents_from_double((double)f) != c)
+    {
+      if (first_lost < 0)
+        first_lost = c;
+      ++lost;
+    }
+  }
+  char fl[32];
+  xora_cents_format(first_lost, fl, sizeof(fl));
+  printf("bench=decimal check=float_bind values=100000000 lost=%ld first_lost=%s\n", lost, fl);
+
+  /* Fetch-shaped batch: NUMBER(8,2) salaries as VARNUM, text and float */
+  xora_varnum_t *vn = XORA_ALLOC_ARRAY(xora_varnum_t, N);
+  char(*txt)[TXT] = (char(*)[TXT])xora_malloc((size_t)N * TXT);
+  float *fl32 = XORA_ALLOC_ARRAY(float, N);
+  int64_t *cents = XORA_ALLOC_ARRAY(int64_t, N);
+  double *dbl = XORA_ALLOC_ARRAY(double, N);
+  for (int i = 0; i < N; ++i)
+  {
+    int64_t c = 100000 + ((long long)i * 7919 * 37) % 99900000;
+    xora_varnum_from_cents(c, vn[i]);
+    memset(txt[i], 0, TXT);
+    xora_cents_format(c, txt[i], TXT);
+    fl32[i] = (float)((double)c / 100.0);
+  }
+
+  long long *t = XORA_ALLOC_ARRAY(long long, ctx->repeat);
+#define BENCH_DEC_TIME(kind, stmt)                                                   \
+  do                                                                                \
+  {                                                                                 \
+    for (int r = 0; r < ctx->repeat; ++r)                                           \
+    {                                                                               \
+      uint64_t t0 = xora_stats_now_ns();                                            \
+      for (int it = 0; it < iters; ++it)                                            \
+      {                                                                             \
+        stmt;                                                                       \
+      }                                                                             \
+      t[r] = (long long)(xora_stats_now_ns() - t0);                                 \
+    }                                                                               \
+    bench_sink += cents[N - 1] + (long long)dbl[N - 1];                             \
+    printf("bench=decimal kind=%s values=%d ns_per_value=%.3f\n", kind, N,          \
+           (double)bench_pct(t, ctx->repeat, 0.5) / ((double)iters * N));           \
+  } while (0)
+
+  xora_simd_level_t hw = xora_simd_detect();
+  xora_simd_level_t was = xora_simd_level();
+  for (int lvl = XORA_SIMD_SCALAR; lvl <= (int)hw; ++lvl)
+  {
+    if (lvl == XORA_SIMD_SSE2)
+      continue; /* no SSE2 decoder */
+    xora_simd_set_level((xora_simd_level_t)lvl);
+    const char *name = xora_simd_level_name((xora_simd_level_t)lvl);
+    char kind[48];
+    snprintf(kind, sizeof(kind), "varnum_to_cents simd=%s", name);
+    BENCH_DEC_TIME(kind, bad += xora_varnum_to_cents_batch(vn, N, cents));
+    snprintf(kind, sizeof(kind), "varnum_to_cents_double simd=%s", name);
+    BENCH_DEC_TIME(kind, {
+      bad += xora_varnum_to_cents_batch(vn, N, cents);
+      xora_cents_to_double_batch(cents, N, dbl);
+    });
+  }
+  xora_simd_set_level(was);
+  BENCH_DEC_TIME("text_to_cents", bad += xora_dec_to_cents_batch(&txt[0][0], TXT, N, cents));
+  BENCH_DEC_TIME("float_widen", {
+    for (int i = 0; i < N; ++i)
+      dbl[i] = fl32[i];
+  });
+#undef BENCH_DEC_TIME
+
+  xora_free(t);
+  xora_free(vn);
+  xora_free(txt);
+  xora_free(fl32);
+  xora_free(cents);
+  xora_free(dbl);
+  return bad == 0 ? 0 : 1;
+}
+
+/*  mt: one connection per thread, per-handle status  */
+
+typedef struct BenchMtArg
+{
+  const bench_ctx_t *ctx;
+  pthread_barrier_t *go;
+  int id_lo, id_hi;
+  int ops;
+  int seed;
+  int connected;
+  long long hits, misses, errors, mismatches;
+} bench_mt_arg_t;
+
+/* Hits and misses interleave across threads: with one shared sqlca a miss on
+ * one session would show up as another session's status. */
+static void *bench_mt_worker(void *p)
+{
+  bench_mt_arg_t *a = (bench_mt_arg_t *)p;
+  xora_conn_t *h = bench_connect(a->ctx);
+  a->connected = (h != NULL);
+  pthread_barrier_wait(a->go);
+  if (!h)
+    return NULL;
+
+  unsigned x = (unsigned)a->seed * 2654435761u + 1u;
+  int span = a->id_hi - a->id_lo + 1;
+  for (int i = 0; i < a->ops; ++i)
+  {
+    x = x * 1103515245u + 12345u;
+    int miss = (x >> 16) % 4 == 0;
+    int id = miss ? -1 - (int)((x >> 8) % 1000000) : a->id_lo + (int)((x >> 4) % (unsigned)span);
+
+    xora_emp_row_t row;
+    int found = 0;
+    xora_err_t rc = xora_emp_get_by_id(h, id, &row, &found);
+    long code = xora_conn_sqlcode(h, NULL, 0);
+    if (rc == XORA_OK)
+    {
+      a->hits++;
+      a->mismatches += (code != 0 || miss);
+    }
+    else if (rc == XORA_NO_DATA_FOUND)
+    {
+      a->misses++;
+      a->mismatches += (code != 1403 && code != 100);
+    }
+    else
+    {
+      a->errors++;
+      a->mismatches += (code >= 0);
+    }
+  }
+
+  xora_conn_destroy(&h);
+  return NULL;
+}
+
+static int bench_mt(const bench_ctx_t *ctx)
+{
+  int id_lo = 1, id_hi = 1;
+  {
+    xora_conn_t *h = bench_connect(ctx);
+    if (!h)
+      return 1;
+    xora_err_t rc = xora_emp_id_bounds(h, &id_lo, &id_hi);
+    xora_conn_destroy(&h);
+    if (rc != XORA_OK)
+      return 1;
+  }
+
+  int per = ctx->calls / 10 > 100 ? ctx->calls / 10 : 100;
+  double base = 0.0;
+  long long bad = 0;
+  for (int nt = 1; nt <= ctx->threads; nt *= 2)
+  {
+    pthread_t *th = XORA_ALLOC_ARRAY(pthread_t, nt);
+    bench_mt_arg_t *args = XORA_CALLOC_ARRAY(bench_mt_arg_t, nt);
+    pthread_barrier_t go;
+    pthread_barrier_init(&go, NULL, (unsigned)nt + 1);
+
+    for (int i = 0; i < nt; ++i)
+    {
+      args[i].ctx = ctx;
+      args[i].go = &go;
+      args[i].id_lo = id_lo;
+      args[i].id_hi = id_hi;
+      args[i].ops = per;
+      args[i].seed = nt * 1000 + i;
+      pthread_create(&th[i], NULL, bench_mt_worker, &args[i]);
+    }
+    pthread_barrier_wait(&go); /* sessions are open; time the calls only */
+    uint64_t t0 = xora_stats_now_ns();
+    for (int i = 0; i < nt; ++i)
+      pthread_join(th[i], NULL);
+    uint64_t ns = xora_stats_now_ns() - t0;
+    pthread_barrier_destroy(&go);
+
+    long long hits = 0, misses = 0, errors = 0, mismatches = 0;
+    int sessions = 0;
+    for (int i = 0; i < nt; ++i)
+    {
+      sessions += args[i].connected;
+      hits += args[i].hits;
+      misses += args[i].misses;
+      errors += args[i].errors;
+      mismatches += args[i].mismatches;
+    }
+    long long nops = hits + misses + errors;
+    double ops_s = ns ? nops * 1e9 / ns : 0.0;
+    if (nt == 1)
+      base = ops_s;
+    printf("bench=mt op=get_by_id threads=%d sessions=%d ops=%lld ops_per_s=%.0f speedup=%.2f "
+           "hits=%lld misses=%lld errors=%lld status_mismatches=%lld\n",
+           nt, sessions, nops, ops_s, base > 0 ? ops_s / base : 0.0,
+           hits, misses, errors, mismatches);
+    bad += mismatches + (nt - sessions);
+
+    xora_free(args);
+    xora_free(th);
+  }
+  return bad == 0 ? 0 : 1;
+}
+
+/*  log: error storm through the ORA error path, synchronous vs. async  */
+
+#define BENCH_LOG_MSG "ORA-03113: end-of-file on communication channel\nProcess ID: 4711\nSession ID: 12 Serial number: 34\n"
+
+typedef struct BenchLogArg
+{
+  pthread_barrier_t *go;
+  int calls;
+  long long *lat; /* ns per call */
+  uint64_t ns;    /* barrier exit to end of the last call */
+} bench_log_arg_t;
+
+static void *bench_log_worker(void *p)
+{
+  bench_log_arg_t *a = (bench_log_arg_t *)p;
+  pthread_barrier_wait(a->go);
+  uint64_t start = xora_stats_now_ns();
+  uint64_t t1 = start;
+  for (int i = 0; i < a->calls; ++i)
+  {
+    uint64_t t0 = xora_stats_now_ns();
+    xora_log_ora(XORA_LOG_ERR, "FETCH employees cursor", -3113,
+                 BENCH_LOG_MSG, (int)sizeof(BENCH_LOG_MSG) - 1);
+    t1 = xora_stats_now_ns();
+    a->lat[i] = (long long)(t1 - t0);
+  }
+  a->ns = t1 - start;
+  return NULL;
+}
+
+static int bench_log(const bench_ctx_t *ctx)
+{
+  /* Unbuffered like stderr: every synchronous record is one write(2) */
+  FILE *sink = fopen("/dev/null", "w");
+  if (!sink)
+    return 1;
+  setvbuf(sink, NULL, _IONBF, 0);
+  xora_log_set_output(sink);
+
+  int per = ctx->calls;
+  int bad = 0;
+  for (int nt = 1; nt <= ctx->threads; nt *= 2)
+  {
+    long long *lat = XORA_ALLOC_ARRAY(long long, (size_t)nt * per);
+    pthread_t *th = XORA_ALLOC_ARRAY(pthread_t, nt);
+    bench_log_arg_t *args = XORA_CALLOC_ARRAY(bench_log_arg_t, nt);
+
+    for (int async = 0; async < 2; ++async)
+    {
+      xora_log_stats_t s0, s1;
+      if (async)
+      {
+        xora_log_config_t cfg;
+        xora_log_config_init(&cfg);
+        cfg.out = sink;
+        if (xora_log_start(&cfg) != XORA_OK)
+        {
+          bad++;
+          break;
+        }
+      }
+      xora_log_get_stats(&s0);
+
+      pthread_barrier_t go;
+      pthread_barrier_init(&go, NULL, (unsigned)nt + 1);
+      for (int i = 0; i < nt; ++i)
+      {
+        args[i].go = &go;
+        args[i].calls = per;
+        args[i].lat = lat + (size_t)i * per;
+        pthread_create(&th[i], NULL, bench_log_worker, &args[i]);
+      }
+      pthread_barrier_wait(&go);
+      /* Timed in the workers: with more threads than cores they can be done
+       * before this thread runs again after the barrier */
+      uint64_t ns = 0;
+      for (int i = 0; i < nt; ++i)
+      {
+        pthread_join(th[i], NULL);
+        if (args[i].ns > ns)
+          ns = args[i].ns;
+      }
+      pthread_barrier_destroy(&go);
+
+      if (async)
+        xora_log_stop(); /* writes out what is buffered */
+      xora_log_get_stats(&s1);
+
+      long long n = (long long)nt * per;
+      long long written = async ? s1.written - s0.written : s1.sync - s0.sync;
+      long long dropped = s1.dropped - s0.dropped;
+      int ok = written + dropped == n;
+      bad += !ok;
+      long long p99 = bench_pct(lat, (int)n, 0.99);
+      printf("bench=log mode=%s threads=%d records=%lld ns_per_call=%.1f p99_ns=%lld max_ns=%lld "
+             "written=%lld dropped=%lld ok=%d\n",
+             async ? "async" : "sync", nt, n, (double)ns * nt / n, p99, lat[n - 1],
+             written, dropped, ok);
+    }
+
+    xora_free(args);
+    xora_free(th);
+    xora_free(lat);
+  }
+
+  xora_log_set_output(NULL);
+  fclose(sink);
+  return bad == 0 ? 0 : 1;
+}
+
+#ifdef XORA_WITH_UV
+/*  async: requests in flight on a libuv loop vs. blocking calls  */
+
+typedef struct BenchAsync
+{
+  xora_uv_t *uv;
+  int inflight; /* kept outstanding */
+  int total;
+  int submitted;
+  int done;
+  int errors;
+  int id_lo, span;
+  unsigned x;
+
+  /* insert chain on a caller-held session */
+  xora_conn_t *pinned;
+  const xora_emp_row_t *rows;
+  int nrows, group, next_row, failed, finished;
+  int allow_commit;
+} bench_async_t;
+
+typedef struct BenchAsyncGet
+{
+  bench_async_t *b;
+  int empno;
+  int found;
+  xora_emp_row_t row;
+} bench_async_get_t;
+
+static void bench_async_next(bench_async_t *b);
+
+static xora_err_t bench_async_get_fn(xora_conn_t *h, void *arg)
+{
+  bench_async_get_t *g = (bench_async_get_t *)arg;
+  return xora_emp_get_by_id(h, g->empno, &g->row, &g->found);
+}
+
+static void bench_async_get_cb(void *ud, xora_err_t rc)
+{
+  bench_async_get_t *g = (bench_async_get_t *)ud;
+  bench_async_t *b = g->b;
+  b->done++;
+  if ((rc != XORA_OK && rc != XORA_NO_DATA_FOUND) || (g->found && g->row.empno != g->empno))
+    b->errors++;
+  xora_free(g);
+  bench_async_next(b);
+}
+
+/* Top the loop up to `inflight` outstanding requests */
+static void bench_async_next(bench_async_t *b)
+{
+  while (b->submitted < b->total && b->submitted - b->done < b->inflight)
+  {
+    bench_async_get_t *g = XORA_CALLOC_ARRAY(bench_async_get_t, 1);
+    g->b = b;
+    b->x = b->x * 1103515245u + 12345u;
+    g->empno = b->id_lo + (int)((b->x >> 4) % (unsigned)b->span);
+    b->submitted++;
+    if (xora_async_call(b->uv, NULL, bench_async_get_fn, g, bench_async_get_cb, g) != XORA_OK)
+    {
+      xora_free(g);
+      b->done++;
+      b->errors++;
+    }
+  }
+}
+
+static xora_err_t bench_async_rollback_fn(xora_conn_t *h, void *arg)
+{
+  (void)arg;
+  return xora_tx_rollback(h);
+}
+
+static void bench_async_end_cb(void *ud, xora_err_t rc)
+{
+  bench_async_t *b = (bench_async_t *)ud;
+  if (rc != XORA_OK)
+    b->errors++;
+  b->finished = 1;
+}
+
+/* One group at a time on the pinned session, then one COMMIT */
+static void bench_async_insert_cb(void *ud, xora_err_t rc)
+{
+  bench_async_t *b = (bench_async_t *)ud;
+  if (rc != XORA_OK)
+    b->failed++;
+  if (b->next_row < b->nrows)
+  {
+    int n = b->nrows - b->next_row < b->group ? b->nrows - b->next_row : b->group;
+    const xora_emp_row_t *r = b->rows + b->next_row;
+    b->next_row += n;
+    if (xora_async_insert(b->uv, b->pinned, r, n, NULL, bench_async_insert_cb, b) != XORA_OK)
+    {
+      b->errors++;
+      b->finished = 1;
+    }
+    return;
+  }
+  xora_err_t sub = b->allow_commit
+                       ? xora_async_commit(b->uv, b->pinned, bench_async_end_cb, b)
+                       : xora_async_call(b->uv, b->pinned, bench_async_rollback_fn, NULL, bench_async_end_cb, b);
+  if (sub != XORA_OK)
+  {
+    b->errors++;
+    b->finished = 1;
+  }
+}
+
+static int bench_async(const bench_ctx_t *ctx)
+{
+  static const int inflights[] = {1, 8, 64, 256};
+  int id_lo = 1, id_hi = 1;
+  xora_conn_t *h = bench_connect(ctx);
+  if (!h)
+    return 1;
+  if (xora_emp_id_bounds(h, &id_lo, &id_hi) != XORA_OK)
+  {
+    xora_conn_destroy(&h);
+    return 1;
+  }
+
+  int nops = ctx->calls / 4 > 100 ? ctx->calls / 4 : 100;
+  uint64_t t0 = xora_stats_now_ns();
+  unsigned x = 12345u;
+  for (int i = 0; i < nops; ++i)
+  {
+    x = x * 1103515245u + 12345u;
+    xora_emp_row_t row;
+    int found = 0;
+    xora_emp_get_by_id(h, id_lo + (int)((x >> 4) % (unsigned)(id_hi - id_lo + 1)), &row, &found);
+    bench_sink += found;
+  }
+  uint64_t ns = xora_stats_now_ns() - t0;
+  printf("bench=async mode=blocking op=get_by_id threads=1 ops=%d ops_per_s=%.0f\n",
+         nops, ns ? nops * 1e9 / ns : 0.0);
+
+  xora_pool_config_t pcfg;
+  xora_pool_config_init(&pcfg);
+  pcfg.min_size = ctx->threads;
+  pcfg.max_size = ctx->threads;
+  pcfg.validate_after_ms = -1;
+  pcfg.user = ctx->user;
+  pcfg.pass = ctx->pass;
+  pcfg.db = ctx->db;
+  xora_pool_t *pool = NULL;
+  if (xora_pool_create(&pool, &pcfg) != XORA_OK)
+  {
+    xora_conn_destroy(&h);
+    return 1;
+  }
+
+  uv_loop_t loop;
+  uv_loop_init(&loop);
+  xora_uv_config_t ucfg;
+  xora_uv_config_init(&ucfg);
+  ucfg.pool = pool;
+  ucfg.workers = ctx->threads;
+  xora_uv_t *uv = NULL;
+  if (xora_uv_create(&uv, &loop, &ucfg) != XORA_OK)
+  {
+    uv_loop_close(&loop);
+    xora_pool_destroy(&pool);
+    xora_conn_destroy(&h);
+    return 1;
+  }
+
+  int bad = 0;
+  bench_async_t b;
+  for (size_t k = 0; k < sizeof(inflights) / sizeof(inflights[0]); ++k)
+  {
+    memset(&b, 0, sizeof(b));
+    b.uv = uv;
+    b.inflight = inflights[k];
+    b.total = nops;
+    b.id_lo = id_lo;
+    b.span = id_hi - id_lo + 1;
+    b.x = 777u + (unsigned)k;
+
+    t0 = xora_stats_now_ns();
+    bench_async_next(&b);
+    while (b.done < b.total)
+      uv_run(&loop, UV_RUN_ONCE);
+    ns = xora_stats_now_ns() - t0;
+
+    xora_uv_stats_t us;
+    xora_uv_get_stats(uv, &us);
+    printf("bench=async mode=loop op=get_by_id inflight=%d workers=%d ops=%d ops_per_s=%.0f "
+           "max_pending=%d errors=%d\n",
+           b.inflight, ctx->threads, nops, ns ? nops * 1e9 / ns : 0.0, us.max_pending_seen, b.errors);
+    bad += b.errors;
+  }
+
+  /* whole table into columns, on a pooled session */
+  {
+    xora_emp_cols_t cols;
+    xora_emp_cols_init(&cols);
+    memset(&b, 0, sizeof(b));
+    t0 = xora_stats_now_ns();
+    if (xora_async_fetch(uv, NULL, &cols, NULL, bench_async_end_cb, &b) != XORA_OK)
+    {
+      b.errors++;
+      b.finished = 1;
+    }
+    while (!b.finished)
+      uv_run(&loop, UV_RUN_ONCE);
+    ns = xora_stats_now_ns() - t0;
+    printf("bench=async mode=fetch rows=%d ms=%.3f errors=%d\n", cols.count, bench_ms(ns), b.errors);
+    bad += b.errors;
+    xora_emp_cols_free(&cols);
+  }
+
+  /* groups on a caller-held session (MAX(id)+1 is safe: one writer), then
+   * COMMIT, or ROLLBACK unless --commit */
+  {
+    int n = ctx->inserts;
+    xora_emp_row_t *rows = XORA_ALLOC_ARRAY(xora_emp_row_t, n);
+    for (int i = 0; i < n; ++i)
+      bench_fill_row(&rows[i], i);
+    memset(&b, 0, sizeof(b));
+    b.uv = uv;
+    b.pinned = h;
+    b.rows = rows;
+    b.nrows = n;
+    b.group = 64;
+    b.allow_commit = ctx->allow_commit;
+    t0 = xora_stats_now_ns();
+    bench_async_insert_cb(&b, XORA_OK);
+    while (!b.finished)
+      uv_run(&loop, UV_RUN_ONCE);
+    ns = xora_stats_now_ns() - t0;
+    printf("bench=async mode=insert_pinned rows=%d group=%d failed_groups=%d %s ms=%.3f errors=%d\n",
+           n, b.group, b.failed, ctx->allow_commit ? "committed=1" : "rolled_back=1", bench_ms(ns), b.errors);
+    bad += b.errors + b.failed;
+    xora_free(rows);
+  }
+
+  xora_uv_destroy(&uv);
+  uv_run(&loop, UV_RUN_DEFAULT); /* closes the async handle */
+  uv_loop_close(&loop);
+  xora_pool_destroy(&pool);
+  xora_conn_destroy(&h);
+  return bad == 0 ? 0 : 1;
+}
+#endif
+
+/*  driver  */
+
+typedef struct BenchScenario
+{
+  const char *name;
+  int (*run)(const bench_ctx_t *ctx);
+} bench_scenario_t;
+
+static const bench_scenario_t bench_scenarios[] = {
+    {"fetch", bench_fetch},
+    {"copy", bench_copy},
+    {"insert", bench_insert},
+    {"pool", bench_pool},
+    {"scan", bench_scan},
+    {"stats", bench_stats},
+    {"arena", bench_arena},
+    {"cols", bench_cols},
+    {"utf8", bench_utf8},
+    {"decimal", bench_decimal},
+    {"mt", bench_mt},
+    {"log", bench_log},
+#ifdef XORA_WITH_UV
+    {"async", bench_async},
+#endif
+};
+#define BENCH_NSCENARIOS ((int)(sizeof(bench_scenarios) / sizeof(bench_scenarios[0])))
+
+int main(int argc, char **argv)
+{
+  bench_ctx_t ctx;
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.user = get_env_or("ORA_USER", "scott");
+  ctx.pass = get_env_or("ORA_PASS", "tiger");
+  ctx.db = get_env_or("ORA_DB", "//host.docker.internal:1521/FREEPDB1");
+  ctx.repeat = 3;
+  ctx.threads = 16;
+  ctx.fetch_rows = 50000;
+  ctx.inserts = 2000;
+  ctx.calls = 20000;
+  ctx.stats = 1;
+
+#ifdef XORA_BENCH_SIM
+  xora_sim_config_t sim;
+  xora_sim_config_init(&sim);
+  ctx.allow_commit = 1;
+#endif
+
+  int selected[BENCH_NSCENARIOS];
+  int nselected = 0;
+  memset(selected, 0, sizeof(selected));
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+#define BENCH_INT_OPT(flag, dst)  \
+  if (!strcmp(a, flag) && v)      \
+  {                               \
+    dst = atoi(v);                \
+    ++i;                          \
+    continue;                     \
+  }
+    BENCH_INT_OPT("--repeat", ctx.repeat)
+    BENCH_INT_OPT("--threads", ctx.threads)
+    BENCH_INT_OPT("--fetch-rows", ctx.fetch_rows)
+    BENCH_INT_OPT("--inserts", ctx.inserts)
+    BENCH_INT_OPT("--calls", ctx.calls)
+#ifdef XORA_BENCH_SIM
+    BENCH_INT_OPT("--rtt-us", sim.rtt_us)
+    BENCH_INT_OPT("--row-ns", sim.row_ns)
+    BENCH_INT_OPT("--connect-us", sim.connect_us)
+    BENCH_INT_OPT("--rows", sim.rows)
+    if (!strcmp(a, "--spin"))
+    {
+      sim.spin = 1;
+      continue;
+    }
+#else
+    if (!strcmp(a, "--user") && v)
+    {
+      ctx.user = argv[++i];
+      continue;
+    }
+    if (!strcmp(a, "--pass") && v)
+    {
+      ctx.pass = argv[++i];
+      continue;
+    }
+    if (!strcmp(a, "--db") && v)
+    {
+      ctx.db = argv[++i];
+      continue;
+    }
+#endif
+#undef BENCH_INT_OPT
+    if (!strcmp(a, "--no-stats"))
+    {
+      ctx.stats = 0;
+      continue;
+    }
+    if (!strcmp(a, "--commit"))
+    {
+      ctx.allow_commit = 1;
+      continue;
+    }
+
+    int found = 0;
+    for (int s = 0; s < BENCH_NSCENARIOS; ++s)
+      if (!strcmp(a, bench_scenarios[s].name))
+      {
+        selected[s] = 1;
+        nselected++;
+        found = 1;
+      }
+    if (!found)
+    {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (ctx.repeat < 1)
+    ctx.repeat = 1;
+  if (ctx.threads < 1)
+    ctx.threads = 1;
+  if (ctx.fetch_rows < 1)
+    ctx.fetch_rows = 1;
+  if (ctx.inserts < 1)
+    ctx.inserts = 1;
+  if (ctx.calls < 1)
+    ctx.calls = 1;
+
+#ifdef XORA_BENCH_SIM
+  xora_sim_configure(&sim);
+  printf("backend=sim rtt_us=%d row_ns=%d connect_us=%d rows=%d spin=%d\n",
+         sim.rtt_us, sim.row_ns, sim.connect_us, sim.rows, sim.spin);
+#else
+  printf("backend=oracle db=%s user=%s\n", ctx.db, ctx.user);
+#endif
+
+  xora_stats_enable(ctx.stats);
+
+  int rc = 0;
+  for (int s = 0; s < BENCH_NSCENARIOS; ++s)
+  {
+    if (nselected && !selected[s])
+      continue;
+    if (bench_scenarios[s].run(&ctx) != 0)
+    {
+      fprintf(stderr, "bench=%s failed (no session?)\n", bench_scenarios[s].name);
+      rc = 1;
+    }
+    fflush(stdout);
+  }
+  return rc;
+}
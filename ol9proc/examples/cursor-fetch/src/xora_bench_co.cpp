@@ -0,0 +1,303 @@
+/* xora_bench_co.cpp
+ *
+ * Coroutine query API (xora_co.hpp) vs. blocking threads. Built twice, like
+ * xora_bench: xora_bench_co against Oracle, xora_bench_co_sim against the
+ * simulated backend (XORA_BENCH_SIM, simulated latency kept).
+ *
+ * Modes:
+ *   flow     --flows get -> insert -> COMMIT flows. Blocking: --workers
+ *            threads, one session each, running flows back to back.
+ *            Coroutines: all flows spawned at once on an Executor with
+ *            --workers sessions. Inserted rows are counted back (sim).
+ *   scan     rows and checksum of a full scan through Conn::batches() vs.
+ *            the C cursor loop
+ *
+ * Against Oracle the flows roll back instead of committing unless --commit.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "xora_co.hpp"
+#include "xora_stats.h"
+#ifdef XORA_BENCH_SIM
+#include "xora_sim.h"
+#endif
+
+namespace
+{
+  struct Opts
+  {
+    const char *user;
+    const char *pass;
+    const char *db;
+    int flows = 2000;
+    int workers = 8;
+    int commit = 0;
+  };
+
+  xora_emp_row_t derive(const xora_emp_row_t &src)
+  {
+    xora_emp_row_t r = src;
+    r.salary = src.salary + 1.0;
+    return r;
+  }
+
+  /* Blocking: each thread owns a session and runs its share of the flows.
+   * Timed from when every session is open; *ns receives the elapsed time. */
+  int flow_blocking(const Opts &o, int id_base, std::atomic<long long> &done, uint64_t *ns)
+  {
+    std::atomic<int> next{0};
+    std::atomic<int> failed{0};
+    std::atomic<int> ready{0};
+    std::atomic<uint64_t> t0{0};
+    std::vector<std::thread> th;
+    for (int t = 0; t < o.workers; ++t)
+      th.emplace_back([&]
+                      {
+        try
+        {
+          xora::Connection c(o.user, o.pass, o.db);
+          if (ready.fetch_add(1) + 1 == o.workers)
+            t0.store(xora_stats_now_ns());
+          while (ready.load() < o.workers)
+            std::this_thread::yield();
+          for (int i; (i = next.fetch_add(1)) < o.flows;)
+          {
+            xora::Transaction tx(c);
+            std::optional<xora_emp_row_t> r = c.get_by_id(1 + i % 1000);
+            if (!r)
+              throw xora::Error(XORA_NO_DATA_FOUND, "missing source row");
+            c.create(derive(*r), id_base + i);
+            if (o.commit)
+              tx.commit();
+            else
+              tx.rollback();
+            done.fetch_add(1);
+          }
+        }
+        catch (const xora::Error &e)
+        {
+          fprintf(stderr, "bench=co blocking: %s\n", e.what());
+          failed.fetch_add(1);
+          ready.fetch_add(o.workers);
+        } });
+    for (std::thread &t : th)
+      t.join();
+    *ns = xora_stats_now_ns() - t0.load();
+    return failed.load();
+  }
+
+  xora::co::Task<void> one_flow(xora::co::Executor &ex, const Opts &o, int id, int src,
+                                std::atomic<long long> &done)
+  {
+    xora::co::Conn c = co_await ex.connect();
+    xora::co::Tx tx(c);
+    std::optional<xora_emp_row_t> r = co_await c.get_by_id(src);
+    if (!r)
+      throw xora::Error(XORA_NO_DATA_FOUND, "missing source row");
+    co_await c.create(derive(*r), id);
+    if (o.commit)
+      co_await tx.commit();
+    else
+      co_await tx.rollback();
+    done.fetch_add(1);
+  }
+
+  /* Coroutines: every flow spawned up front; timed once the Executor's
+   * sessions are open */
+  int flow_co(const Opts &o, int id_base, std::atomic<long long> &done, uint64_t *ns)
+  {
+    xora::co::Executor ex(o.user, o.pass, o.db, o.workers);
+    uint64_t t0 = xora_stats_now_ns();
+    for (int i = 0; i < o.flows; ++i)
+      ex.spawn(one_flow(ex, o, id_base + i, 1 + i % 1000, done));
+    ex.wait_idle();
+    *ns = xora_stats_now_ns() - t0;
+    return (int)ex.errors();
+  }
+
+  struct Scan
+  {
+    long long rows = 0;
+    long long checksum = 0;
+  };
+
+  Scan scan_c(xora_conn_t *h)
+  {
+    Scan s;
+    xora_emp_cursor_t *c = NULL;
+    if (xora_emp_cursor_open_ex(h, &c, NULL) != XORA_OK)
+      return s;
+    xora_emp_batch_view_t v;
+    while (xora_emp_cursor_next_batch(c, &v) == XORA_OK)
+    {
+      for (int i = 0; i < v.count; ++i)
+        s.checksum += v.empno[i] + v.salary_cents[i];
+      s.rows += v.count;
+    }
+    xora_emp_cursor_close(&c);
+    return s;
+  }
+
+  xora::co::Task<Scan> scan_gen(xora::co::Executor &ex)
+  {
+    Scan s;
+    xora::co::Conn c = co_await ex.connect();
+    xora::co::Generator<xora::Batch> g = c.batches();
+    while (const xora::Batch *b = co_await g.next())
+    {
+      for (xora::Row r : *b)
+        s.checksum += r.empno + r.salary_cents;
+      s.rows += (long long)b->size();
+    }
+    co_return s;
+  }
+
+  const char *get_env_or(const char *key, const char *defv)
+  {
+    const char *v = getenv(key);
+    return (v && *v) ? v : defv;
+  }
+
+  void usage(const char *prog)
+  {
+    fprintf(stderr,
+            "Usage: %s [options] [flow|scan ...]\n"
+            "  --flows N       get -> insert -> commit flows per mode (2000)\n"
+            "  --workers N     sessions / threads (8)\n"
+            "  --commit        commit the inserted rows (always on for the simulator)\n"
+#ifdef XORA_BENCH_SIM
+            "  --rtt-us N --row-ns N --rows N   simulated costs (env XORA_SIM_*)\n"
+#else
+            "  --user U --pass P --db //host:1521/SERVICE   (env ORA_USER, ORA_PASS, ORA_DB)\n"
+#endif
+            "No mode = all.\n",
+            prog);
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  Opts o;
+  o.user = get_env_or("ORA_USER", "scott");
+  o.pass = get_env_or("ORA_PASS", "tiger");
+  o.db = get_env_or("ORA_DB", "//host.docker.internal:1521/FREEPDB1");
+  int run_flow = 0, run_scan = 0;
+
+#ifdef XORA_BENCH_SIM
+  xora_sim_config_t sim;
+  xora_sim_config_init(&sim);
+  o.commit = 1;
+#endif
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (!strcmp(a, "--flows") && v)
+      o.flows = atoi(argv[++i]);
+    else if (!strcmp(a, "--workers") && v)
+      o.workers = atoi(argv[++i]);
+    else if (!strcmp(a, "--commit"))
+      o.commit = 1;
+    else if (!strcmp(a, "flow"))
+      run_flow = 1;
+    else if (!strcmp(a, "scan"))
+      run_scan = 1;
+#ifdef XORA_BENCH_SIM
+    else if (!strcmp(a, "--rtt-us") && v)
+      sim.rtt_us = atoi(argv[++i]);
+    else if (!strcmp(a, "--row-ns") && v)
+      sim.row_ns = atoi(argv[++i]);
+    else if (!strcmp(a, "--rows") && v)
+      sim.rows = atoi(argv[++i]);
+#else
+    else if (!strcmp(a, "--user") && v)
+      o.user = argv[++i];
+    else if (!strcmp(a, "--pass") && v)
+      o.pass = argv[++i];
+    else if (!strcmp(a, "--db") && v)
+      o.db = argv[++i];
+#endif
+    else
+    {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (!run_flow && !run_scan)
+    run_flow = run_scan = 1;
+  o.flows = std::max(o.flows, 1);
+  o.workers = std::max(o.workers, 1);
+
+#ifdef XORA_BENCH_SIM
+  xora_sim_configure(&sim);
+  printf("backend=sim rtt_us=%d row_ns=%d rows=%d\n", sim.rtt_us, sim.row_ns, sim.rows);
+#else
+  printf("backend=oracle db=%s user=%s\n", o.db, o.user);
+#endif
+  xora_stats_enable(0);
+
+  int rc = 0;
+  try
+  {
+    if (run_flow)
+    {
+      /* Fresh ids well above the seeded table for each mode */
+      int id_base = 50000000;
+      double ms[2] = {0, 0};
+      for (int mode = 0; mode < 2; ++mode, id_base += 10000000)
+      {
+        std::atomic<long long> done{0};
+#ifdef XORA_BENCH_SIM
+        int before = xora_sim_row_count();
+#endif
+        uint64_t ns = 0;
+        int failed = mode ? flow_co(o, id_base, done, &ns) : flow_blocking(o, id_base, done, &ns);
+        ms[mode] = (double)ns / 1e6;
+        long long inserted = -1;
+#ifdef XORA_BENCH_SIM
+        inserted = xora_sim_row_count() - before;
+#endif
+        int ok = !failed && done.load() == o.flows && (inserted < 0 || inserted == o.flows);
+        if (!ok)
+          rc = 1;
+        printf("bench=co op=flow mode=%s workers=%d flows=%d in_flight=%d ms=%.1f flows_per_s=%.0f inserted=%lld ok=%d\n",
+               mode ? "coroutine" : "blocking", o.workers, o.flows, mode ? o.flows : o.workers,
+               ms[mode], ms[mode] > 0 ? o.flows / (ms[mode] / 1e3) : 0.0, inserted, ok);
+      }
+      printf("bench=co op=flow coroutine_vs_blocking=%.2f\n", ms[1] > 0 ? ms[0] / ms[1] : 0.0);
+    }
+
+    if (run_scan)
+    {
+      Scan ref;
+      {
+        xora::Connection c(o.user, o.pass, o.db);
+        uint64_t t0 = xora_stats_now_ns();
+        ref = scan_c(c.get());
+        printf("bench=co op=scan mode=c rows=%lld ms=%.1f\n", ref.rows, (double)(xora_stats_now_ns() - t0) / 1e6);
+      }
+      xora::co::Executor ex(o.user, o.pass, o.db, 1);
+      uint64_t t0 = xora_stats_now_ns();
+      Scan s = ex.block_on(scan_gen(ex));
+      int ok = s.rows == ref.rows && s.checksum == ref.checksum && s.rows > 0;
+      if (!ok)
+        rc = 1;
+      printf("bench=co op=scan mode=generator rows=%lld ms=%.1f checksum_ok=%d\n",
+             s.rows, (double)(xora_stats_now_ns() - t0) / 1e6, ok);
+    }
+  }
+  catch (const xora::Error &e)
+  {
+    fprintf(stderr, "bench=co failed: %s\n", e.what());
+    return 1;
+  }
+  return rc;
+}
@@ -0,0 +1,227 @@
+/* xora_bench_cpp.cpp
+ *
+ * Cost of the C++ layer (xora.hpp) over the C cursor API. Built twice, like
+ * xora_bench: xora_bench_cpp against Oracle, xora_bench_cpp_sim against the
+ * simulated backend (XORA_BENCH_SIM, latency set to 0 so only the client
+ * path is measured).
+ *
+ * Modes, each a full ORDER BY id scan reducing every row to the same
+ * checksum (empno + salary_cents + ename length + NULL count):
+ *   c        xora_emp_cursor_next_batch loop over the view's arrays
+ *   batches  range-for over xora::Cursor, spans of each batch
+ *   rows     range-for over xora::Cursor, then over each batch's Row views
+ *
+ * Output is one key=value line per mode; times are the median of --repeat
+ * runs. checksum_ok compares against the C loop.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "xora.hpp"
+#include "xora_stats.h"
+#ifdef XORA_BENCH_SIM
+#include "xora_sim.h"
+#endif
+
+namespace
+{
+  struct Scan
+  {
+    long long rows = 0;
+    long long checksum = 0;
+  };
+
+  Scan scan_c(xora_conn_t *h, const xora_fetch_opts_t *opts)
+  {
+    Scan s;
+    xora_emp_cursor_t *c = NULL;
+    if (xora_emp_cursor_open_ex(h, &c, opts) != XORA_OK)
+      return s;
+    xora_emp_batch_view_t v;
+    while (xora_emp_cursor_next_batch(c, &v) == XORA_OK)
+    {
+      for (int i = 0; i < v.count; ++i)
+      {
+        s.checksum += v.empno[i] + v.salary_cents[i];
+        if (v.ename_ind[i] < 0)
+          s.checksum += 1;
+        else
+        {
+          const void *nul = memchr(v.ename[i], '\0', sizeof(v.ename[i]));
+          s.checksum += nul ? (const char *)nul - v.ename[i] : (long long)sizeof(v.ename[i]);
+        }
+      }
+      s.rows += v.count;
+    }
+    xora_emp_cursor_close(&c);
+    return s;
+  }
+
+  Scan scan_batches(xora::Connection &conn, const xora_fetch_opts_t *opts)
+  {
+    Scan s;
+    for (const xora::Batch &b : conn.cursor(opts))
+    {
+      for (int e : b.empno())
+        s.checksum += e;
+      for (int64_t cents : b.salary_cents())
+        s.checksum += cents;
+      for (std::size_t i = 0; i < b.size(); ++i)
+        s.checksum += b.ename_is_null(i) ? 1 : (long long)b.ename(i).size();
+      s.rows += (long long)b.size();
+    }
+    return s;
+  }
+
+  Scan scan_rows(xora::Connection &conn, const xora_fetch_opts_t *opts)
+  {
+    Scan s;
+    for (const xora::Batch &b : conn.cursor(opts))
+      for (xora::Row r : b)
+      {
+        s.checksum += r.empno + r.salary_cents + (r.ename_is_null ? 1 : (long long)r.ename.size());
+        ++s.rows;
+      }
+    return s;
+  }
+
+  const char *get_env_or(const char *key, const char *defv)
+  {
+    const char *v = getenv(key);
+    return (v && *v) ? v : defv;
+  }
+
+  void usage(const char *prog)
+  {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --repeat N      runs per mode, median reported (5)\n"
+            "  --batch N       rows per array fetch (fetch opts default)\n"
+#ifdef XORA_BENCH_SIM
+            "  --rows N        simulated table size (env XORA_SIM_ROWS)\n"
+#else
+            "  --user U --pass P --db //host:1521/SERVICE   (env ORA_USER, ORA_PASS, ORA_DB)\n"
+#endif
+            ,
+            prog);
+  }
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const char *user = get_env_or("ORA_USER", "scott");
+  const char *pass = get_env_or("ORA_PASS", "tiger");
+  const char *db = get_env_or("ORA_DB", "//host.docker.internal:1521/FREEPDB1");
+  int repeat = 5;
+  int batch = 0;
+
+#ifdef XORA_BENCH_SIM
+  xora_sim_config_t sim;
+  xora_sim_config_init(&sim);
+#endif
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+    if (!strcmp(a, "--repeat") && v)
+      repeat = atoi(argv[++i]);
+    else if (!strcmp(a, "--batch") && v)
+      batch = atoi(argv[++i]);
+#ifdef XORA_BENCH_SIM
+    else if (!strcmp(a, "--rows") && v)
+      sim.rows = atoi(argv[++i]);
+#else
+    else if (!strcmp(a, "--user") && v)
+      user = argv[++i];
+    else if (!strcmp(a, "--pass") && v)
+      pass = argv[++i];
+    else if (!strcmp(a, "--db") && v)
+      db = argv[++i];
+#endif
+    else
+    {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (repeat < 1)
+    repeat = 1;
+
+#ifdef XORA_BENCH_SIM
+  xora_sim_configure(&sim);
+  xora_sim_set_latency(0, 0);
+  printf("backend=sim rows=%d rtt_us=0 row_ns=0\n", sim.rows);
+#else
+  printf("backend=oracle db=%s user=%s\n", db, user);
+#endif
+  xora_stats_enable(0);
+
+  xora_fetch_opts_t opts;
+  xora_fetch_opts_init(&opts);
+  if (batch > 0)
+    opts.batch_size = batch;
+
+  try
+  {
+    xora::Connection conn(user, pass, db);
+
+    enum
+    {
+      MODE_C,
+      MODE_BATCHES,
+      MODE_ROWS,
+      MODE_N
+    };
+    static const char *const names[MODE_N] = {"c", "batches", "rows"};
+    std::vector<long long> t((std::size_t)repeat);
+    double ns_per_row[MODE_N] = {0, 0, 0};
+    Scan ref;
+    int rc = 0;
+
+    for (int m = 0; m < MODE_N; ++m)
+    {
+      Scan s;
+      for (int r = 0; r < repeat; ++r)
+      {
+        uint64_t t0 = xora_stats_now_ns();
+        switch (m)
+        {
+        case MODE_C:
+          s = scan_c(conn.get(), &opts);
+          break;
+        case MODE_BATCHES:
+          s = scan_batches(conn, &opts);
+          break;
+        default:
+          s = scan_rows(conn, &opts);
+          break;
+        }
+        t[(std::size_t)r] = (long long)(xora_stats_now_ns() - t0);
+      }
+      std::sort(t.begin(), t.end());
+      long long med = t[(std::size_t)(repeat - 1) / 2];
+      if (m == MODE_C)
+        ref = s;
+      int ok = s.rows == ref.rows && s.checksum == ref.checksum;
+      if (!ok || s.rows == 0)
+        rc = 1;
+      ns_per_row[m] = s.rows ? (double)med / (double)s.rows : 0.0;
+      printf("bench=cpp mode=%s batch=%d rows=%lld ms=%.3f ns_per_row=%.2f checksum_ok=%d\n",
+             names[m], opts.batch_size, s.rows, (double)med / 1e6, ns_per_row[m], ok);
+    }
+    printf("bench=cpp overhead_pct_batches=%.2f overhead_pct_rows=%.2f\n",
+           ns_per_row[MODE_C] > 0 ? 100.0 * (ns_per_row[MODE_BATCHES] - ns_per_row[MODE_C]) / ns_per_row[MODE_C] : 0.0,
+           ns_per_row[MODE_C] > 0 ? 100.0 * (ns_per_row[MODE_ROWS] - ns_per_row[MODE_C]) / ns_per_row[MODE_C] : 0.0);
+    return rc;
+  }
+  catch (const xora::Error &e)
+  {
+    fprintf(stderr, "bench=cpp failed: %s\n", e.what());
+    return 1;
+  }
+}
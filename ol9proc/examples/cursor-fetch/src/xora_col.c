@@ -0,0 +1,531 @@
+/* xora_col.c
+ *
+ * Column kernels (scalar + AVX2).
+ * Notes:
+ *  - AVX2 bodies carry target("avx2,popcnt"), so the file builds without
+ *    -mavx2 and the binary still runs on CPUs without it.
+ *  - Integer sums are exact, so their lane count is free (plain 64-bit adds).
+ *  - Sums of doubles keep 16 lanes (four ymm accumulators on AVX2, a 16-slot
+ *    array in scalar code); each lane sees the same additions in the same
+ *    order on both paths and the lanes are folded pairwise at the end.
+ *  - Filters compress with a 256-entry permutation table: the 8-bit match
+ *    mask of 8 candidates selects the permute that packs their indexes to the
+ *    front, one unaligned store writes them, popcount advances the output.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "xora_simd.h"
+#include "xora_col.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define XORA__COL_X86 1
+#include <immintrin.h>
+#define XORA__AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+
+#define XORA__LANES 16
+
+#ifdef XORA__COL_X86
+#define XORA__DISPATCH(name, ...)              \
+  if (xora_simd_level() >= XORA_SIMD_AVX2)     \
+    return xora__##name##_avx2(__VA_ARGS__);   \
+  return xora__##name##_scalar(__VA_ARGS__)
+#else
+#define XORA__DISPATCH(name, ...) return xora__##name##_scalar(__VA_ARGS__)
+#endif
+
+static double xora__fold_lanes(double *l)
+{
+  for (int w = XORA__LANES / 2; w; w >>= 1)
+    for (int j = 0; j < w; ++j)
+      l[j] += l[j + w];
+  return l[0];
+}
+
+/*  scalar  */
+
+static double xora__sum_f64_scalar(const double *v, size_t n)
+{
+  double l[XORA__LANES] = {0};
+  size_t i = 0;
+  for (; i + XORA__LANES <= n; i += XORA__LANES)
+    for (int j = 0; j < XORA__LANES; ++j)
+      l[j] += v[i + j];
+  for (size_t j = 0; i + j < n; ++j)
+    l[j] += v[i + j];
+  return xora__fold_lanes(l);
+}
+
+static double xora__sum_f64_sel_scalar(const double *v, const uint32_t *sel, size_t n)
+{
+  double l[XORA__LANES] = {0};
+  size_t i = 0;
+  for (; i + XORA__LANES <= n; i += XORA__LANES)
+    for (int j = 0; j < XORA__LANES; ++j)
+      l[j] += v[sel[i + j]];
+  for (size_t j = 0; i + j < n; ++j)
+    l[j] += v[sel[i + j]];
+  return xora__fold_lanes(l);
+}
+
+static int64_t xora__sum_i32_scalar(const int *v, size_t n)
+{
+  int64_t s = 0;
+  for (size_t i = 0; i < n; ++i)
+    s += v[i];
+  return s;
+}
+
+static int64_t xora__sum_i64_scalar(const int64_t *v, size_t n)
+{
+  int64_t s = 0;
+  for (size_t i = 0; i < n; ++i)
+    s += v[i];
+  return s;
+}
+
+static int64_t xora__sum_i64_sel_scalar(const int64_t *v, const uint32_t *sel, size_t n)
+{
+  int64_t s = 0;
+  for (size_t i = 0; i < n; ++i)
+    s += v[sel[i]];
+  return s;
+}
+
+static int xora__minmax_f64_scalar(const double *v, size_t n, double *out_min, double *out_max)
+{
+  double mn = v[0], mx = v[0];
+  for (size_t i = 1; i < n; ++i)
+  {
+    mn = v[i] < mn ? v[i] : mn;
+    mx = v[i] > mx ? v[i] : mx;
+  }
+  *out_min = mn;
+  *out_max = mx;
+  return 1;
+}
+
+static int xora__minmax_f64_sel_scalar(const double *v, const uint32_t *sel, size_t n,
+                                       double *out_min, double *out_max)
+{
+  double mn = v[sel[0]], mx = mn;
+  for (size_t i = 1; i < n; ++i)
+  {
+    double x = v[sel[i]];
+    mn = x < mn ? x : mn;
+    mx = x > mx ? x : mx;
+  }
+  *out_min = mn;
+  *out_max = mx;
+  return 1;
+}
+
+static int xora__minmax_i32_scalar(const int *v, size_t n, int *out_min, int *out_max)
+{
+  int mn = v[0], mx = v[0];
+  for (size_t i = 1; i < n; ++i)
+  {
+    mn = v[i] < mn ? v[i] : mn;
+    mx = v[i] > mx ? v[i] : mx;
+  }
+  *out_min = mn;
+  *out_max = mx;
+  return 1;
+}
+
+static size_t xora__count_range_f64_scalar(const double *v, size_t n, double lo, double hi)
+{
+  size_t c = 0;
+  for (size_t i = 0; i < n; ++i)
+    c += (v[i] >= lo) & (v[i] <= hi);
+  return c;
+}
+
+static size_t xora__count_range_i32_scalar(const int *v, size_t n, int lo, int hi)
+{
+  size_t c = 0;
+  for (size_t i = 0; i < n; ++i)
+    c += (v[i] >= lo) & (v[i] <= hi);
+  return c;
+}
+
+static size_t xora__filter_range_f64_scalar(const double *v, size_t n, double lo, double hi,
+                                            uint32_t *sel)
+{
+  size_t k = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    sel[k] = (uint32_t)i; /* branch-free: always write, advance on match */
+    k += (v[i] >= lo) & (v[i] <= hi);
+  }
+  return k;
+}
+
+static size_t xora__filter_range_i32_scalar(const int *v, size_t n, int lo, int hi, uint32_t *sel)
+{
+  size_t k = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    sel[k] = (uint32_t)i;
+    k += (v[i] >= lo) & (v[i] <= hi);
+  }
+  return k;
+}
+
+/*  AVX2  */
+
+#ifdef XORA__COL_X86
+
+static uint32_t xora__compress_lut[256][8];
+static pthread_once_t xora__lut_once = PTHREAD_ONCE_INIT;
+
+static void xora__lut_init(void)
+{
+  for (int m = 0; m < 256; ++m)
+  {
+    int k = 0;
+    for (int b = 0; b < 8; ++b)
+      if (m & (1 << b))
+        xora__compress_lut[m][k++] = (uint32_t)b;
+  }
+}
+
+XORA__AVX2 static double xora__sum_f64_avx2(const double *v, size_t n)
+{
+  __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for (; i + XORA__LANES <= n; i += XORA__LANES)
+  {
+    a0 = _mm256_add_pd(a0, _mm256_loadu_pd(v + i));
+    a1 = _mm256_add_pd(a1, _mm256_loadu_pd(v + i + 4));
+    a2 = _mm256_add_pd(a2, _mm256_loadu_pd(v + i + 8));
+    a3 = _mm256_add_pd(a3, _mm256_loadu_pd(v + i + 12));
+  }
+  double l[XORA__LANES];
+  _mm256_storeu_pd(l, a0);
+  _mm256_storeu_pd(l + 4, a1);
+  _mm256_storeu_pd(l + 8, a2);
+  _mm256_storeu_pd(l + 12, a3);
+  for (size_t j = 0; i + j < n; ++j)
+    l[j] += v[i + j];
+  return xora__fold_lanes(l);
+}
+
+XORA__AVX2 static double xora__sum_f64_sel_avx2(const double *v, const uint32_t *sel, size_t n)
+{
+  __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+  size_t i = 0;
+  for (; i + XORA__LANES <= n; i += XORA__LANES)
+  {
+    const __m128i *s = (const __m128i *)(sel + i);
+    a0 = _mm256_add_pd(a0, _mm256_i32gather_pd(v, _mm_loadu_si128(s), 8));
+    a1 = _mm256_add_pd(a1, _mm256_i32gather_pd(v, _mm_loadu_si128(s + 1), 8));
+    a2 = _mm256_add_pd(a2, _mm256_i32gather_pd(v, _mm_loadu_si128(s + 2), 8));
+    a3 = _mm256_add_pd(a3, _mm256_i32gather_pd(v, _mm_loadu_si128(s + 3), 8));
+  }
+  double l[XORA__LANES];
+  _mm256_storeu_pd(l, a0);
+  _mm256_storeu_pd(l + 4, a1);
+  _mm256_storeu_pd(l + 8, a2);
+  _mm256_storeu_pd(l + 12, a3);
+  for (size_t j = 0; i + j < n; ++j)
+    l[j] += v[sel[i + j]];
+  return xora__fold_lanes(l);
+}
+
+XORA__AVX2 static int64_t xora__sum_i32_avx2(const int *v, size_t n)
+{
+  __m256i a0 = _mm256_setzero_si256(), a1 = a0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    a0 = _mm256_add_epi64(a0, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(v + i))));
+    a1 = _mm256_add_epi64(a1, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(v + i + 4))));
+  }
+  int64_t l[4];
+  _mm256_storeu_si256((__m256i *)l, _mm256_add_epi64(a0, a1));
+  int64_t s = l[0] + l[1] + l[2] + l[3];
+  for (; i < n; ++i)
+    s += v[i];
+  return s;
+}
+
+XORA__AVX2 static int64_t xora__sum_i64_avx2(const int64_t *v, size_t n)
+{
+  __m256i a0 = _mm256_setzero_si256(), a1 = a0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    a0 = _mm256_add_epi64(a0, _mm256_loadu_si256((const __m256i *)(v + i)));
+    a1 = _mm256_add_epi64(a1, _mm256_loadu_si256((const __m256i *)(v + i + 4)));
+  }
+  int64_t l[4];
+  _mm256_storeu_si256((__m256i *)l, _mm256_add_epi64(a0, a1));
+  int64_t s = l[0] + l[1] + l[2] + l[3];
+  for (; i < n; ++i)
+    s += v[i];
+  return s;
+}
+
+XORA__AVX2 static int64_t xora__sum_i64_sel_avx2(const int64_t *v, const uint32_t *sel, size_t n)
+{
+  __m256i a0 = _mm256_setzero_si256(), a1 = a0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m128i *s = (const __m128i *)(sel + i);
+    a0 = _mm256_add_epi64(a0, _mm256_i32gather_epi64((const long long *)v, _mm_loadu_si128(s), 8));
+    a1 = _mm256_add_epi64(a1, _mm256_i32gather_epi64((const long long *)v, _mm_loadu_si128(s + 1), 8));
+  }
+  int64_t l[4];
+  _mm256_storeu_si256((__m256i *)l, _mm256_add_epi64(a0, a1));
+  int64_t s = l[0] + l[1] + l[2] + l[3];
+  for (; i < n; ++i)
+    s += v[sel[i]];
+  return s;
+}
+
+XORA__AVX2 static int xora__minmax_f64_avx2(const double *v, size_t n, double *out_min, double *out_max)
+{
+  __m256d mn = _mm256_set1_pd(v[0]), mx = mn, mn1 = mn, mx1 = mn;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256d x0 = _mm256_loadu_pd(v + i), x1 = _mm256_loadu_pd(v + i + 4);
+    mn = _mm256_min_pd(mn, x0);
+    mx = _mm256_max_pd(mx, x0);
+    mn1 = _mm256_min_pd(mn1, x1);
+    mx1 = _mm256_max_pd(mx1, x1);
+  }
+  double a[4], b[4];
+  _mm256_storeu_pd(a, _mm256_min_pd(mn, mn1));
+  _mm256_storeu_pd(b, _mm256_max_pd(mx, mx1));
+  double lo = a[0], hi = b[0];
+  for (int j = 1; j < 4; ++j)
+  {
+    lo = a[j] < lo ? a[j] : lo;
+    hi = b[j] > hi ? b[j] : hi;
+  }
+  for (; i < n; ++i)
+  {
+    lo = v[i] < lo ? v[i] : lo;
+    hi = v[i] > hi ? v[i] : hi;
+  }
+  *out_min = lo;
+  *out_max = hi;
+  return 1;
+}
+
+XORA__AVX2 static int xora__minmax_f64_sel_avx2(const double *v, const uint32_t *sel, size_t n,
+                                                double *out_min, double *out_max)
+{
+  __m256d mn = _mm256_set1_pd(v[sel[0]]), mx = mn;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m256d x = _mm256_i32gather_pd(v, _mm_loadu_si128((const __m128i *)(sel + i)), 8);
+    mn = _mm256_min_pd(mn, x);
+    mx = _mm256_max_pd(mx, x);
+  }
+  double a[4], b[4];
+  _mm256_storeu_pd(a, mn);
+  _mm256_storeu_pd(b, mx);
+  double lo = a[0], hi = b[0];
+  for (int j = 1; j < 4; ++j)
+  {
+    lo = a[j] < lo ? a[j] : lo;
+    hi = b[j] > hi ? b[j] : hi;
+  }
+  for (; i < n; ++i)
+  {
+    double x = v[sel[i]];
+    lo = x < lo ? x : lo;
+    hi = x > hi ? x : hi;
+  }
+  *out_min = lo;
+  *out_max = hi;
+  return 1;
+}
+
+XORA__AVX2 static int xora__minmax_i32_avx2(const int *v, size_t n, int *out_min, int *out_max)
+{
+  __m256i mn = _mm256_set1_epi32(v[0]), mx = mn;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(v + i));
+    mn = _mm256_min_epi32(mn, x);
+    mx = _mm256_max_epi32(mx, x);
+  }
+  int a[8], b[8];
+  _mm256_storeu_si256((__m256i *)a, mn);
+  _mm256_storeu_si256((__m256i *)b, mx);
+  int lo = a[0], hi = b[0];
+  for (int j = 1; j < 8; ++j)
+  {
+    lo = a[j] < lo ? a[j] : lo;
+    hi = b[j] > hi ? b[j] : hi;
+  }
+  for (; i < n; ++i)
+  {
+    lo = v[i] < lo ? v[i] : lo;
+    hi = v[i] > hi ? v[i] : hi;
+  }
+  *out_min = lo;
+  *out_max = hi;
+  return 1;
+}
+
+/* 4-bit mask of lo <= x <= hi */
+XORA__AVX2 static inline unsigned xora__in_range_pd(__m256d x, __m256d lo, __m256d hi)
+{
+  __m256d ok = _mm256_and_pd(_mm256_cmp_pd(x, lo, _CMP_GE_OQ), _mm256_cmp_pd(x, hi, _CMP_LE_OQ));
+  return (unsigned)_mm256_movemask_pd(ok);
+}
+
+/* 8-bit mask of lo <= x <= hi */
+XORA__AVX2 static inline unsigned xora__in_range_epi32(__m256i x, __m256i lo, __m256i hi)
+{
+  __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(lo, x), _mm256_cmpgt_epi32(x, hi));
+  return ~(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(out)) & 0xffu;
+}
+
+XORA__AVX2 static size_t xora__count_range_f64_avx2(const double *v, size_t n, double lo, double hi)
+{
+  __m256d vlo = _mm256_set1_pd(lo), vhi = _mm256_set1_pd(hi);
+  size_t c = 0, i = 0;
+  for (; i + 8 <= n; i += 8)
+    c += (size_t)__builtin_popcount(xora__in_range_pd(_mm256_loadu_pd(v + i), vlo, vhi) |
+                                    xora__in_range_pd(_mm256_loadu_pd(v + i + 4), vlo, vhi) << 4);
+  return c + xora__count_range_f64_scalar(v + i, n - i, lo, hi);
+}
+
+XORA__AVX2 static size_t xora__count_range_i32_avx2(const int *v, size_t n, int lo, int hi)
+{
+  __m256i vlo = _mm256_set1_epi32(lo), vhi = _mm256_set1_epi32(hi);
+  size_t c = 0, i = 0;
+  for (; i + 8 <= n; i += 8)
+    c += (size_t)__builtin_popcount(
+        xora__in_range_epi32(_mm256_loadu_si256((const __m256i *)(v + i)), vlo, vhi));
+  return c + xora__count_range_i32_scalar(v + i, n - i, lo, hi);
+}
+
+XORA__AVX2 static size_t xora__filter_range_f64_avx2(const double *v, size_t n, double lo, double hi,
+                                                     uint32_t *sel)
+{
+  pthread_once(&xora__lut_once, xora__lut_init);
+  __m256d vlo = _mm256_set1_pd(lo), vhi = _mm256_set1_pd(hi);
+  const __m256i iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  size_t k = 0, i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    unsigned m = xora__in_range_pd(_mm256_loadu_pd(v + i), vlo, vhi) |
+                 xora__in_range_pd(_mm256_loadu_pd(v + i + 4), vlo, vhi) << 4;
+    __m256i idx = _mm256_add_epi32(_mm256_set1_epi32((int)(uint32_t)i), iota);
+    __m256i perm = _mm256_loadu_si256((const __m256i *)xora__compress_lut[m]);
+    _mm256_storeu_si256((__m256i *)(sel + k), _mm256_permutevar8x32_epi32(idx, perm));
+    k += (size_t)__builtin_popcount(m);
+  }
+  for (; i < n; ++i)
+  {
+    sel[k] = (uint32_t)i;
+    k += (v[i] >= lo) & (v[i] <= hi);
+  }
+  return k;
+}
+
+XORA__AVX2 static size_t xora__filter_range_i32_avx2(const int *v, size_t n, int lo, int hi, uint32_t *sel)
+{
+  pthread_once(&xora__lut_once, xora__lut_init);
+  __m256i vlo = _mm256_set1_epi32(lo), vhi = _mm256_set1_epi32(hi);
+  const __m256i iota = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  size_t k = 0, i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    unsigned m = xora__in_range_epi32(_mm256_loadu_si256((const __m256i *)(v + i)), vlo, vhi);
+    __m256i idx = _mm256_add_epi32(_mm256_set1_epi32((int)(uint32_t)i), iota);
+    __m256i perm = _mm256_loadu_si256((const __m256i *)xora__compress_lut[m]);
+    _mm256_storeu_si256((__m256i *)(sel + k), _mm256_permutevar8x32_epi32(idx, perm));
+    k += (size_t)__builtin_popcount(m);
+  }
+  for (; i < n; ++i)
+  {
+    sel[k] = (uint32_t)i;
+    k += (v[i] >= lo) & (v[i] <= hi);
+  }
+  return k;
+}
+
+#endif /* XORA__COL_X86 */
+
+/*  public API  */
+
+double xora_col_sum_f64(const double *v, size_t n)
+{
+  XORA__DISPATCH(sum_f64, v, n);
+}
+
+int64_t xora_col_sum_i32(const int *v, size_t n)
+{
+  XORA__DISPATCH(sum_i32, v, n);
+}
+
+int64_t xora_col_sum_i64(const int64_t *v, size_t n)
+{
+  XORA__DISPATCH(sum_i64, v, n);
+}
+
+int xora_col_minmax_f64(const double *v, size_t n, double *out_min, double *out_max)
+{
+  if (n == 0)
+    return 0;
+  XORA__DISPATCH(minmax_f64, v, n, out_min, out_max);
+}
+
+int xora_col_minmax_i32(const int *v, size_t n, int *out_min, int *out_max)
+{
+  if (n == 0)
+    return 0;
+  XORA__DISPATCH(minmax_i32, v, n, out_min, out_max);
+}
+
+size_t xora_col_count_range_f64(const double *v, size_t n, double lo, double hi)
+{
+  XORA__DISPATCH(count_range_f64, v, n, lo, hi);
+}
+
+size_t xora_col_count_range_i32(const int *v, size_t n, int lo, int hi)
+{
+  XORA__DISPATCH(count_range_i32, v, n, lo, hi);
+}
+
+size_t xora_col_filter_range_f64(const double *v, size_t n, double lo, double hi, uint32_t *sel)
+{
+  XORA__DISPATCH(filter_range_f64, v, n, lo, hi, sel);
+}
+
+size_t xora_col_filter_range_i32(const int *v, size_t n, int lo, int hi, uint32_t *sel)
+{
+  XORA__DISPATCH(filter_range_i32, v, n, lo, hi, sel);
+}
+
+double xora_col_sum_f64_sel(const double *v, const uint32_t *sel, size_t nsel)
+{
+  XORA__DISPATCH(sum_f64_sel, v, sel, nsel);
+}
+
+int64_t xora_col_sum_i64_sel(const int64_t *v, const uint32_t *sel, size_t nsel)
+{
+  XORA__DISPATCH(sum_i64_sel, v, sel, nsel);
+}
+
+int xora_col_minmax_f64_sel(const double *v, const uint32_t *sel, size_t nsel,
+                            double *out_min, double *out_max)
+{
+  if (nsel == 0)
+    return 0;
+  XORA__DISPATCH(minmax_f64_sel, v, sel, nsel, out_min, out_max);
+}
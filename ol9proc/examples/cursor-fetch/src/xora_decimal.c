@@ -0,0 +1,289 @@
+/* xora_decimal.c
+ *
+ * Oracle NUMBER / decimal text <-> scaled int64 cents.
+ * Notes:
+ *  - cents = sum d[k] * 100^(e+1-k): the digits at k <= e+1 are whole cents,
+ *    the one at k = e+2 decides the rounding, anything after it is noise.
+ *  - The sign is folded into digit = sgn * byte + off, so positive and
+ *    negative values share one path; digit validity is OR-ed into a flag
+ *    and checked once per value.
+ *  - Scalar: Horner over the stored digits (NUMBER drops trailing zeros),
+ *    then one multiply by a power of 100.
+ *  - AVX2 (128-bit ops): one 16-byte load of the digits, pshufb aligns them
+ *    on the units-of-cents slot by exponent, maddubs/madd fold base 100 into
+ *    base 10^4 and 10^8, three lanes finish in scalar. No data-dependent
+ *    loop; host elements are XORA_VARNUM_SIZE bytes, so the load is in bounds.
+ *  - Magnitudes are bounded at 10^18 cents on both sides (e <= 7), so the
+ *    uint64 accumulator never overflows and every value round-trips.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xora_simd.h"
+#include "xora_decimal.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define XORA__DEC_X86 1
+#include <immintrin.h>
+#endif
+
+#define XORA__DEC_MAX_CENTS 1000000000000000000ull
+
+#define XORA__DEC_SLOTS 9 /* whole-cent digits at e = 7 */
+
+static const uint64_t xora__pow100[XORA__DEC_SLOTS + 1] = {
+    1ull, 100ull, 10000ull, 1000000ull, 100000000ull, 10000000000ull,
+    1000000000000ull, 100000000000000ull, 10000000000000000ull, 1000000000000000000ull};
+
+#ifdef XORA__DEC_X86
+/* Row s moves digit k to slot k + s and zero-fills the front (pshufb) */
+static const uint8_t xora__dec_shuf[XORA__DEC_SLOTS + 2][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {0x80, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14},
+    {0x80, 0x80, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13},
+    {0x80, 0x80, 0x80, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12},
+    {0x80, 0x80, 0x80, 0x80, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
+    {0x80, 0x80, 0x80, 0x80, 0x80, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10},
+    {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+    {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 1, 2, 3, 4, 5, 6, 7, 8},
+    {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 1, 2, 3, 4, 5, 6, 7},
+    {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 1, 2, 3, 4, 5, 6},
+    {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 1, 2, 3, 4, 5},
+};
+#endif
+
+/* Header of a finite non-zero value; 0 ok, 1 exact zero/underflow (*out set),
+ * -1 malformed/infinity/overflow */
+static inline int xora__varnum_head(const unsigned char *vn, int *neg, int *e, int *nd, int64_t *out)
+{
+  unsigned len = vn[0], x = vn[1];
+  if (len - 2u > XORA_VARNUM_SIZE - 3u)
+  {
+    *out = 0;
+    return (len == 1 && x == 0x80) ? 1 : -1; /* zero; [1][0x00] is -infinity */
+  }
+  *neg = !(x & 0x80);
+  *e = *neg ? 62 - (int)x : (int)x - 193;
+  *nd = (int)len - 1 - (*neg & (vn[len] == 102));
+  if (*e > 7 || x == 0xFF || *nd <= 0)
+    return -1; /* overflow, +infinity */
+  if (*e < -2)
+  {
+    *out = 0;
+    return 1;
+  }
+  return 0;
+}
+
+static inline int xora__varnum_decode_scalar(const unsigned char *vn, int64_t *out)
+{
+  int neg, e, nd;
+  int h = xora__varnum_head(vn, &neg, &e, &nd, out);
+  if (h)
+    return h > 0 ? 0 : -1;
+
+  /* digit = sgn * byte + off: byte - 1 positive, 101 - byte negative */
+  const unsigned char *p = vn + 2;
+  int sgn = neg ? -1 : 1, off = neg ? 101 : -1;
+  int whole = e + 2;
+  int m = nd < whole ? nd : whole;
+  uint64_t acc = 0;
+  unsigned bad = 0;
+  for (int k = 0; k < m; ++k)
+  {
+    unsigned d = (unsigned)(sgn * p[k] + off);
+    bad |= d > 99u;
+    acc = acc * 100u + d;
+  }
+  acc *= xora__pow100[whole - m];
+  unsigned r = (unsigned)(sgn * p[whole] + off);
+  unsigned rlive = whole < nd;
+  bad |= rlive & (r > 99u);
+  acc += rlive & (r >= 50u);
+  *out = neg ? -(int64_t)acc : (int64_t)acc;
+  return bad ? -1 : 0;
+}
+
+#ifdef XORA__DEC_X86
+/* Slot layout after the shuffle: slot 0 is zero, slots 1..9 the whole-cent
+ * digits (slot 9 = units of cents), slot 10 the rounding digit. */
+__attribute__((target("avx2"))) static inline int xora__varnum_decode_avx2(const unsigned char *vn, int64_t *out)
+{
+  int neg, e, nd;
+  int h = xora__varnum_head(vn, &neg, &e, &nd, out);
+  if (h)
+    return h > 0 ? 0 : -1;
+
+  const __m128i iota = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  __m128i raw = _mm_loadu_si128((const __m128i *)(vn + 2)); /* bytes 2..17 of 22 */
+  /* positive: byte - 1; negative: 101 - byte == (byte ^ 0xFF) + 102 (mod 256) */
+  __m128i d = _mm_add_epi8(_mm_xor_si128(raw, _mm_set1_epi8((char)(neg ? 0xFF : 0))),
+                           _mm_set1_epi8((char)(neg ? 102 : 0xFF)));
+  d = _mm_and_si128(d, _mm_cmpgt_epi8(_mm_set1_epi8((char)nd), iota));
+  d = _mm_shuffle_epi8(d, _mm_loadu_si128((const __m128i *)xora__dec_shuf[XORA__DEC_SLOTS - 1 - e]));
+
+  /* slots 0..10 must be 0..99 */
+  __m128i keep = _mm_cmpgt_epi8(_mm_set1_epi8(11), iota);
+  __m128i chk = _mm_and_si128(d, keep);
+  int bad = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chk, _mm_set1_epi8(99)), _mm_set1_epi8(99))) != 0xFFFF;
+
+  /* base 100 -> 10^4 (pairs) -> 10^8 (quads) */
+  __m128i p2 = _mm_maddubs_epi16(d, _mm_setr_epi8(100, 1, 100, 1, 100, 1, 100, 1, 100, 1, 0, 0, 0, 0, 0, 0));
+  __m128i p4 = _mm_madd_epi16(p2, _mm_setr_epi16(10000, 1, 10000, 1, 1, 0, 0, 0));
+  uint64_t hi = (uint32_t)_mm_cvtsi128_si32(p4);                     /* slots 0..3 */
+  uint64_t mid = (uint32_t)_mm_extract_epi32(p4, 1);                 /* slots 4..7 */
+  uint64_t lo = (uint32_t)_mm_extract_epi32(p4, 2);                  /* slots 8..9 */
+  unsigned r = (unsigned)_mm_extract_epi8(d, XORA__DEC_SLOTS + 1);   /* slot 10 */
+  uint64_t acc = hi * 1000000000000ull + mid * 10000u + lo + (r >= 50u);
+
+  *out = neg ? -(int64_t)acc : (int64_t)acc;
+  return bad ? -1 : 0;
+}
+#endif
+
+/* Batch bodies: one per ISA so the decode inlines into the loop */
+#define XORA__VARNUM_BATCH(decode)                  \
+  int fails = 0;                                    \
+  for (int i = 0; i < n; ++i)                       \
+  {                                                 \
+    if (decode(vn[i], &out[i]) != 0)                \
+    {                                               \
+      out[i] = 0;                                   \
+      ++fails;                                      \
+    }                                               \
+  }                                                 \
+  return fails
+
+static int xora__varnum_batch_scalar(const xora_varnum_t *vn, int n, int64_t *out)
+{
+  XORA__VARNUM_BATCH(xora__varnum_decode_scalar);
+}
+
+#ifdef XORA__DEC_X86
+__attribute__((target("avx2"))) static int xora__varnum_batch_avx2(const xora_varnum_t *vn, int n, int64_t *out)
+{
+  XORA__VARNUM_BATCH(xora__varnum_decode_avx2);
+}
+#endif
+
+int xora_varnum_to_cents(const unsigned char *vn, int64_t *out)
+{
+  if (!vn)
+    return -1;
+  /* a batch of one keeps each decoder inlined in exactly one loop */
+  return xora_varnum_to_cents_batch((const xora_varnum_t *)vn, 1, out) ? -1 : 0;
+}
+
+int xora_varnum_to_cents_batch(const xora_varnum_t *vn, int n, int64_t *out)
+{
+#ifdef XORA__DEC_X86
+  if (xora_simd_level() >= XORA_SIMD_AVX2)
+    return xora__varnum_batch_avx2(vn, n, out);
+#endif
+  return xora__varnum_batch_scalar(vn, n, out);
+}
+
+int xora_varnum_from_cents(int64_t cents, unsigned char *vn)
+{
+  if (cents == 0)
+  {
+    vn[0] = 1;
+    vn[1] = 0x80;
+    return 0;
+  }
+  int neg = cents < 0;
+  uint64_t u = neg ? 0u - (uint64_t)cents : (uint64_t)cents;
+  if (u >= XORA__DEC_MAX_CENTS)
+    return -1;
+
+  unsigned char dig[XORA__DEC_SLOTS + 1];
+  int m = 0;
+  while (u)
+  {
+    dig[m++] = (unsigned char)(u % 100u); /* least significant first */
+    u /= 100u;
+  }
+  int lo = 0;
+  while (dig[lo] == 0)
+    ++lo;
+
+  int e = m - 2; /* dig[j] weighs 100^(j-1) in the value */
+  int n = 0;
+  for (int j = m - 1; j >= lo; --j)
+    vn[2 + n++] = neg ? (unsigned char)(101 - dig[j]) : (unsigned char)(dig[j] + 1);
+  vn[1] = neg ? (unsigned char)(62 - e) : (unsigned char)(193 + e);
+  if (neg)
+    vn[2 + n++] = 102;
+  vn[0] = (unsigned char)(n + 1);
+  return 0;
+}
+
+int xora_dec_to_cents(const char *s, size_t len, int64_t *out)
+{
+  if (!s)
+    return -1;
+  size_t i = 0;
+  while (i < len && s[i] == ' ')
+    ++i;
+  while (len > i && (s[len - 1] == ' ' || s[len - 1] == '\0'))
+    --len;
+
+  int neg = 0;
+  if (i < len && (s[i] == '-' || s[i] == '+'))
+    neg = s[i++] == '-';
+
+  uint64_t u = 0;
+  int digits = 0, whole = 0;
+  while (i < len && s[i] == '0')
+    ++i, ++digits;
+  for (; i < len && s[i] >= '0' && s[i] <= '9'; ++i, ++digits)
+  {
+    if (++whole > 16)
+      return -1;
+    u = u * 10u + (unsigned)(s[i] - '0');
+  }
+
+  unsigned frac[3] = {0, 0, 0};
+  if (i < len && s[i] == '.')
+  {
+    ++i;
+    for (int k = 0; i < len && s[i] >= '0' && s[i] <= '9'; ++i, ++k, ++digits)
+      if (k < 3)
+        frac[k] = (unsigned)(s[i] - '0');
+  }
+  if (i != len || digits == 0)
+    return -1;
+
+  u = u * 100u + frac[0] * 10u + frac[1] + (frac[2] >= 5u);
+  *out = neg ? -(int64_t)u : (int64_t)u;
+  return 0;
+}
+
+int xora_dec_to_cents_batch(const char *base, size_t stride, int n, int64_t *out)
+{
+  int fails = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    const char *s = base + (size_t)i * stride;
+    if (xora_dec_to_cents(s, strnlen(s, stride), &out[i]) != 0)
+    {
+      out[i] = 0;
+      ++fails;
+    }
+  }
+  return fails;
+}
+
+void xora_cents_to_double_batch(const int64_t *cents, int n, double *out)
+{
+  for (int i = 0; i < n; ++i)
+    out[i] = (double)cents[i] / 100.0;
+}
+
+int xora_cents_format(int64_t cents, char *buf, size_t size)
+{
+  uint64_t u = cents < 0 ? 0u - (uint64_t)cents : (uint64_t)cents;
+  return snprintf(buf, size, "%s%llu.%02llu", cents < 0 ? "-" : "",
+                  (unsigned long long)(u / 100u), (unsigned long long)(u % 100u));
+}
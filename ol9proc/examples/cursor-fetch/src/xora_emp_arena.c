@@ -0,0 +1,78 @@
+/* xora_emp_arena.c
+ *
+ * Result sets allocated from an arena.
+ * Notes:
+ *  - Same copy loop as xora_emp_fetch_vect_ex, but the row array is the
+ *    arena's most recent block, so growing it is usually a bump of the chunk
+ *    offset instead of realloc + copy, and dropping it is part of the
+ *    caller's arena reset.
+ */
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_utf8.h"
+#include "xora_contex.h"
+#include "xora_proc_emp.h"
+#include "xora_proc_emp_fetch.h"
+
+xora_err_t xora_emp_fetch_arena(xora_conn_t *h,
+                                xora_arena_t *arena,
+                                xora_emp_row_t **out_rows,
+                                int *out_count,
+                                int reserve_hint,
+                                const xora_fetch_opts_t *opts)
+{
+  if (!h || !arena || !out_rows || !out_count)
+    return XORA_ERR;
+  *out_rows = NULL;
+  *out_count = 0;
+
+  xora_emp_cursor_t *cur = NULL;
+  if (xora_emp_cursor_open_ex(h, &cur, opts) != XORA_OK)
+    return XORA_ERR;
+
+  xora_arena_mark_t mark = xora_arena_mark(arena);
+  int cap = reserve_hint > 0 ? reserve_hint : xora_emp_cursor_batch_size(cur);
+  int n = 0;
+  xora_emp_row_t *rows = XORA_ARENA_ALLOC_ARRAY(arena, xora_emp_row_t, cap);
+
+  xora_emp_batch_view_t v;
+  xora_err_t rc;
+  while ((rc = xora_emp_cursor_next_batch(cur, &v)) == XORA_OK)
+  {
+    if (n + v.count > cap)
+    {
+      int ncap = cap * 2 > n + v.count ? cap * 2 : n + v.count;
+      rows = (xora_emp_row_t *)xora_arena_realloc(arena, rows,
+                                                  xora_size_mul(cap, sizeof(*rows)),
+                                                  xora_size_mul(ncap, sizeof(*rows)));
+      cap = ncap;
+    }
+
+    for (int i = 0; i < v.count; ++i)
+    {
+      xora_emp_row_t *o = &rows[n + i];
+      o->empno = v.empno[i];
+      o->salary = v.salary[i];
+      o->ename_is_null = (v.ename_ind[i] < 0);
+      xora_utf8_copy_bounded(o->ename, v.ename[i], sizeof(o->ename));
+    }
+    n += v.count;
+  }
+
+  xora_emp_cursor_close(&cur);
+
+  if (rc != XORA_NO_DATA_FOUND)
+  {
+    xora_arena_rewind(arena, mark);
+    return XORA_ERR;
+  }
+
+  /* give back the unused tail (in place: rows is still the last block) */
+  rows = (xora_emp_row_t *)xora_arena_realloc(arena, rows,
+                                              xora_size_mul(cap, sizeof(*rows)),
+                                              xora_size_mul(n, sizeof(*rows)));
+  *out_rows = rows;
+  *out_count = n;
+  return XORA_OK;
+}
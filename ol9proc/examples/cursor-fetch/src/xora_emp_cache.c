@@ -0,0 +1,498 @@
+/* xora_emp_cache.c
+ *
+ * Sharded row cache implementation.
+ * Notes:
+ *  - Entry slots double as the CLOCK ring; the hand sweeps slots, clearing
+ *    reference bits, and takes the first free, expired or unreferenced one.
+ *  - The index maps hash position -> slot (-1 = empty). Deletes shift the
+ *    following run back instead of leaving tombstones, so probe length does
+ *    not degrade under churn.
+ *  - Each shard is allocated separately to keep hot shard locks off shared
+ *    cache lines.
+ *  - Fill vs invalidate race: invalidate bumps the shard generation; a fill
+ *    whose generation (read before the database round trip) is stale is dropped.
+ *    Writers invalidate after COMMIT/ROLLBACK (xora_emp_dirty_flush), so a
+ *    reader that saw the old row before the commit cannot re-cache it after.
+ *  - The dirty set is per session and single-threaded: no lock. It uses
+ *    INT_MIN as the empty marker (not a valid id).
+ */
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_proc_emp.h"
+#include "xora_emp_cache.h"
+
+typedef struct XoraCacheEntry
+{
+  int empno;
+  unsigned home; /* index position the key hashes to */
+  unsigned char used;
+  unsigned char ref; /* CLOCK reference bit */
+  long long expires_us; /* 0 = never */
+  xora_emp_row_t row;
+} xora__cache_entry_t;
+
+typedef struct XoraCacheShard
+{
+  pthread_mutex_t mu;
+  atomic_uint gen;
+
+  int cap;
+  int size;
+  int hand;
+  xora__cache_entry_t *ent;
+  int *idx;
+  unsigned mask;
+
+  long long hits, misses, evictions, expirations, invalidations, inserts;
+} xora__cache_shard_t;
+
+struct xora_emp_cache
+{
+  int nshards;
+  int shard_bits;
+  long long ttl_us;
+  xora__cache_shard_t **shards;
+};
+
+static _Atomic(xora_emp_cache_t *) xora__cache_global = NULL;
+
+/*  internals  */
+
+static long long xora__cache_now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static uint64_t xora__cache_hash(int empno)
+{
+  uint64_t x = (uint64_t)(uint32_t)empno * 0x9E3779B97F4A7C15ull;
+  return x ^ (x >> 29);
+}
+
+static xora__cache_shard_t *xora__cache_shard(xora_emp_cache_t *c, uint64_t h)
+{
+  return c->shards[h & (uint64_t)(c->nshards - 1)];
+}
+
+static unsigned xora__cache_home(const xora_emp_cache_t *c, const xora__cache_shard_t *sh, uint64_t h)
+{
+  return (unsigned)(h >> c->shard_bits) & sh->mask;
+}
+
+/* Slot holding empno, or -1; *pos gets its index position */
+static int xora__cache_find(xora__cache_shard_t *sh, int empno, unsigned home, unsigned *pos)
+{
+  for (unsigned i = home;; i = (i + 1) & sh->mask)
+  {
+    int s = sh->idx[i];
+    if (s < 0)
+      return -1;
+    if (sh->ent[s].empno == empno)
+    {
+      *pos = i;
+      return s;
+    }
+  }
+}
+
+/* Backward-shift delete at index position pos, and free the slot */
+static void xora__cache_remove(xora__cache_shard_t *sh, unsigned pos)
+{
+  int slot = sh->idx[pos];
+  unsigned i = pos;
+  unsigned j = pos;
+  for (;;)
+  {
+    j = (j + 1) & sh->mask;
+    int s = sh->idx[j];
+    if (s < 0)
+      break;
+    unsigned home = sh->ent[s].home;
+    /* move s back unless its home lies cyclically in (i, j] */
+    if (((j - home) & sh->mask) >= ((j - i) & sh->mask))
+    {
+      sh->idx[i] = s;
+      i = j;
+    }
+  }
+  sh->idx[i] = -1;
+
+  sh->ent[slot].used = 0;
+  sh->size--;
+}
+
+static void xora__cache_remove_slot(xora__cache_shard_t *sh, int slot)
+{
+  unsigned pos = 0;
+  if (xora__cache_find(sh, sh->ent[slot].empno, sh->ent[slot].home, &pos) == slot)
+    xora__cache_remove(sh, pos);
+}
+
+/* CLOCK sweep for a free slot; evicts one entry when the shard is full */
+static int xora__cache_victim(xora__cache_shard_t *sh, long long now)
+{
+  for (;;)
+  {
+    int s = sh->hand;
+    sh->hand = (sh->hand + 1) % sh->cap;
+    xora__cache_entry_t *e = &sh->ent[s];
+
+    if (!e->used)
+      return s;
+    if (sh->size < sh->cap)
+      continue; /* a free slot is further along; do not age entries for nothing */
+    if (e->expires_us && e->expires_us <= now)
+    {
+      xora__cache_remove_slot(sh, s);
+      sh->expirations++;
+      return s;
+    }
+    if (e->ref)
+    {
+      e->ref = 0;
+      continue;
+    }
+    xora__cache_remove_slot(sh, s);
+    sh->evictions++;
+    return s;
+  }
+}
+
+/*  public API  */
+
+void xora_emp_cache_config_init(xora_emp_cache_config_t *cfg)
+{
+  if (!cfg)
+    return;
+  cfg->capacity = 4096;
+  cfg->nshards = 16;
+  cfg->ttl_ms = 30000;
+}
+
+xora_err_t xora_emp_cache_create(xora_emp_cache_t **out, const xora_emp_cache_config_t *cfg)
+{
+  if (!out || *out)
+    return XORA_ALREADY_ALLOCATED;
+
+  xora_emp_cache_config_t defaults;
+  if (!cfg)
+  {
+    xora_emp_cache_config_init(&defaults);
+    cfg = &defaults;
+  }
+
+  int capacity = cfg->capacity > 0 ? cfg->capacity : 4096;
+  int nshards = 1;
+  int bits = 0;
+  while (nshards < (cfg->nshards > 0 ? cfg->nshards : 16) && nshards < 1024)
+  {
+    nshards <<= 1;
+    bits++;
+  }
+
+  xora_emp_cache_t *c = (xora_emp_cache_t *)xora_calloc(1, sizeof(*c));
+  c->nshards = nshards;
+  c->shard_bits = bits;
+  c->ttl_us = cfg->ttl_ms > 0 ? (long long)cfg->ttl_ms * 1000LL : 0;
+  c->shards = XORA_CALLOC_ARRAY(xora__cache_shard_t *, nshards);
+
+  int per = (capacity + nshards - 1) / nshards;
+  unsigned isz = 16;
+  while (isz < (unsigned)per * 2)
+    isz <<= 1;
+
+  for (int i = 0; i < nshards; ++i)
+  {
+    xora__cache_shard_t *sh = (xora__cache_shard_t *)xora_calloc(1, sizeof(*sh));
+    pthread_mutex_init(&sh->mu, NULL);
+    atomic_init(&sh->gen, 0);
+    sh->cap = per;
+    sh->ent = XORA_CALLOC_ARRAY(xora__cache_entry_t, per);
+    sh->idx = XORA_ALLOC_ARRAY(int, isz);
+    memset(sh->idx, 0xFF, sizeof(int) * isz); /* -1 */
+    sh->mask = isz - 1;
+    c->shards[i] = sh;
+  }
+
+  *out = c;
+  return XORA_OK;
+}
+
+xora_err_t xora_emp_cache_lookup(xora_emp_cache_t *c, int empno, xora_emp_row_t *out)
+{
+  if (!c || !out)
+    return XORA_ERR;
+
+  uint64_t h = xora__cache_hash(empno);
+  xora__cache_shard_t *sh = xora__cache_shard(c, h);
+  xora_err_t rc = XORA_NO_DATA_FOUND;
+
+  pthread_mutex_lock(&sh->mu);
+  unsigned pos = 0;
+  int s = xora__cache_find(sh, empno, xora__cache_home(c, sh, h), &pos);
+  if (s >= 0)
+  {
+    xora__cache_entry_t *e = &sh->ent[s];
+    if (e->expires_us && e->expires_us <= xora__cache_now_us())
+    {
+      xora__cache_remove(sh, pos);
+      sh->expirations++;
+    }
+    else
+    {
+      e->ref = 1;
+      *out = e->row;
+      rc = XORA_OK;
+    }
+  }
+  if (rc == XORA_OK)
+    sh->hits++;
+  else
+    sh->misses++;
+  pthread_mutex_unlock(&sh->mu);
+  return rc;
+}
+
+unsigned xora_emp_cache_gen(xora_emp_cache_t *c, int empno)
+{
+  if (!c)
+    return 0;
+  return atomic_load(&xora__cache_shard(c, xora__cache_hash(empno))->gen);
+}
+
+void xora_emp_cache_fill(xora_emp_cache_t *c, const xora_emp_row_t *row, unsigned gen)
+{
+  if (!c || !row)
+    return;
+
+  uint64_t h = xora__cache_hash(row->empno);
+  xora__cache_shard_t *sh = xora__cache_shard(c, h);
+  unsigned home = xora__cache_home(c, sh, h);
+  long long now = xora__cache_now_us();
+
+  pthread_mutex_lock(&sh->mu);
+  if (atomic_load(&sh->gen) != gen)
+  {
+    /* an update/delete ran while this row was being read */
+    pthread_mutex_unlock(&sh->mu);
+    return;
+  }
+
+  unsigned pos = 0;
+  int s = xora__cache_find(sh, row->empno, home, &pos);
+  if (s < 0)
+  {
+    s = xora__cache_victim(sh, now);
+    unsigned i = home;
+    while (sh->idx[i] >= 0)
+      i = (i + 1) & sh->mask;
+    sh->idx[i] = s;
+    sh->size++;
+    sh->inserts++;
+  }
+
+  xora__cache_entry_t *e = &sh->ent[s];
+  e->empno = row->empno;
+  e->home = home;
+  e->used = 1;
+  e->ref = 1;
+  e->expires_us = c->ttl_us ? now + c->ttl_us : 0;
+  e->row = *row;
+  pthread_mutex_unlock(&sh->mu);
+}
+
+void xora_emp_cache_invalidate(xora_emp_cache_t *c, int empno)
+{
+  if (!c)
+    return;
+
+  uint64_t h = xora__cache_hash(empno);
+  xora__cache_shard_t *sh = xora__cache_shard(c, h);
+
+  pthread_mutex_lock(&sh->mu);
+  atomic_fetch_add(&sh->gen, 1);
+  unsigned pos = 0;
+  if (xora__cache_find(sh, empno, xora__cache_home(c, sh, h), &pos) >= 0)
+  {
+    xora__cache_remove(sh, pos);
+    sh->invalidations++;
+  }
+  pthread_mutex_unlock(&sh->mu);
+}
+
+void xora_emp_cache_clear(xora_emp_cache_t *c)
+{
+  if (!c)
+    return;
+  for (int i = 0; i < c->nshards; ++i)
+  {
+    xora__cache_shard_t *sh = c->shards[i];
+    pthread_mutex_lock(&sh->mu);
+    atomic_fetch_add(&sh->gen, 1);
+    sh->invalidations += sh->size;
+    memset(sh->idx, 0xFF, sizeof(int) * (sh->mask + 1));
+    memset(sh->ent, 0, sizeof(*sh->ent) * (size_t)sh->cap);
+    sh->size = 0;
+    sh->hand = 0;
+    pthread_mutex_unlock(&sh->mu);
+  }
+}
+
+void xora_emp_cache_get_stats(xora_emp_cache_t *c, xora_emp_cache_stats_t *out)
+{
+  if (!out)
+    return;
+  memset(out, 0, sizeof(*out));
+  if (!c)
+    return;
+
+  for (int i = 0; i < c->nshards; ++i)
+  {
+    xora__cache_shard_t *sh = c->shards[i];
+    pthread_mutex_lock(&sh->mu);
+    out->hits += sh->hits;
+    out->misses += sh->misses;
+    out->evictions += sh->evictions;
+    out->expirations += sh->expirations;
+    out->invalidations += sh->invalidations;
+    out->inserts += sh->inserts;
+    out->size += sh->size;
+    out->capacity += sh->cap;
+    pthread_mutex_unlock(&sh->mu);
+  }
+}
+
+static unsigned xora__dirty_pos(const xora_emp_dirty_t *d, int empno)
+{
+  return (unsigned)(xora__cache_hash(empno) >> 32) & (d->cap - 1);
+}
+
+static void xora__dirty_put(xora_emp_dirty_t *d, int empno)
+{
+  unsigned i = xora__dirty_pos(d, empno);
+  while (d->slots[i] != INT_MIN)
+  {
+    if (d->slots[i] == empno)
+      return;
+    i = (i + 1) & (d->cap - 1);
+  }
+  d->slots[i] = empno;
+  d->n++;
+}
+
+void xora_emp_dirty_add(xora_emp_dirty_t *d, int empno)
+{
+  if (!d || d->all)
+    return;
+  if (empno == INT_MIN || d->n >= XORA_EMP_DIRTY_MAX)
+  {
+    d->all = 1;
+    return;
+  }
+
+  /* keep the load under one half */
+  if ((unsigned)(d->n + 1) * 2 > d->cap)
+  {
+    unsigned old_cap = d->cap;
+    int *old = d->slots;
+    d->cap = old_cap ? old_cap * 2 : 64;
+    d->slots = XORA_ALLOC_ARRAY(int, d->cap);
+    for (unsigned i = 0; i < d->cap; ++i)
+      d->slots[i] = INT_MIN;
+    d->n = 0;
+    for (unsigned i = 0; i < old_cap; ++i)
+      if (old[i] != INT_MIN)
+        xora__dirty_put(d, old[i]);
+    xora_free(old);
+  }
+  xora__dirty_put(d, empno);
+}
+
+int xora_emp_dirty_has(const xora_emp_dirty_t *d, int empno)
+{
+  if (!d)
+    return 0;
+  if (d->all)
+    return 1;
+  if (d->n == 0)
+    return 0;
+  for (unsigned i = xora__dirty_pos(d, empno); d->slots[i] != INT_MIN; i = (i + 1) & (d->cap - 1))
+  {
+    if (d->slots[i] == empno)
+      return 1;
+  }
+  return 0;
+}
+
+void xora_emp_dirty_flush(xora_emp_dirty_t *d, xora_emp_cache_t *c)
+{
+  if (!d || (d->n == 0 && !d->all))
+    return;
+
+  if (d->all)
+    xora_emp_cache_clear(c);
+  for (unsigned i = 0; d->n > 0 && i < d->cap; ++i)
+  {
+    if (d->slots[i] == INT_MIN)
+      continue;
+    if (!d->all)
+      xora_emp_cache_invalidate(c, d->slots[i]);
+    d->slots[i] = INT_MIN;
+    d->n--;
+  }
+  d->n = 0;
+  d->all = 0;
+}
+
+void xora_emp_dirty_free(xora_emp_dirty_t *d)
+{
+  if (!d)
+    return;
+  xora_free(d->slots);
+  d->cap = 0;
+  d->n = 0;
+  d->all = 0;
+}
+
+void xora_emp_cache_install(xora_emp_cache_t *c)
+{
+  atomic_store(&xora__cache_global, c);
+}
+
+xora_emp_cache_t *xora_emp_cache_installed(void)
+{
+  return atomic_load_explicit(&xora__cache_global, memory_order_acquire);
+}
+
+void xora_emp_cache_destroy(xora_emp_cache_t **cp)
+{
+  if (!cp || !*cp)
+    return;
+  xora_emp_cache_t *c = *cp;
+
+  /* never leave a dangling global */
+  xora_emp_cache_t *expected = c;
+  atomic_compare_exchange_strong(&xora__cache_global, &expected, NULL);
+
+  for (int i = 0; i < c->nshards; ++i)
+  {
+    xora__cache_shard_t *sh = c->shards[i];
+    pthread_mutex_destroy(&sh->mu);
+    xora_free(sh->ent);
+    xora_free(sh->idx);
+    xora_free(sh);
+  }
+  xora_free(c->shards);
+  xora_free(c);
+  *cp = NULL;
+}
@@ -0,0 +1,228 @@
+/* xora_emp_cols.c
+ *
+ * Columnar employee result sets.
+ * Notes:
+ *  - Appending is column at a time: empno and the salary columns are one
+ *    memcpy each (views without cents get them from the doubles), the NULL bits are built from the indicator array, names are
+ *    measured once and packed into the blob.
+ *  - The id filter yields a selection vector; a gap-free selection (the
+ *    usual case, rows arrive ORDER BY id) is aggregated as a contiguous slice
+ *    with no gather. Salary totals are integer cent sums, exact either way.
+ */
+
+#include <string.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_col.h"
+#include "xora_decimal.h"
+#include "xora_emp_cols.h"
+
+#define XORA__NAME_MAX ((size_t)sizeof(((xora_emp_batch_view_t *)0)->ename[0]) - 1)
+
+void xora_emp_cols_init(xora_emp_cols_t *c)
+{
+  memset(c, 0, sizeof(*c));
+}
+
+void xora_emp_cols_free(xora_emp_cols_t *c)
+{
+  if (!c)
+    return;
+  xora_free(c->empno);
+  xora_free(c->salary);
+  xora_free(c->salary_cents);
+  xora_free(c->ename_null);
+  xora_free(c->ename_off);
+  xora_free(c->ename_bytes);
+  xora_emp_cols_init(c);
+}
+
+void xora_emp_cols_clear(xora_emp_cols_t *c)
+{
+  if (c->ename_null)
+    memset(c->ename_null, 0, sizeof(uint64_t) * (size_t)((c->cap + 63) / 64));
+  c->count = 0;
+  c->bytes_len = 0;
+  if (c->ename_off)
+    c->ename_off[0] = 0;
+}
+
+static void xora__cols_grow_rows(xora_emp_cols_t *c, int need)
+{
+  int ncap = c->cap ? c->cap : 1024;
+  while (ncap < need)
+    ncap *= 2;
+
+  size_t old_words = (size_t)(c->cap + 63) / 64;
+  size_t new_words = (size_t)(ncap + 63) / 64;
+
+  c->empno = XORA_RESIZE_ARRAY(c->empno, int, ncap);
+  c->salary = XORA_RESIZE_ARRAY(c->salary, double, ncap);
+  c->salary_cents = XORA_RESIZE_ARRAY(c->salary_cents, int64_t, ncap);
+  c->ename_null = XORA_RESIZE_ARRAY(c->ename_null, uint64_t, new_words);
+  memset(c->ename_null + old_words, 0, sizeof(uint64_t) * (new_words - old_words));
+  c->ename_off = XORA_RESIZE_ARRAY(c->ename_off, uint32_t, (size_t)ncap + 1);
+  if (c->cap == 0)
+    c->ename_off[0] = 0;
+  c->cap = ncap;
+}
+
+static void xora__cols_grow_bytes(xora_emp_cols_t *c, size_t need)
+{
+  size_t ncap = c->bytes_cap ? c->bytes_cap : 16384;
+  while (ncap < need)
+    ncap *= 2;
+  c->ename_bytes = (char *)xora_realloc(c->ename_bytes, ncap);
+  c->bytes_cap = ncap;
+}
+
+xora_err_t xora_emp_cols_reserve(xora_emp_cols_t *c, int rows, size_t avg_name)
+{
+  if (!c || rows < 0)
+    return XORA_ERR;
+  if (c->count + rows > c->cap)
+    xora__cols_grow_rows(c, c->count + rows);
+  size_t need = c->bytes_len + (size_t)rows * (avg_name + 1);
+  if (need > UINT32_MAX)
+    return XORA_ALLOCATION_FAILED;
+  if (need > c->bytes_cap)
+    xora__cols_grow_bytes(c, need);
+  return XORA_OK;
+}
+
+xora_err_t xora_emp_cols_append(xora_emp_cols_t *c, const xora_emp_batch_view_t *v)
+{
+  if (!c || !v)
+    return XORA_ERR;
+  int n = v->count;
+  if (n <= 0)
+    return XORA_OK;
+  if (c->count + n > c->cap)
+    xora__cols_grow_rows(c, c->count + n);
+
+  int base = c->count;
+  memcpy(c->empno + base, v->empno, sizeof(int) * (size_t)n);
+  memcpy(c->salary + base, v->salary, sizeof(double) * (size_t)n);
+  if (v->salary_cents)
+    memcpy(c->salary_cents + base, v->salary_cents, sizeof(int64_t) * (size_t)n);
+  else
+    for (int i = 0; i < n; ++i)
+      c->salary_cents[base + i] = xora_cents_from_double(v->salary[i]);
+
+  /* names: measure, make room once, then pack */
+  size_t add = 0;
+  for (int i = 0; i < n; ++i)
+    if (v->ename_ind[i] >= 0)
+      add += strnlen(v->ename[i], XORA__NAME_MAX);
+  add += (size_t)n; /* NULs */
+  if (c->bytes_len + add > UINT32_MAX)
+    return XORA_ALLOCATION_FAILED;
+  if (c->bytes_len + add > c->bytes_cap)
+    xora__cols_grow_bytes(c, c->bytes_len + add);
+
+  size_t pos = c->bytes_len;
+  for (int i = 0; i < n; ++i)
+  {
+    int r = base + i;
+    if (v->ename_ind[i] < 0)
+    {
+      c->ename_null[r >> 6] |= (uint64_t)1 << (r & 63);
+    }
+    else
+    {
+      size_t len = strnlen(v->ename[i], XORA__NAME_MAX);
+      memcpy(c->ename_bytes + pos, v->ename[i], len);
+      pos += len;
+    }
+    c->ename_bytes[pos++] = '\0';
+    c->ename_off[r + 1] = (uint32_t)pos;
+  }
+
+  c->bytes_len = pos;
+  c->count += n;
+  return XORA_OK;
+}
+
+/* Back to `count` rows (error rollback) */
+static void xora__cols_truncate(xora_emp_cols_t *c, int count)
+{
+  for (int r = count; r < c->count; ++r)
+    c->ename_null[r >> 6] &= ~((uint64_t)1 << (r & 63));
+  c->count = count;
+  c->bytes_len = c->ename_off ? c->ename_off[count] : 0;
+}
+
+xora_err_t xora_emp_fetch_cols(xora_conn_t *h, xora_emp_cols_t *c, const xora_fetch_opts_t *opts)
+{
+  if (!h || !c)
+    return XORA_ERR;
+
+  xora_emp_cursor_t *cur = NULL;
+  if (xora_emp_cursor_open_ex(h, &cur, opts) != XORA_OK)
+    return XORA_ERR;
+
+  int base = c->count;
+  xora_emp_batch_view_t v;
+  xora_err_t rc;
+  while ((rc = xora_emp_cursor_next_batch(cur, &v)) == XORA_OK)
+  {
+    rc = xora_emp_cols_append(c, &v);
+    if (rc != XORA_OK)
+      break;
+  }
+
+  xora_emp_cursor_close(&cur);
+
+  if (rc != XORA_NO_DATA_FOUND)
+  {
+    xora__cols_truncate(c, base);
+    return rc == XORA_ALLOCATION_FAILED ? rc : XORA_ERR;
+  }
+  return XORA_OK;
+}
+
+void xora_emp_cols_get_row(const xora_emp_cols_t *c, int i, xora_emp_row_t *out)
+{
+  out->empno = c->empno[i];
+  out->salary = c->salary[i];
+  out->ename_is_null = (short)xora_emp_cols_is_null(c, i);
+  size_t len;
+  const char *name = xora_emp_cols_name(c, i, &len);
+  xora_memcpy(out->ename, sizeof(out->ename), name, len);
+}
+
+void xora_emp_cols_salary_by_id(const xora_emp_cols_t *c, int id_lo, int id_hi,
+                                xora_emp_salary_summary_t *out)
+{
+  memset(out, 0, sizeof(*out));
+  if (!c || c->count == 0)
+    return;
+
+  uint32_t *sel = XORA_ALLOC_ARRAY(uint32_t, c->count);
+  size_t n = xora_col_filter_range_i32(c->empno, (size_t)c->count, id_lo, id_hi, sel);
+  if (n > 0)
+  {
+    out->count = (long long)n;
+    if (sel[n - 1] - sel[0] + 1 == n)
+    {
+      const double *s = c->salary + sel[0];
+      out->sum_cents = xora_col_sum_i64(c->salary_cents + sel[0], n);
+      xora_col_minmax_f64(s, n, &out->min, &out->max);
+    }
+    else
+    {
+      out->sum_cents = xora_col_sum_i64_sel(c->salary_cents, sel, n);
+      xora_col_minmax_f64_sel(c->salary, sel, n, &out->min, &out->max);
+    }
+    out->sum = (double)out->sum_cents / 100.0;
+  }
+  xora_free(sel);
+}
+
+long long xora_emp_cols_count_salary(const xora_emp_cols_t *c, double sal_lo, double sal_hi)
+{
+  if (!c || c->count == 0)
+    return 0;
+  return (long long)xora_col_count_range_f64(c->salary, (size_t)c->count, sal_lo, sal_hi);
+}
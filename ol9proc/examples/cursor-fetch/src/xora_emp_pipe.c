@@ -0,0 +1,241 @@
+/* xora_emp_pipe.c
+ *
+ * Prefetch pipeline implementation.
+ * Notes:
+ *  - Buffers form a ring: [head, head + ready) are ready for the consumer,
+ *    the one before head is held by the consumer (if any), tail = head + ready
+ *    is the next one the fetch thread fills.
+ *  - One mutex + two condvars; one lock round per batch on each side.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_contex.h"
+#include "xora_proc_emp_fetch.h"
+#include "xora_emp_pipe.h"
+
+struct xora_emp_pipe
+{
+  xora_conn_t *h;
+  xora_emp_cursor_t *cur;
+
+  int nbuf;
+  xora_emp_batch_t *bufs;
+  int head;    /* next ready buffer */
+  int tail;    /* next buffer to fill */
+  int ready;   /* buffers ready for the consumer */
+  int holding; /* 1 while the consumer holds buffer head - 1 */
+  int eof;
+  int stop;
+  xora_err_t err;
+
+  pthread_mutex_t mu;
+  pthread_cond_t can_fill;
+  pthread_cond_t can_take;
+  pthread_t th;
+
+  xora_pipe_stats_t stats;
+};
+
+/*  internals  */
+
+static long long xora__pipe_now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static void *xora__pipe_main(void *arg)
+{
+  xora_emp_pipe_t *p = (xora_emp_pipe_t *)arg;
+
+  pthread_mutex_lock(&p->mu);
+  while (!p->stop)
+  {
+    /* Backpressure: wait for a buffer that is neither ready nor held */
+    if (p->ready + p->holding >= p->nbuf)
+    {
+      long long t0 = xora__pipe_now_us();
+      while (!p->stop && p->ready + p->holding >= p->nbuf)
+        pthread_cond_wait(&p->can_fill, &p->mu);
+      p->stats.producer_stall_us += xora__pipe_now_us() - t0;
+      if (p->stop)
+        break;
+    }
+    xora_emp_batch_t *b = &p->bufs[p->tail];
+    pthread_mutex_unlock(&p->mu);
+
+    /* Adaptive cursors may ask for more rows than this buffer was sized for */
+    int want = xora_emp_cursor_batch_size(p->cur);
+    if (b->cap < want)
+    {
+      xora_emp_batch_free(b);
+      (void)xora_emp_batch_alloc(b, want);
+    }
+    xora_err_t rc = xora_emp_cursor_fetch_into(p->cur, b);
+
+    pthread_mutex_lock(&p->mu);
+    if (rc == XORA_OK && b->count > 0)
+    {
+      p->tail = (p->tail + 1) % p->nbuf;
+      p->ready++;
+      p->stats.batches++;
+      p->stats.rows += b->count;
+    }
+    else
+    {
+      if (rc != XORA_NO_DATA_FOUND)
+        p->err = rc;
+      p->eof = 1;
+    }
+    pthread_cond_signal(&p->can_take);
+    if (p->eof)
+      break;
+  }
+  p->eof = 1;
+  pthread_cond_signal(&p->can_take);
+  pthread_mutex_unlock(&p->mu);
+  return NULL;
+}
+
+/*  public API  */
+
+xora_err_t xora_emp_pipe_open(xora_conn_t *h,
+                              xora_emp_pipe_t **out,
+                              int nbuf,
+                              const xora_fetch_opts_t *opts)
+{
+  return xora_emp_pipe_open_part(h, out, nbuf, opts, NULL);
+}
+
+xora_err_t xora_emp_pipe_open_part(xora_conn_t *h,
+                                   xora_emp_pipe_t **out,
+                                   int nbuf,
+                                   const xora_fetch_opts_t *opts,
+                                   const xora_emp_part_t *part)
+{
+  if (!h || !out || *out)
+    return XORA_ERR;
+  if (nbuf < 2)
+    nbuf = 2;
+
+  xora_emp_pipe_t *p = (xora_emp_pipe_t *)xora_calloc(1, sizeof(*p));
+  p->h = h;
+  p->nbuf = nbuf;
+  p->err = XORA_OK;
+
+  if (xora_emp_cursor_open_part(h, &p->cur, opts, part) != XORA_OK)
+  {
+    xora_free(p);
+    return XORA_ERR;
+  }
+
+  p->bufs = XORA_CALLOC_ARRAY(xora_emp_batch_t, nbuf);
+  int cap = xora_emp_cursor_batch_size(p->cur);
+  for (int i = 0; i < nbuf; ++i)
+    (void)xora_emp_batch_alloc(&p->bufs[i], cap);
+
+  pthread_mutex_init(&p->mu, NULL);
+  pthread_cond_init(&p->can_fill, NULL);
+  pthread_cond_init(&p->can_take, NULL);
+
+  if (pthread_create(&p->th, NULL, xora__pipe_main, p) != 0)
+  {
+    xora_emp_cursor_close(&p->cur);
+    for (int i = 0; i < nbuf; ++i)
+      xora_emp_batch_free(&p->bufs[i]);
+    pthread_cond_destroy(&p->can_take);
+    pthread_cond_destroy(&p->can_fill);
+    pthread_mutex_destroy(&p->mu);
+    xora_free(p->bufs);
+    xora_free(p);
+    return XORA_ERR;
+  }
+
+  *out = p;
+  return XORA_OK;
+}
+
+xora_err_t xora_emp_pipe_next(xora_emp_pipe_t *p, xora_emp_batch_view_t *view)
+{
+  if (!p || !view)
+    return XORA_ERR;
+  memset(view, 0, sizeof(*view));
+
+  pthread_mutex_lock(&p->mu);
+
+  /* Hand the previous buffer back to the fetch thread */
+  if (p->holding)
+  {
+    p->holding = 0;
+    pthread_cond_signal(&p->can_fill);
+  }
+
+  if (p->ready == 0 && !p->eof)
+  {
+    long long t0 = xora__pipe_now_us();
+    while (p->ready == 0 && !p->eof)
+      pthread_cond_wait(&p->can_take, &p->mu);
+    p->stats.consumer_stall_us += xora__pipe_now_us() - t0;
+  }
+
+  if (p->ready == 0)
+  {
+    xora_err_t rc = (p->err != XORA_OK) ? p->err : XORA_NO_DATA_FOUND;
+    pthread_mutex_unlock(&p->mu);
+    return rc;
+  }
+
+  xora_emp_batch_t *b = &p->bufs[p->head];
+  p->head = (p->head + 1) % p->nbuf;
+  p->ready--;
+  p->holding = 1;
+  pthread_mutex_unlock(&p->mu);
+
+  view->count = b->count;
+  view->empno = b->empno;
+  view->salary = b->salary;
+  view->salary_cents = b->salary_cents;
+  view->ename = (const char(*)[51])b->ename;
+  view->ename_ind = b->ename_ind;
+  return XORA_OK;
+}
+
+void xora_emp_pipe_get_stats(xora_emp_pipe_t *p, xora_pipe_stats_t *out)
+{
+  if (!p || !out)
+    return;
+  pthread_mutex_lock(&p->mu);
+  *out = p->stats;
+  pthread_mutex_unlock(&p->mu);
+}
+
+void xora_emp_pipe_close(xora_emp_pipe_t **pp)
+{
+  if (!pp || !*pp)
+    return;
+  xora_emp_pipe_t *p = *pp;
+
+  pthread_mutex_lock(&p->mu);
+  p->stop = 1;
+  pthread_cond_broadcast(&p->can_fill);
+  pthread_mutex_unlock(&p->mu);
+  pthread_join(p->th, NULL);
+
+  /* Fetch thread is gone: the connection is ours again */
+  xora_emp_cursor_close(&p->cur);
+  for (int i = 0; i < p->nbuf; ++i)
+    xora_emp_batch_free(&p->bufs[i]);
+
+  pthread_cond_destroy(&p->can_take);
+  pthread_cond_destroy(&p->can_fill);
+  pthread_mutex_destroy(&p->mu);
+  xora_free(p->bufs);
+  xora_free(p);
+  *pp = NULL;
+}
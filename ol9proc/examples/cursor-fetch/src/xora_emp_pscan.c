@@ -0,0 +1,424 @@
+/* xora_emp_pscan.c
+ *
+ * Parallel partitioned scan.
+ * Notes:
+ *  - Sessions are checked out on the caller's thread before any work starts,
+ *    so a short pool fails fast instead of leaving half the partitions running.
+ *  - Unordered: one worker thread per partition drives its own cursor.
+ *  - Ordered: one prefetch pipe per partition (the pipe owns the fetch thread);
+ *    the caller's thread consumes. Range partitions are disjoint and ascending,
+ *    so they are replayed in order without copying; hash partitions go through
+ *    a binary heap keyed on the head id of each partition.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_contex.h"
+#include "xora_pool.h"
+#include "xora_proc_emp_fetch.h"
+#include "xora_emp_pipe.h"
+#include "xora_emp_pscan.h"
+
+typedef struct XoraPscan
+{
+  const xora_pscan_opts_t *opts;
+  xora_pscan_cb_t cb;
+  void *ud;
+  atomic_int stop;
+  atomic_int err; /* first xora_err_t seen by any worker */
+} xora__pscan_t;
+
+typedef struct XoraPscanWorker
+{
+  xora__pscan_t *scan;
+  int idx;
+  xora_conn_t *conn;
+  xora_emp_part_t part;
+  pthread_t th;
+  int started;
+  xora_err_t rc;
+  long long rows;
+  long long batches;
+} xora__pscan_worker_t;
+
+/* Ordered mode: current batch of one partition */
+typedef struct XoraPscanSrc
+{
+  xora_emp_pipe_t *pipe;
+  xora_emp_batch_view_t view;
+  int pos;
+  long long rows;
+  xora_err_t rc; /* this partition's own failure */
+} xora__pscan_src_t;
+
+/*  internals  */
+
+static void xora__pscan_fail(xora__pscan_t *s, xora_err_t rc)
+{
+  int expected = XORA_OK;
+  atomic_compare_exchange_strong(&s->err, &expected, (int)rc);
+  atomic_store(&s->stop, 1);
+}
+
+/* Cut [lo, hi] into n equal spans; empty spans (n > hi - lo + 1) get lo > hi */
+static void xora__pscan_split_range(xora_emp_part_t *parts, int n, int lo, int hi)
+{
+  long long span = (long long)hi - lo + 1;
+  for (int i = 0; i < n; ++i)
+  {
+    parts[i].kind = XORA_PART_RANGE;
+    parts[i].lo = (int)(lo + span * i / n);
+    parts[i].hi = (int)(lo + span * (i + 1) / n - 1);
+  }
+}
+
+static void *xora__pscan_worker_main(void *arg)
+{
+  xora__pscan_worker_t *w = (xora__pscan_worker_t *)arg;
+  xora__pscan_t *s = w->scan;
+  xora_emp_cursor_t *cur = NULL;
+
+  w->rc = xora_emp_cursor_open_part(w->conn, &cur, &s->opts->fetch, &w->part);
+  if (w->rc != XORA_OK)
+  {
+    xora__pscan_fail(s, w->rc);
+    return NULL;
+  }
+
+  xora_emp_batch_view_t view;
+  while (!atomic_load(&s->stop))
+  {
+    xora_err_t rc = xora_emp_cursor_next_batch(cur, &view);
+    if (rc == XORA_NO_DATA_FOUND)
+      break;
+    if (rc != XORA_OK)
+    {
+      w->rc = rc;
+      xora__pscan_fail(s, rc);
+      break;
+    }
+    w->rows += view.count;
+    w->batches++;
+    if (s->cb(s->ud, w->idx, &view) != 0)
+    {
+      atomic_store(&s->stop, 1);
+      break;
+    }
+  }
+
+  xora_emp_cursor_close(&cur);
+  return NULL;
+}
+
+static xora_err_t xora__pscan_unordered(xora__pscan_t *s,
+                                        xora__pscan_worker_t *w,
+                                        int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    if (pthread_create(&w[i].th, NULL, xora__pscan_worker_main, &w[i]) != 0)
+    {
+      w[i].rc = XORA_ERR;
+      xora__pscan_fail(s, XORA_ERR);
+      break;
+    }
+    w[i].started = 1;
+  }
+  for (int i = 0; i < n; ++i)
+    if (w[i].started)
+      pthread_join(w[i].th, NULL);
+
+  return (xora_err_t)atomic_load(&s->err);
+}
+
+/* Advance a source past its current row; 0 = has a row, 1 = exhausted, <0 = error */
+static int xora__pscan_src_advance(xora__pscan_src_t *src, xora_err_t *rc_out)
+{
+  if (++src->pos < src->view.count)
+    return 0;
+
+  xora_err_t rc = xora_emp_pipe_next(src->pipe, &src->view);
+  src->pos = 0;
+  if (rc == XORA_OK)
+  {
+    src->rows += src->view.count;
+    return 0;
+  }
+  if (rc == XORA_NO_DATA_FOUND)
+    return 1;
+  src->rc = rc;
+  *rc_out = rc;
+  return -1;
+}
+
+static int xora__pscan_less(const xora__pscan_src_t *src, int a, int b)
+{
+  return src[a].view.empno[src[a].pos] < src[b].view.empno[src[b].pos];
+}
+
+static void xora__pscan_sift_down(int *heap, int len, int i, const xora__pscan_src_t *src)
+{
+  for (;;)
+  {
+    int l = 2 * i + 1;
+    int r = l + 1;
+    int m = i;
+    if (l < len && xora__pscan_less(src, heap[l], heap[m]))
+      m = l;
+    if (r < len && xora__pscan_less(src, heap[r], heap[m]))
+      m = r;
+    if (m == i)
+      return;
+    int t = heap[i];
+    heap[i] = heap[m];
+    heap[m] = t;
+    i = m;
+  }
+}
+
+/* k-way merge of per-partition id-ordered streams into merged batches */
+static xora_err_t xora__pscan_merge(xora__pscan_t *s,
+                                    xora__pscan_src_t *src,
+                                    int n,
+                                    xora_pscan_stats_t *st)
+{
+  int cap = s->opts->merge_batch > 0 ? s->opts->merge_batch : XORA_MAX_BATCH;
+  xora_emp_batch_t out;
+  if (xora_emp_batch_alloc(&out, cap) != XORA_OK)
+    return XORA_ALLOCATION_FAILED;
+
+  xora_err_t rc = XORA_OK;
+  int *heap = XORA_ALLOC_ARRAY(int, n);
+  int len = 0;
+
+  /* Prime: one batch per partition */
+  for (int i = 0; i < n; ++i)
+  {
+    src[i].pos = -1;
+    src[i].view.count = 0;
+    int a = xora__pscan_src_advance(&src[i], &rc);
+    if (a < 0)
+      goto done;
+    if (a == 0)
+      heap[len++] = i;
+  }
+  for (int i = len / 2 - 1; i >= 0; --i)
+    xora__pscan_sift_down(heap, len, i, src);
+
+  while (len > 0)
+  {
+    xora__pscan_src_t *top = &src[heap[0]];
+    int k = out.count++;
+    out.empno[k] = top->view.empno[top->pos];
+    out.salary[k] = top->view.salary[top->pos];
+    out.salary_cents[k] = top->view.salary_cents[top->pos];
+    out.ename_ind[k] = top->view.ename_ind[top->pos];
+    memcpy(out.ename[k], top->view.ename[top->pos], sizeof(out.ename[k]));
+
+    int a = xora__pscan_src_advance(top, &rc);
+    if (a < 0)
+      goto done;
+    if (a > 0)
+      heap[0] = heap[--len];
+    xora__pscan_sift_down(heap, len, 0, src);
+
+    if (out.count == out.cap || (len == 0 && out.count > 0))
+    {
+      xora_emp_batch_view_t v = {out.count, out.empno, out.salary, out.salary_cents,
+                                 (const char(*)[51])out.ename, out.ename_ind};
+      st->rows += out.count;
+      st->batches++;
+      out.count = 0;
+      if (s->cb(s->ud, -1, &v) != 0)
+        break;
+    }
+  }
+
+done:
+  xora_free(heap);
+  xora_emp_batch_free(&out);
+  return rc;
+}
+
+/* Range partitions are disjoint and ascending: drain them one after another.
+ * Later partitions keep prefetching (up to nbuf) while earlier ones drain. */
+static xora_err_t xora__pscan_concat(xora__pscan_t *s,
+                                     xora__pscan_src_t *src,
+                                     int n,
+                                     xora_pscan_stats_t *st)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    for (;;)
+    {
+      xora_err_t rc = xora_emp_pipe_next(src[i].pipe, &src[i].view);
+      if (rc == XORA_NO_DATA_FOUND)
+        break;
+      if (rc != XORA_OK)
+        return src[i].rc = rc;
+      src[i].rows += src[i].view.count;
+      st->rows += src[i].view.count;
+      st->batches++;
+      if (s->cb(s->ud, i, &src[i].view) != 0)
+        return XORA_OK;
+    }
+  }
+  return XORA_OK;
+}
+
+static xora_err_t xora__pscan_ordered(xora__pscan_t *s,
+                                      xora__pscan_worker_t *w,
+                                      int n,
+                                      xora_pscan_stats_t *st)
+{
+  xora_err_t rc = XORA_OK;
+  xora__pscan_src_t *src = XORA_CALLOC_ARRAY(xora__pscan_src_t, n);
+
+  for (int i = 0; i < n && rc == XORA_OK; ++i)
+    rc = src[i].rc = xora_emp_pipe_open_part(w[i].conn, &src[i].pipe, s->opts->nbuf,
+                                             &s->opts->fetch, &w[i].part);
+
+  if (rc == XORA_OK)
+    rc = (s->opts->split == XORA_PSCAN_RANGE) ? xora__pscan_concat(s, src, n, st)
+                                              : xora__pscan_merge(s, src, n, st);
+
+  for (int i = 0; i < n; ++i)
+  {
+    w[i].rows = src[i].rows;
+    if (src[i].rc != XORA_OK)
+      w[i].rc = src[i].rc;
+    else if (rc != XORA_OK)
+      w[i].rc = XORA_ERR; /* stopped by another partition */
+    xora_emp_pipe_close(&src[i].pipe);
+  }
+  xora_free(src);
+  return rc;
+}
+
+/*  public API  */
+
+void xora_pscan_opts_init(xora_pscan_opts_t *opts)
+{
+  if (!opts)
+    return;
+  memset(opts, 0, sizeof(*opts));
+  opts->nparts = 4;
+  opts->split = XORA_PSCAN_RANGE;
+  opts->nbuf = 2;
+  opts->merge_batch = XORA_MAX_BATCH;
+  opts->acquire_timeout_ms = 5000;
+  xora_fetch_opts_init(&opts->fetch);
+}
+
+xora_err_t xora_emp_pscan(xora_pool_t *pool,
+                          const xora_pscan_opts_t *opts,
+                          xora_pscan_cb_t cb,
+                          void *ud,
+                          xora_pscan_stats_t *stats)
+{
+  if (!pool || !cb)
+    return XORA_ERR;
+
+  xora_pscan_opts_t o;
+  if (opts)
+    o = *opts;
+  else
+    xora_pscan_opts_init(&o);
+  if (o.nparts <= 0)
+    o.nparts = 4;
+  if (o.nparts > XORA_POOL_MAX_SIZE)
+    o.nparts = XORA_POOL_MAX_SIZE;
+
+  xora__pscan_t s;
+  s.opts = &o;
+  s.cb = cb;
+  s.ud = ud;
+  atomic_init(&s.stop, 0);
+  atomic_init(&s.err, XORA_OK);
+
+  int n = o.nparts;
+  xora_pscan_stats_t st;
+  memset(&st, 0, sizeof(st));
+  st.parts = n;
+
+  xora__pscan_worker_t *w = XORA_CALLOC_ARRAY(xora__pscan_worker_t, n);
+  xora_err_t rc = XORA_OK;
+  int held = 0;
+
+  for (; held < n; ++held)
+  {
+    rc = xora_pool_acquire(pool, &w[held].conn, o.acquire_timeout_ms);
+    if (rc != XORA_OK)
+      goto release;
+    w[held].scan = &s;
+    w[held].idx = held;
+  }
+
+  if (o.split == XORA_PSCAN_RANGE)
+  {
+    int lo = 0, hi = 0;
+    rc = xora_emp_id_bounds(w[0].conn, &lo, &hi);
+    if (rc == XORA_NO_DATA_FOUND)
+    {
+      rc = XORA_OK; /* empty table: nothing to scan */
+      goto release;
+    }
+    if (rc != XORA_OK)
+    {
+      w[0].rc = rc;
+      goto release;
+    }
+    xora_emp_part_t *parts = XORA_CALLOC_ARRAY(xora_emp_part_t, n);
+    xora__pscan_split_range(parts, n, lo, hi);
+    for (int i = 0; i < n; ++i)
+      w[i].part = parts[i];
+    xora_free(parts);
+  }
+  else
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      w[i].part.kind = XORA_PART_HASH;
+      w[i].part.bucket = i;
+      w[i].part.nbuckets = n;
+    }
+  }
+
+  if (o.ordered)
+  {
+    rc = xora__pscan_ordered(&s, w, n, &st);
+  }
+  else
+  {
+    rc = xora__pscan_unordered(&s, w, n);
+    for (int i = 0; i < n; ++i)
+    {
+      st.rows += w[i].rows;
+      st.batches += w[i].batches;
+    }
+  }
+
+  st.min_part_rows = n > 0 ? w[0].rows : 0;
+  for (int i = 0; i < n; ++i)
+  {
+    if (w[i].rows > st.max_part_rows)
+      st.max_part_rows = w[i].rows;
+    if (w[i].rows < st.min_part_rows)
+      st.min_part_rows = w[i].rows;
+  }
+
+release:
+  for (int i = 0; i < held; ++i)
+    xora_pool_release(pool, w[i].conn,
+                      w[i].rc == XORA_OK         ? XORA_HEALTH_OK
+                      : w[i].rc == XORA_CONN_ERR ? XORA_HEALTH_BROKEN
+                                                 : XORA_HEALTH_SUSPECT);
+  xora_free(w);
+  if (stats)
+    *stats = st;
+  return rc;
+}
@@ -0,0 +1,496 @@
+/* xora_emp_wbq.c
+ *
+ * Group-commit write-behind queue.
+ * Notes:
+ *  - Queue: intrusive Vyukov MPSC list with a stub node. Producers do one
+ *    atomic exchange; only the writer thread pops.
+ *  - Writer wakeup: the writer publishes wake_at (rows it wants before it is
+ *    worth waking: 1 when idle, the rest of the group while lingering,
+ *    INT_MAX while busy). A producer signals only when `queued` reaches it,
+ *    so a busy writer costs producers no syscalls.
+ *  - Tickets are refcounted (caller + writer) so a caller may free a ticket
+ *    it stopped waiting for.
+ *  - Waiters share one condvar, broadcast once per group.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_contex.h"
+#include "xora_idalloc.h"
+#include "xora_proc_emp.h"
+#include "xora_proc_emp_crud.h"
+#include "xora_emp_wbq.h"
+
+struct xora_wb_ticket
+{
+  _Atomic(xora_wb_ticket_t *) next;
+  xora_emp_wbq_t *q;
+  xora_emp_row_t row;
+  xora_wb_done_cb_t cb;
+  void *ud;
+  atomic_int refs;
+  atomic_int done;
+  xora_err_t rc;
+  int empno;
+};
+
+struct xora_emp_wbq
+{
+  xora_conn_t *conn;
+  xora_idalloc_t *ids;
+  int max_batch;
+  int linger_ms;
+
+  _Atomic(xora_wb_ticket_t *) head; /* producers push here */
+  xora_wb_ticket_t *tail;           /* writer pops here */
+  xora_wb_ticket_t stub;
+
+  atomic_int queued;     /* pushed and linked, not yet popped */
+  atomic_int submitters; /* inside submit right now */
+  atomic_int wake_at;
+  atomic_int stop;
+
+  pthread_mutex_t mu;
+  pthread_cond_t wake;
+  pthread_mutex_t done_mu;
+  pthread_cond_t done_cv;
+  pthread_t th;
+
+  atomic_llong submitted;
+  atomic_llong rows_ok;
+  atomic_llong rows_failed;
+  atomic_llong groups;
+  atomic_int max_group;
+};
+
+/*  internals  */
+
+static void xora__wbq_push(xora_emp_wbq_t *q, xora_wb_ticket_t *t)
+{
+  atomic_store_explicit(&t->next, NULL, memory_order_relaxed);
+  xora_wb_ticket_t *prev = atomic_exchange(&q->head, t);
+  atomic_store(&prev->next, t);
+}
+
+/* Writer only. NULL when empty or when a producer is between its exchange
+ * and its link (the caller retries). */
+static xora_wb_ticket_t *xora__wbq_pop(xora_emp_wbq_t *q)
+{
+  xora_wb_ticket_t *tail = q->tail;
+  xora_wb_ticket_t *next = atomic_load(&tail->next);
+
+  if (tail == &q->stub)
+  {
+    if (!next)
+      return NULL;
+    q->tail = next;
+    tail = next;
+    next = atomic_load(&next->next);
+  }
+  if (next)
+  {
+    q->tail = next;
+    return tail;
+  }
+  if (tail != atomic_load(&q->head))
+    return NULL;
+
+  /* tail is the last node: re-insert the stub behind it to detach it */
+  xora__wbq_push(q, &q->stub);
+  next = atomic_load(&tail->next);
+  if (next)
+  {
+    q->tail = next;
+    return tail;
+  }
+  return NULL;
+}
+
+static void xora__wbq_unref(xora_wb_ticket_t *t)
+{
+  if (atomic_fetch_sub(&t->refs, 1) == 1)
+    xora_free(t);
+}
+
+static void xora__deadline_after(struct timespec *ts, int ms)
+{
+  clock_gettime(CLOCK_REALTIME, ts);
+  ts->tv_sec += ms / 1000;
+  ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+  if (ts->tv_nsec >= 1000000000L)
+  {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000L;
+  }
+}
+
+/* Pop until `batch` holds max rows or the queue looks empty */
+static int xora__wbq_collect(xora_emp_wbq_t *q, xora_wb_ticket_t **batch, int n)
+{
+  while (n < q->max_batch && atomic_load(&q->queued) > 0)
+  {
+    xora_wb_ticket_t *t = xora__wbq_pop(q);
+    if (!t)
+    {
+      sched_yield(); /* a producer is mid-link */
+      continue;
+    }
+    atomic_fetch_sub(&q->queued, 1);
+    batch[n++] = t;
+  }
+  return n;
+}
+
+/* Sleep until `want` rows are queued, stop, or the deadline (NULL = none) */
+static void xora__wbq_wait(xora_emp_wbq_t *q, int want, const struct timespec *deadline)
+{
+  pthread_mutex_lock(&q->mu);
+  atomic_store(&q->wake_at, want);
+  if (atomic_load(&q->queued) < want && !atomic_load(&q->stop))
+  {
+    if (deadline)
+      pthread_cond_timedwait(&q->wake, &q->mu, deadline);
+    else
+      pthread_cond_wait(&q->wake, &q->mu);
+  }
+  atomic_store(&q->wake_at, INT_MAX);
+  pthread_mutex_unlock(&q->mu);
+}
+
+static void xora__wbq_resolve(xora_emp_wbq_t *q, xora_wb_ticket_t **batch, int n)
+{
+  long long ok = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    xora_wb_ticket_t *t = batch[i];
+    if (t->rc == XORA_OK)
+      ok++;
+    atomic_store(&t->done, 1);
+    if (t->cb)
+      t->cb(t->ud, t->rc, t->empno);
+  }
+  atomic_fetch_add(&q->rows_ok, ok);
+  atomic_fetch_add(&q->rows_failed, n - ok);
+
+  pthread_mutex_lock(&q->done_mu);
+  pthread_cond_broadcast(&q->done_cv);
+  pthread_mutex_unlock(&q->done_mu);
+
+  for (int i = 0; i < n; ++i)
+    xora__wbq_unref(batch[i]);
+}
+
+/* One group: ids, array INSERT, one COMMIT */
+static void xora__wbq_write(xora_emp_wbq_t *q, xora_wb_ticket_t **batch, int n,
+                            xora_emp_row_t *rows, int *ids, int *affected)
+{
+  xora_err_t rc = XORA_OK;
+  for (int i = 0; i < n; ++i)
+    rows[i] = batch[i]->row;
+
+  if (q->ids && xora_idalloc_next_n(q->ids, q->conn, n, ids) != XORA_OK)
+    rc = XORA_ERR;
+
+  xora_bulk_report_t report;
+  memset(&report, 0, sizeof(report));
+  report.affected = affected;
+
+  if (rc == XORA_OK)
+  {
+    (void)xora_emp_bulk_create(q->conn, rows, n, q->ids ? ids : NULL, n, &report);
+    if (!q->ids)
+      for (int i = 0; i < n; ++i)
+        ids[i] = report.first_id + i;
+
+    if (report.rows_ok == 0)
+    {
+      (void)xora_tx_rollback(q->conn);
+    }
+    else if (xora_tx_commit(q->conn) != XORA_OK)
+    {
+      (void)xora_tx_rollback(q->conn);
+      rc = XORA_TX_ROLLBACK;
+    }
+  }
+
+  for (int i = 0; i < n; ++i)
+  {
+    if (rc != XORA_OK)
+      batch[i]->rc = rc;
+    else
+      batch[i]->rc = (affected[i] == 1) ? XORA_OK : XORA_ERR;
+    batch[i]->empno = (batch[i]->rc == XORA_OK) ? ids[i] : 0;
+  }
+
+  atomic_fetch_add(&q->groups, 1);
+  if (n > atomic_load(&q->max_group))
+    atomic_store(&q->max_group, n);
+}
+
+static void *xora__wbq_main(void *arg)
+{
+  xora_emp_wbq_t *q = (xora_emp_wbq_t *)arg;
+  int cap = q->max_batch;
+  xora_wb_ticket_t **batch = XORA_ALLOC_ARRAY(xora_wb_ticket_t *, cap);
+  xora_emp_row_t *rows = XORA_ALLOC_ARRAY(xora_emp_row_t, cap);
+  int *ids = XORA_ALLOC_ARRAY(int, cap);
+  int *affected = XORA_ALLOC_ARRAY(int, cap);
+
+  for (;;)
+  {
+    int n = xora__wbq_collect(q, batch, 0);
+    if (n == 0)
+    {
+      if (atomic_load(&q->stop) && atomic_load(&q->submitters) == 0 &&
+          atomic_load(&q->queued) == 0)
+        break;
+      xora__wbq_wait(q, 1, NULL);
+      continue;
+    }
+
+    /* Linger: give the group a chance to fill before paying for a commit */
+    if (n < cap && q->linger_ms > 0 && !atomic_load(&q->stop))
+    {
+      struct timespec deadline;
+      xora__deadline_after(&deadline, q->linger_ms);
+      for (;;)
+      {
+        xora__wbq_wait(q, cap - n, &deadline);
+        n = xora__wbq_collect(q, batch, n);
+
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        if (n >= cap || atomic_load(&q->stop) ||
+            now.tv_sec > deadline.tv_sec ||
+            (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec))
+          break;
+      }
+    }
+
+    xora__wbq_write(q, batch, n, rows, ids, affected);
+    xora__wbq_resolve(q, batch, n);
+  }
+
+  xora_free(affected);
+  xora_free(ids);
+  xora_free(rows);
+  xora_free(batch);
+  return NULL;
+}
+
+static xora_err_t xora__wbq_enqueue(xora_emp_wbq_t *q, xora_wb_ticket_t *t)
+{
+  atomic_fetch_add(&q->submitters, 1);
+  if (atomic_load(&q->stop))
+  {
+    atomic_fetch_sub(&q->submitters, 1);
+    return XORA_CONN_CLOSED;
+  }
+
+  xora__wbq_push(q, t);
+  int queued = atomic_fetch_add(&q->queued, 1) + 1;
+  atomic_fetch_add(&q->submitted, 1);
+  atomic_fetch_sub(&q->submitters, 1);
+
+  if (queued >= atomic_load(&q->wake_at))
+  {
+    pthread_mutex_lock(&q->mu);
+    pthread_cond_signal(&q->wake);
+    pthread_mutex_unlock(&q->mu);
+  }
+  return XORA_OK;
+}
+
+static xora_wb_ticket_t *xora__wbq_ticket(xora_emp_wbq_t *q, const xora_emp_row_t *row, int refs)
+{
+  xora_wb_ticket_t *t = (xora_wb_ticket_t *)xora_calloc(1, sizeof(*t));
+  t->q = q;
+  t->row = *row;
+  t->rc = XORA_ERR;
+  atomic_init(&t->refs, refs);
+  atomic_init(&t->done, 0);
+  return t;
+}
+
+/*  public API  */
+
+void xora_wbq_config_init(xora_wbq_config_t *cfg)
+{
+  if (!cfg)
+    return;
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->max_batch = XORA_BULK_CHUNK;
+  cfg->linger_ms = 2;
+}
+
+xora_err_t xora_wbq_create(xora_emp_wbq_t **out, const xora_wbq_config_t *cfg)
+{
+  if (!out || *out)
+    return XORA_ALREADY_ALLOCATED;
+  if (!cfg || !cfg->conn)
+    return XORA_ERR;
+
+  xora_emp_wbq_t *q = (xora_emp_wbq_t *)xora_calloc(1, sizeof(*q));
+  q->conn = cfg->conn;
+  q->ids = cfg->ids;
+  q->max_batch = cfg->max_batch > 0 ? cfg->max_batch : XORA_BULK_CHUNK;
+  if (q->max_batch > XORA_BULK_MAX_CHUNK)
+    q->max_batch = XORA_BULK_MAX_CHUNK;
+  q->linger_ms = cfg->linger_ms > 0 ? cfg->linger_ms : 0;
+
+  atomic_init(&q->stub.next, NULL);
+  atomic_init(&q->head, &q->stub);
+  q->tail = &q->stub;
+  atomic_init(&q->queued, 0);
+  atomic_init(&q->submitters, 0);
+  atomic_init(&q->wake_at, INT_MAX);
+  atomic_init(&q->stop, 0);
+  atomic_init(&q->submitted, 0);
+  atomic_init(&q->rows_ok, 0);
+  atomic_init(&q->rows_failed, 0);
+  atomic_init(&q->groups, 0);
+  atomic_init(&q->max_group, 0);
+
+  pthread_mutex_init(&q->mu, NULL);
+  pthread_cond_init(&q->wake, NULL);
+  pthread_mutex_init(&q->done_mu, NULL);
+  pthread_cond_init(&q->done_cv, NULL);
+
+  if (pthread_create(&q->th, NULL, xora__wbq_main, q) != 0)
+  {
+    pthread_cond_destroy(&q->done_cv);
+    pthread_mutex_destroy(&q->done_mu);
+    pthread_cond_destroy(&q->wake);
+    pthread_mutex_destroy(&q->mu);
+    xora_free(q);
+    return XORA_ERR;
+  }
+
+  *out = q;
+  return XORA_OK;
+}
+
+xora_err_t xora_wbq_submit(xora_emp_wbq_t *q, const xora_emp_row_t *row,
+                           xora_wb_ticket_t **out_ticket)
+{
+  if (!q || !row || !out_ticket)
+    return XORA_ERR;
+
+  xora_wb_ticket_t *t = xora__wbq_ticket(q, row, 2);
+  xora_err_t rc = xora__wbq_enqueue(q, t);
+  if (rc != XORA_OK)
+  {
+    xora_free(t);
+    return rc;
+  }
+  *out_ticket = t;
+  return XORA_OK;
+}
+
+xora_err_t xora_wbq_submit_cb(xora_emp_wbq_t *q, const xora_emp_row_t *row,
+                              xora_wb_done_cb_t cb, void *ud)
+{
+  if (!q || !row || !cb)
+    return XORA_ERR;
+
+  xora_wb_ticket_t *t = xora__wbq_ticket(q, row, 1);
+  t->cb = cb;
+  t->ud = ud;
+  xora_err_t rc = xora__wbq_enqueue(q, t);
+  if (rc != XORA_OK)
+    xora_free(t);
+  return rc;
+}
+
+xora_err_t xora_wb_ticket_wait(xora_wb_ticket_t *t, int timeout_ms, int *out_empno)
+{
+  if (!t)
+    return XORA_ERR;
+
+  if (!atomic_load(&t->done) && timeout_ms != 0)
+  {
+    xora_emp_wbq_t *q = t->q;
+    struct timespec deadline;
+    if (timeout_ms > 0)
+      xora__deadline_after(&deadline, timeout_ms);
+
+    pthread_mutex_lock(&q->done_mu);
+    while (!atomic_load(&t->done))
+    {
+      if (timeout_ms < 0)
+        pthread_cond_wait(&q->done_cv, &q->done_mu);
+      else if (pthread_cond_timedwait(&q->done_cv, &q->done_mu, &deadline) == ETIMEDOUT)
+        break;
+    }
+    pthread_mutex_unlock(&q->done_mu);
+  }
+
+  if (!atomic_load(&t->done))
+    return XORA_TIMEOUT;
+  if (out_empno)
+    *out_empno = t->empno;
+  return t->rc;
+}
+
+void xora_wb_ticket_free(xora_wb_ticket_t **tp)
+{
+  if (!tp || !*tp)
+    return;
+  xora__wbq_unref(*tp);
+  *tp = NULL;
+}
+
+xora_err_t xora_wbq_create_employee(xora_emp_wbq_t *q, const xora_emp_row_t *row,
+                                    int *out_empno)
+{
+  xora_wb_ticket_t *t = NULL;
+  xora_err_t rc = xora_wbq_submit(q, row, &t);
+  if (rc != XORA_OK)
+    return rc;
+  rc = xora_wb_ticket_wait(t, -1, out_empno);
+  xora_wb_ticket_free(&t);
+  return rc;
+}
+
+void xora_wbq_get_stats(xora_emp_wbq_t *q, xora_wbq_stats_t *out)
+{
+  if (!out)
+    return;
+  memset(out, 0, sizeof(*out));
+  if (!q)
+    return;
+  out->submitted = atomic_load(&q->submitted);
+  out->rows_ok = atomic_load(&q->rows_ok);
+  out->rows_failed = atomic_load(&q->rows_failed);
+  out->groups = atomic_load(&q->groups);
+  out->max_group = atomic_load(&q->max_group);
+  out->pending = (int)(out->submitted - out->rows_ok - out->rows_failed);
+}
+
+void xora_wbq_destroy(xora_emp_wbq_t **qp)
+{
+  if (!qp || !*qp)
+    return;
+  xora_emp_wbq_t *q = *qp;
+
+  pthread_mutex_lock(&q->mu);
+  atomic_store(&q->stop, 1);
+  pthread_cond_signal(&q->wake);
+  pthread_mutex_unlock(&q->mu);
+  pthread_join(q->th, NULL);
+
+  pthread_cond_destroy(&q->done_cv);
+  pthread_mutex_destroy(&q->done_mu);
+  pthread_cond_destroy(&q->wake);
+  pthread_mutex_destroy(&q->mu);
+  xora_free(q);
+  *qp = NULL;
+}
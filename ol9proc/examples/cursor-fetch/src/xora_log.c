@@ -0,0 +1,431 @@
+/* xora_log.c
+ *
+ * Structured log records and the asynchronous writer.
+ * Notes:
+ *  - The ring is a bounded MPSC queue after Vyukov: each slot carries a
+ *    sequence number. A producer claims a position with one CAS on head,
+ *    copies its line in and publishes it by storing seq = pos + 1. The
+ *    writer consumes in order and frees the slot with seq = pos + slots.
+ *    A producer that finds its slot still unconsumed drops the record. It
+ *    never spins on the writer.
+ *  - Lines are built in a thread-local buffer first, so the slot is held
+ *    only for the memcpy. The fixed fields are formatted by hand; vsnprintf
+ *    only runs for xora_logf's free-form part.
+ *  - xora__log_active counts producers between loading the ring pointer and
+ *    finishing their copy. xora_log_stop unpublishes the ring, waits for that
+ *    count to reach 0, then lets the writer drain. No record is written into
+ *    a ring being freed, and no producer ever takes a lock.
+ *  - The writer polls (idle_sleep_us) instead of being signalled, because
+ *    a wake-up from a producer would cost a syscall on the hot path.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_log.h"
+
+#define XORA__LOG_STEP_MAX 64 /* step= cap */
+#define XORA__LOG_SRC_MAX 16  /* src= cap */
+#define XORA__LOG_BATCH 16384 /* writer output buffer */
+
+typedef struct XoraLogSlot
+{
+  _Atomic size_t seq;
+  unsigned short len;
+  char line[XORA_LOG_LINE];
+} xora__log_slot_t;
+
+typedef struct XoraLogRing
+{
+  xora__log_slot_t *slots;
+  size_t mask;
+  _Atomic size_t head; /* next position to claim (producers) */
+  size_t tail;         /* next position to consume (writer only) */
+  FILE *out;
+  char *batch; /* XORA__LOG_BATCH bytes, writer only */
+  int idle_sleep_us;
+  atomic_int stop;
+  pthread_t writer;
+} xora__log_ring_t;
+
+static _Atomic(xora__log_ring_t *) xora__log_ring = NULL;
+static atomic_int xora__log_active = 0;
+static atomic_int xora__log_level = XORA_LOG_INFO;
+static _Atomic(FILE *) xora__log_out = NULL;
+static pthread_mutex_t xora__log_ctl = PTHREAD_MUTEX_INITIALIZER; /* start/stop */
+
+static _Atomic long long xora__log_written = 0;
+static _Atomic long long xora__log_dropped = 0;
+static _Atomic long long xora__log_truncated = 0;
+static _Atomic long long xora__log_sync = 0;
+
+static atomic_int xora__log_next_tid = 0;
+static _Thread_local int xora__log_tid = 0;
+static _Thread_local char xora__log_tls[XORA_LOG_LINE];
+
+static const char *const xora__log_level_names[] = {"DEBUG", "INFO", "WARN", "ERR"};
+
+/*  formatting  */
+
+/* Bounded line builder in the style of snprintf + advancing pos */
+typedef struct XoraLogLine
+{
+  char *buf;
+  size_t pos;
+  size_t cap; /* excluding the final '\n' */
+  int truncated;
+} xora__log_line_t;
+
+static void xora__log_vput(xora__log_line_t *l, const char *fmt, va_list ap)
+{
+  if (l->truncated)
+    return;
+  int n = vsnprintf(l->buf + l->pos, l->cap - l->pos + 1, fmt, ap);
+  if (n < 0)
+    n = 0;
+  if ((size_t)n > l->cap - l->pos)
+  {
+    l->pos = l->cap;
+    l->truncated = 1;
+    return;
+  }
+  l->pos += (size_t)n;
+}
+
+/* Raw bytes, control characters (newlines inside sqlerrmc) as spaces */
+static void xora__log_put_text(xora__log_line_t *l, const char *s, size_t n)
+{
+  if (l->truncated)
+    return;
+  if (n > l->cap - l->pos)
+  {
+    n = l->cap - l->pos;
+    l->truncated = 1;
+  }
+  for (size_t i = 0; i < n; ++i)
+  {
+    unsigned char c = (unsigned char)s[i];
+    l->buf[l->pos + i] = (c < 0x20 || c == 0x7f) ? ' ' : (char)c;
+  }
+  l->pos += n;
+}
+
+/* %.*s of a trusted literal or a NUL-terminated field, capped at max */
+static void xora__log_put_str(xora__log_line_t *l, const char *s, size_t max)
+{
+  const char *end = memchr(s, '\0', max);
+  xora__log_put_text(l, s, end ? (size_t)(end - s) : max);
+}
+
+/* %0*lld without vsnprintf: the fixed fields are most of a record's cost */
+static void xora__log_put_int(xora__log_line_t *l, long long v, int width)
+{
+  char tmp[24];
+  int n = 0;
+  unsigned long long u = v < 0 ? 0ull - (unsigned long long)v : (unsigned long long)v;
+  do
+  {
+    tmp[n++] = (char)('0' + u % 10);
+    u /= 10;
+  } while (u);
+  while (n < width)
+    tmp[n++] = '0';
+  if (v < 0)
+    tmp[n++] = '-';
+  if (l->truncated || (size_t)n > l->cap - l->pos)
+  {
+    l->truncated = 1;
+    return;
+  }
+  while (n)
+    l->buf[l->pos++] = tmp[--n];
+}
+
+#define XORA__LOG_LIT(l, s) xora__log_put_text((l), (s), sizeof(s) - 1)
+
+static void xora__log_begin(xora__log_line_t *l, xora_log_level_t level, const char *src)
+{
+  if (!xora__log_tid)
+    xora__log_tid = atomic_fetch_add_explicit(&xora__log_next_tid, 1, memory_order_relaxed) + 1;
+
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  l->buf = xora__log_tls;
+  l->pos = 0;
+  l->cap = sizeof(xora__log_tls) - 1;
+  l->truncated = 0;
+
+  /* ts=%lld.%06ld level=%s tid=%d src=%.16s */
+  XORA__LOG_LIT(l, "ts=");
+  xora__log_put_int(l, (long long)ts.tv_sec, 0);
+  XORA__LOG_LIT(l, ".");
+  xora__log_put_int(l, ts.tv_nsec / 1000, 6);
+  XORA__LOG_LIT(l, " level=");
+  xora__log_put_str(l, xora__log_level_names[level & 3], 8);
+  XORA__LOG_LIT(l, " tid=");
+  xora__log_put_int(l, xora__log_tid, 0);
+  XORA__LOG_LIT(l, " src=");
+  xora__log_put_str(l, src ? src : "-", XORA__LOG_SRC_MAX);
+}
+
+/*  publishing  */
+
+static FILE *xora__log_sink(void)
+{
+  FILE *f = atomic_load_explicit(&xora__log_out, memory_order_relaxed);
+  return f ? f : stderr;
+}
+
+static int xora__log_push(xora__log_ring_t *r, const char *line, size_t len)
+{
+  size_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+  xora__log_slot_t *s;
+  for (;;)
+  {
+    s = &r->slots[pos & r->mask];
+    size_t seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+    intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+    if (dif == 0)
+    {
+      if (atomic_compare_exchange_weak_explicit(&r->head, &pos, pos + 1,
+                                                memory_order_relaxed, memory_order_relaxed))
+        break;
+    }
+    else if (dif < 0)
+      return 0; /* full */
+    else
+      pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+  }
+  memcpy(s->line, line, len);
+  s->len = (unsigned short)len;
+  atomic_store_explicit(&s->seq, pos + 1, memory_order_release);
+  return 1;
+}
+
+static void xora__log_end(xora__log_line_t *l)
+{
+  if (l->truncated)
+    atomic_fetch_add_explicit(&xora__log_truncated, 1, memory_order_relaxed);
+  l->buf[l->pos++] = '\n';
+
+  atomic_fetch_add(&xora__log_active, 1);
+  xora__log_ring_t *r = atomic_load(&xora__log_ring);
+  if (r)
+  {
+    if (!xora__log_push(r, l->buf, l->pos))
+      atomic_fetch_add_explicit(&xora__log_dropped, 1, memory_order_relaxed);
+  }
+  atomic_fetch_sub(&xora__log_active, 1);
+  if (r)
+    return;
+
+  fwrite(l->buf, 1, l->pos, xora__log_sink());
+  atomic_fetch_add_explicit(&xora__log_sync, 1, memory_order_relaxed);
+}
+
+/*  writer  */
+
+/* Consume up to cap bytes of whole lines into buf; returns bytes */
+static size_t xora__log_drain(xora__log_ring_t *r, char *buf, size_t cap)
+{
+  size_t n = 0;
+  long long lines = 0;
+  for (;;)
+  {
+    xora__log_slot_t *s = &r->slots[r->tail & r->mask];
+    size_t seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+    if (seq != r->tail + 1 || n + s->len > cap)
+      break;
+    memcpy(buf + n, s->line, s->len);
+    n += s->len;
+    atomic_store_explicit(&s->seq, r->tail + r->mask + 1, memory_order_release);
+    r->tail++;
+    lines++;
+  }
+  if (lines)
+    atomic_fetch_add_explicit(&xora__log_written, lines, memory_order_relaxed);
+  return n;
+}
+
+static void *xora__log_writer(void *arg)
+{
+  xora__log_ring_t *r = (xora__log_ring_t *)arg;
+  char *buf = r->batch;
+  long long reported = atomic_load_explicit(&xora__log_dropped, memory_order_relaxed);
+
+  for (;;)
+  {
+    int stopping = atomic_load_explicit(&r->stop, memory_order_acquire);
+    size_t n = xora__log_drain(r, buf, XORA__LOG_BATCH);
+    if (n)
+    {
+      fwrite(buf, 1, n, r->out);
+      continue;
+    }
+
+    /* Idle: report losses since the last report, then flush */
+    long long dropped = atomic_load_explicit(&xora__log_dropped, memory_order_relaxed);
+    if (dropped != reported)
+    {
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      fprintf(r->out, "ts=%lld.%06ld level=WARN tid=0 src=log event=dropped count=%lld total=%lld\n",
+              (long long)ts.tv_sec, ts.tv_nsec / 1000, dropped - reported, dropped);
+      reported = dropped;
+    }
+    fflush(r->out);
+    if (stopping)
+      break;
+
+    struct timespec nap = {0, (long)r->idle_sleep_us * 1000L};
+    nanosleep(&nap, NULL);
+  }
+  return NULL;
+}
+
+/*  public API  */
+
+void xora_log_config_init(xora_log_config_t *cfg)
+{
+  if (!cfg)
+    return;
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->ring_slots = 4096;
+  cfg->idle_sleep_us = 1000;
+}
+
+xora_err_t xora_log_start(const xora_log_config_t *cfg)
+{
+  xora_log_config_t c;
+  xora_log_config_init(&c);
+  if (cfg)
+    c = *cfg;
+
+  size_t slots = 1;
+  while (slots < (size_t)(c.ring_slots > 0 ? c.ring_slots : 4096))
+    slots <<= 1;
+  if (slots < 2)
+    slots = 2;
+
+  pthread_mutex_lock(&xora__log_ctl);
+  if (atomic_load(&xora__log_ring))
+  {
+    pthread_mutex_unlock(&xora__log_ctl);
+    return XORA_ERR;
+  }
+
+  xora__log_ring_t *r = XORA_CALLOC_ARRAY(xora__log_ring_t, 1);
+  xora__log_slot_t *sl = r ? XORA_ALLOC_ARRAY(xora__log_slot_t, slots) : NULL;
+  char *batch = sl ? (char *)xora_malloc(XORA__LOG_BATCH) : NULL;
+  if (!batch)
+  {
+    xora_free(sl);
+    xora_free(r);
+    pthread_mutex_unlock(&xora__log_ctl);
+    return XORA_ERR;
+  }
+  for (size_t i = 0; i < slots; ++i)
+    atomic_init(&sl[i].seq, i);
+  r->slots = sl;
+  r->mask = slots - 1;
+  atomic_init(&r->head, 0);
+  r->batch = batch;
+  r->out = c.out ? c.out : xora__log_sink();
+  r->idle_sleep_us = c.idle_sleep_us > 0 ? c.idle_sleep_us : 1000;
+  atomic_init(&r->stop, 0);
+
+  if (pthread_create(&r->writer, NULL, xora__log_writer, r) != 0)
+  {
+    xora_free(batch);
+    xora_free(sl);
+    xora_free(r);
+    pthread_mutex_unlock(&xora__log_ctl);
+    return XORA_ERR;
+  }
+  atomic_store(&xora__log_ring, r);
+  pthread_mutex_unlock(&xora__log_ctl);
+  return XORA_OK;
+}
+
+void xora_log_stop(void)
+{
+  pthread_mutex_lock(&xora__log_ctl);
+  xora__log_ring_t *r = atomic_exchange(&xora__log_ring, NULL);
+  if (!r)
+  {
+    pthread_mutex_unlock(&xora__log_ctl);
+    return;
+  }
+  /* Producers that saw the ring finish their copy; later ones write sync */
+  while (atomic_load(&xora__log_active))
+    sched_yield();
+
+  atomic_store_explicit(&r->stop, 1, memory_order_release);
+  pthread_join(r->writer, NULL);
+  xora_free(r->batch);
+  xora_free(r->slots);
+  xora_free(r);
+  pthread_mutex_unlock(&xora__log_ctl);
+}
+
+void xora_log_set_output(FILE *out)
+{
+  atomic_store_explicit(&xora__log_out, out, memory_order_relaxed);
+}
+
+void xora_log_set_level(xora_log_level_t level)
+{
+  atomic_store_explicit(&xora__log_level, (int)level, memory_order_relaxed);
+}
+
+void xora_log_ora(xora_log_level_t level, const char *step, long code,
+                  const char *msg, int msg_len)
+{
+  if ((int)level < atomic_load_explicit(&xora__log_level, memory_order_relaxed))
+    return;
+
+  xora__log_line_t l;
+  xora__log_begin(&l, level, "ora");
+  XORA__LOG_LIT(&l, " step=");
+  xora__log_put_str(&l, step ? step : "-", XORA__LOG_STEP_MAX);
+  XORA__LOG_LIT(&l, " code=");
+  xora__log_put_int(&l, code, 0);
+  XORA__LOG_LIT(&l, " msg=");
+  size_t n = msg && msg_len > 0 ? (size_t)msg_len : 0;
+  while (n && (msg[n - 1] == '\n' || msg[n - 1] == ' '))
+    n--; /* sqlerrmc usually ends in a newline */
+  xora__log_put_text(&l, msg, n);
+  xora__log_end(&l);
+}
+
+void xora_logf(xora_log_level_t level, const char *src, const char *fmt, ...)
+{
+  if ((int)level < atomic_load_explicit(&xora__log_level, memory_order_relaxed))
+    return;
+
+  xora__log_line_t l;
+  xora__log_begin(&l, level, src);
+  XORA__LOG_LIT(&l, " ");
+  va_list ap;
+  va_start(ap, fmt);
+  xora__log_vput(&l, fmt, ap);
+  va_end(ap);
+  xora__log_end(&l);
+}
+
+void xora_log_get_stats(xora_log_stats_t *out)
+{
+  if (!out)
+    return;
+  out->written = atomic_load_explicit(&xora__log_written, memory_order_relaxed);
+  out->dropped = atomic_load_explicit(&xora__log_dropped, memory_order_relaxed);
+  out->truncated = atomic_load_explicit(&xora__log_truncated, memory_order_relaxed);
+  out->sync = atomic_load_explicit(&xora__log_sync, memory_order_relaxed);
+}
@@ -0,0 +1,763 @@
+/* xora_pool.c
+ *
+ * Connection pool implementation.
+ * Notes:
+ *  - Idle sessions live on a Treiber stack of slot indices. The head packs
+ *    (aba_tag << 32 | slot_index + 1) so pop/push are a single 64-bit CAS.
+ *  - Pool size is reserved with a CAS on `size` before a slot is claimed, so
+ *    growth never exceeds max_size and never needs the mutex.
+ *  - The mutex/condvar pair is only used by waiters; releasers signal only
+ *    when `waiters` is non-zero.
+ *  - A failed connect closes the growth gate for an exponentially growing
+ *    delay; while it is closed checkouts wait instead of logging on again,
+ *    and one caller per window probes the database.
+ *  - Checked-out sessions are found on release through a small open-addressed
+ *    map from the session pointer to its slot index.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_utf8.h"
+#include "xora_contex.h"
+#include "xora_pool.h"
+
+enum
+{
+  XORA_SLOT_EMPTY = 0,
+  XORA_SLOT_OPENING = 1,
+  XORA_SLOT_IDLE = 2,
+  XORA_SLOT_BUSY = 3
+};
+
+enum
+{
+  XORA_POOL_BACKOFF_MIN_MS = 50,
+  XORA_POOL_BACKOFF_MAX_MS = 5000
+};
+
+/* Release map cells: slot index + 1, or one of these */
+enum
+{
+  XORA_MAP_FREE = 0,
+  XORA_MAP_TOMB = -1
+};
+
+typedef struct XoraPoolSlot
+{
+  _Atomic(xora_conn_t *) conn;
+  atomic_int state;
+  atomic_uint next;        /* idle stack link: slot index + 1, 0 = end */
+  atomic_llong last_used;  /* monotonic ms of last release */
+  atomic_int health;
+  atomic_int failures;
+} xora_pool_slot_t;
+
+struct xora_pool
+{
+  xora_pool_config_t cfg;
+  xora_pool_factory_t factory;
+
+  /* Default factory credentials (copied, cfg strings are not retained) */
+  char user[32];
+  char pass[32];
+  char db[128];
+
+  xora_pool_slot_t *slots;
+  int nslots;
+
+  /* session -> slot index; cells never go back to FREE, so a lookup for a
+   * checked-out session always reaches its cell */
+  atomic_int *map;
+  unsigned map_mask;
+
+  /* Growth gate after a failed connect (monotonic ms, 0 = open) */
+  atomic_llong retry_at_ms;
+  atomic_int backoff_ms;
+
+  _Atomic uint64_t idle_head;
+  atomic_int size;
+  atomic_int idle;
+  atomic_int waiters;
+
+  pthread_mutex_t mu;
+  pthread_cond_t cv;       /* checkout waiters */
+  pthread_cond_t maint_cv; /* maintenance thread sleep/stop */
+
+  /* Maintenance thread */
+  pthread_t maint;
+  int maint_running;
+  int stopping;
+
+  /* Stats */
+  atomic_llong acquires;
+  atomic_llong waits;
+  atomic_llong timeouts;
+  atomic_llong created;
+  atomic_llong destroyed;
+  atomic_llong ping_failures;
+};
+
+/*  internals  */
+
+static long long xora__pool_now_ms(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000L;
+}
+
+static void xora__pool_deadline(struct timespec *ts, int timeout_ms)
+{
+  clock_gettime(CLOCK_MONOTONIC, ts);
+  ts->tv_sec += timeout_ms / 1000;
+  ts->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+  if (ts->tv_nsec >= 1000000000L)
+  {
+    ts->tv_sec += 1;
+    ts->tv_nsec -= 1000000000L;
+  }
+}
+
+/* Default factory: plain xora_conn_* calls */
+static xora_err_t xora__pool_default_connect(void *ud, xora_conn_t **out)
+{
+  xora_pool_t *p = (xora_pool_t *)ud;
+  xora_conn_t *c = NULL;
+
+  xora_err_t rc = xora_conn_create(&c, p->user, p->pass, p->db);
+  if (rc != XORA_OK)
+    return rc;
+
+  rc = xora_conn_open(c);
+  if (rc != XORA_CONN_OPEN_OK)
+  {
+    xora_conn_destroy(&c);
+    return rc;
+  }
+
+  *out = c;
+  return XORA_OK;
+}
+
+static xora_err_t xora__pool_default_ping(void *ud, xora_conn_t *conn)
+{
+  (void)ud;
+  return xora_conn_is_open(conn);
+}
+
+static void xora__pool_default_destroy(void *ud, xora_conn_t **conn)
+{
+  (void)ud;
+  xora_conn_destroy(conn);
+}
+
+/* Idle stack */
+static void xora__pool_push_idle(xora_pool_t *p, int idx)
+{
+  uint64_t head = atomic_load(&p->idle_head);
+  for (;;)
+  {
+    atomic_store(&p->slots[idx].next, (unsigned)(head & 0xFFFFFFFFu));
+    uint64_t tag = (head >> 32) + 1;
+    uint64_t nh = (tag << 32) | (uint64_t)(idx + 1);
+    if (atomic_compare_exchange_weak(&p->idle_head, &head, nh))
+      break;
+  }
+  atomic_fetch_add(&p->idle, 1);
+}
+
+static int xora__pool_pop_idle(xora_pool_t *p)
+{
+  uint64_t head = atomic_load(&p->idle_head);
+  for (;;)
+  {
+    unsigned top = (unsigned)(head & 0xFFFFFFFFu);
+    if (top == 0)
+      return -1;
+    unsigned next = atomic_load(&p->slots[top - 1].next);
+    uint64_t tag = (head >> 32) + 1;
+    uint64_t nh = (tag << 32) | (uint64_t)next;
+    if (atomic_compare_exchange_weak(&p->idle_head, &head, nh))
+    {
+      atomic_fetch_sub(&p->idle, 1);
+      return (int)top - 1;
+    }
+  }
+}
+
+static unsigned xora__pool_hash(const xora_pool_t *p, const xora_conn_t *c)
+{
+  uint64_t k = (uint64_t)(uintptr_t)c;
+  k = (k >> 4) * 0x9E3779B97F4A7C15ull;
+  return (unsigned)(k >> 32) & p->map_mask;
+}
+
+/* Called once slot idx holds c */
+static void xora__pool_map_put(xora_pool_t *p, const xora_conn_t *c, int idx)
+{
+  for (unsigned i = xora__pool_hash(p, c);; i = (i + 1) & p->map_mask)
+  {
+    int cur = atomic_load(&p->map[i]);
+    while (cur == XORA_MAP_FREE || cur == XORA_MAP_TOMB)
+    {
+      if (atomic_compare_exchange_weak(&p->map[i], &cur, idx + 1))
+        return;
+    }
+  }
+}
+
+/* Slot index of c, or -1 when c is not a session of this pool */
+static int xora__pool_map_find(xora_pool_t *p, const xora_conn_t *c, unsigned *cell)
+{
+  unsigned i = xora__pool_hash(p, c);
+  for (unsigned n = 0; n <= p->map_mask; ++n, i = (i + 1) & p->map_mask)
+  {
+    int v = atomic_load(&p->map[i]);
+    if (v == XORA_MAP_FREE)
+      break;
+    if (v > 0 && atomic_load(&p->slots[v - 1].conn) == c)
+    {
+      if (cell)
+        *cell = i;
+      return v - 1;
+    }
+  }
+  return -1;
+}
+
+/* Called before slot idx lets go of c */
+static void xora__pool_map_del(xora_pool_t *p, const xora_conn_t *c)
+{
+  unsigned cell;
+  if (xora__pool_map_find(p, c, &cell) >= 0)
+    atomic_store(&p->map[cell], XORA_MAP_TOMB);
+}
+
+/* Growth gate: 1 when this caller may try to open a session. Once a window
+ * has passed, only the caller that moves it forward probes the database. */
+static int xora__pool_may_connect(xora_pool_t *p)
+{
+  long long at = atomic_load(&p->retry_at_ms);
+  if (at == 0)
+    return 1;
+  long long now = xora__pool_now_ms();
+  if (now < at)
+    return 0;
+  return atomic_compare_exchange_strong(&p->retry_at_ms, &at, now + atomic_load(&p->backoff_ms));
+}
+
+static void xora__pool_connect_failed(xora_pool_t *p)
+{
+  int b = atomic_load(&p->backoff_ms);
+  b = b ? b * 2 : XORA_POOL_BACKOFF_MIN_MS;
+  if (b > XORA_POOL_BACKOFF_MAX_MS)
+    b = XORA_POOL_BACKOFF_MAX_MS;
+  atomic_store(&p->backoff_ms, b);
+  atomic_store(&p->retry_at_ms, xora__pool_now_ms() + b);
+}
+
+/* Wake one waiter if anybody is blocked in acquire */
+static void xora__pool_wake(xora_pool_t *p)
+{
+  if (atomic_load(&p->waiters) > 0)
+  {
+    pthread_mutex_lock(&p->mu);
+    pthread_cond_signal(&p->cv);
+    pthread_mutex_unlock(&p->mu);
+  }
+}
+
+/* Destroy the session in slot idx and give the slot (and its size unit) back. */
+static void xora__pool_drop_slot(xora_pool_t *p, int idx)
+{
+  xora_pool_slot_t *s = &p->slots[idx];
+  xora_conn_t *c = atomic_load(&s->conn);
+  if (c)
+    xora__pool_map_del(p, c);
+  atomic_store(&s->conn, NULL);
+  if (c)
+  {
+    p->factory.destroy(p->factory.ud, &c);
+    atomic_fetch_add(&p->destroyed, 1);
+  }
+  atomic_store(&s->health, XORA_HEALTH_OK);
+  atomic_store(&s->failures, 0);
+  /* EMPTY before size-- so a grower that sees room always finds a free slot */
+  atomic_store(&s->state, XORA_SLOT_EMPTY);
+  atomic_fetch_sub(&p->size, 1);
+  xora__pool_wake(p);
+}
+
+/* Reserve one unit of capacity; returns 1 on success. */
+static int xora__pool_reserve(xora_pool_t *p)
+{
+  int cur = atomic_load(&p->size);
+  while (cur < p->cfg.max_size)
+  {
+    if (atomic_compare_exchange_weak(&p->size, &cur, cur + 1))
+      return 1;
+  }
+  return 0;
+}
+
+/* Claim an EMPTY slot (capacity already reserved) and open a session into it. */
+static int xora__pool_open_slot(xora_pool_t *p, int *out_idx)
+{
+  int idx = -1;
+  for (int i = 0; i < p->nslots; ++i)
+  {
+    int expected = XORA_SLOT_EMPTY;
+    if (atomic_compare_exchange_strong(&p->slots[i].state, &expected, XORA_SLOT_OPENING))
+    {
+      idx = i;
+      break;
+    }
+  }
+  if (idx < 0)
+  {
+    /* cannot happen while size accounting holds; give the unit back */
+    atomic_fetch_sub(&p->size, 1);
+    return 0;
+  }
+
+  xora_conn_t *c = NULL;
+  if (p->factory.connect(p->factory.ud, &c) != XORA_OK || !c)
+  {
+    xora__pool_connect_failed(p);
+    atomic_store(&p->slots[idx].state, XORA_SLOT_EMPTY);
+    atomic_fetch_sub(&p->size, 1);
+    xora__pool_wake(p);
+    return 0;
+  }
+  if (atomic_load(&p->retry_at_ms))
+  {
+    atomic_store(&p->backoff_ms, 0);
+    atomic_store(&p->retry_at_ms, 0);
+  }
+
+  xora_pool_slot_t *s = &p->slots[idx];
+  atomic_store(&s->conn, c);
+  xora__pool_map_put(p, c, idx);
+  atomic_store(&s->health, XORA_HEALTH_OK);
+  atomic_store(&s->failures, 0);
+  atomic_store(&s->last_used, xora__pool_now_ms());
+  atomic_fetch_add(&p->created, 1);
+
+  *out_idx = idx;
+  return 1;
+}
+
+/* Checkout-side validation of an idle slot; returns 1 when usable. */
+static int xora__pool_validate(xora_pool_t *p, int idx)
+{
+  xora_pool_slot_t *s = &p->slots[idx];
+  int health = atomic_load(&s->health);
+
+  if (health == XORA_HEALTH_BROKEN)
+    return 0;
+
+  int must_ping = (health == XORA_HEALTH_SUSPECT);
+  if (!must_ping && p->cfg.validate_after_ms >= 0)
+  {
+    long long idle_ms = xora__pool_now_ms() - atomic_load(&s->last_used);
+    must_ping = idle_ms > p->cfg.validate_after_ms;
+  }
+  if (!must_ping || !p->factory.ping)
+    return 1;
+
+  if (p->factory.ping(p->factory.ud, atomic_load(&s->conn)) != XORA_OK)
+  {
+    atomic_fetch_add(&p->ping_failures, 1);
+    return 0;
+  }
+  atomic_store(&s->health, XORA_HEALTH_OK);
+  atomic_store(&s->failures, 0);
+  return 1;
+}
+
+/* One non-blocking checkout attempt: idle stack first, then growth. */
+static int xora__pool_try_acquire(xora_pool_t *p, int *out_idx)
+{
+  for (;;)
+  {
+    int idx = xora__pool_pop_idle(p);
+    if (idx < 0)
+      break;
+
+    atomic_store(&p->slots[idx].state, XORA_SLOT_BUSY);
+    if (xora__pool_validate(p, idx))
+    {
+      *out_idx = idx;
+      return 1;
+    }
+    xora__pool_drop_slot(p, idx);
+  }
+
+  /* a failed connect is not retried here: do not spin on a dead database */
+  int idx = -1;
+  if (xora__pool_may_connect(p) && xora__pool_reserve(p) && xora__pool_open_slot(p, &idx))
+  {
+    atomic_store(&p->slots[idx].state, XORA_SLOT_BUSY);
+    *out_idx = idx;
+    return 1;
+  }
+  return 0;
+}
+
+static void *xora__pool_maint_main(void *arg)
+{
+  xora_pool_t *p = (xora_pool_t *)arg;
+  int period_ms = p->cfg.idle_timeout_ms / 2;
+  if (period_ms < 100)
+    period_ms = 100;
+
+  pthread_mutex_lock(&p->mu);
+  while (!p->stopping)
+  {
+    struct timespec ts;
+    xora__pool_deadline(&ts, period_ms);
+    pthread_cond_timedwait(&p->maint_cv, &p->mu, &ts);
+    if (p->stopping)
+      break;
+    pthread_mutex_unlock(&p->mu);
+    (void)xora_pool_evict_idle(p);
+    pthread_mutex_lock(&p->mu);
+  }
+  pthread_mutex_unlock(&p->mu);
+  return NULL;
+}
+
+typedef struct XoraPoolWarmup
+{
+  xora_pool_t *p;
+  atomic_int remaining;
+} xora_pool_warmup_t;
+
+static void *xora__pool_warmup_main(void *arg)
+{
+  xora_pool_warmup_t *w = (xora_pool_warmup_t *)arg;
+  while (atomic_fetch_sub(&w->remaining, 1) > 0)
+  {
+    int idx = -1;
+    if (!xora__pool_reserve(w->p))
+      break;
+    if (xora__pool_open_slot(w->p, &idx))
+    {
+      atomic_store(&w->p->slots[idx].state, XORA_SLOT_IDLE);
+      xora__pool_push_idle(w->p, idx);
+    }
+  }
+  return NULL;
+}
+
+/*  public API  */
+
+void xora_pool_config_init(xora_pool_config_t *cfg)
+{
+  if (!cfg)
+    return;
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->min_size = 1;
+  cfg->max_size = 8;
+  cfg->idle_timeout_ms = 0;
+  cfg->validate_after_ms = 30000;
+  cfg->max_failures = 3;
+  cfg->warmup_threads = 0;
+}
+
+xora_err_t xora_pool_create(xora_pool_t **out, const xora_pool_config_t *cfg)
+{
+  if (!out || *out)
+    return XORA_ALREADY_ALLOCATED;
+  if (!cfg || cfg->max_size <= 0 || cfg->max_size > XORA_POOL_MAX_SIZE ||
+      cfg->min_size < 0 || cfg->min_size > cfg->max_size)
+    return XORA_ERR;
+
+  xora_pool_t *p = (xora_pool_t *)xora_calloc(1, sizeof(*p));
+  p->cfg = *cfg;
+  if (p->cfg.max_failures <= 0)
+    p->cfg.max_failures = 3;
+  p->cfg.user = p->cfg.pass = p->cfg.db = NULL;
+
+  if (cfg->factory)
+  {
+    p->factory = *cfg->factory;
+  }
+  else
+  {
+    xora_utf8_copy_bounded(p->user, cfg->user, sizeof(p->user));
+    xora_utf8_copy_bounded(p->pass, cfg->pass, sizeof(p->pass));
+    xora_utf8_copy_bounded(p->db, cfg->db, sizeof(p->db));
+    p->factory.ud = p;
+    p->factory.connect = xora__pool_default_connect;
+    p->factory.ping = xora__pool_default_ping;
+    p->factory.destroy = xora__pool_default_destroy;
+  }
+  p->cfg.factory = NULL;
+
+  p->nslots = cfg->max_size;
+  p->slots = XORA_CALLOC_ARRAY(xora_pool_slot_t, p->nslots);
+  unsigned ncells = 4;
+  while (ncells < 2u * (unsigned)p->nslots)
+    ncells <<= 1;
+  p->map = XORA_CALLOC_ARRAY(atomic_int, ncells);
+  p->map_mask = ncells - 1;
+
+  pthread_condattr_t ca;
+  pthread_condattr_init(&ca);
+  pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+  pthread_cond_init(&p->cv, &ca);
+  pthread_cond_init(&p->maint_cv, &ca);
+  pthread_condattr_destroy(&ca);
+  pthread_mutex_init(&p->mu, NULL);
+
+  /* Parallel warm-up: logon latency is paid once, not min_size times */
+  if (cfg->min_size > 0)
+  {
+    xora_pool_warmup_t w;
+    w.p = p;
+    atomic_init(&w.remaining, cfg->min_size);
+
+    int nthreads = cfg->warmup_threads > 0 ? cfg->warmup_threads : cfg->min_size;
+    if (nthreads > cfg->min_size)
+      nthreads = cfg->min_size;
+
+    pthread_t *tids = XORA_ALLOC_ARRAY(pthread_t, nthreads);
+    int started = 0;
+    for (int i = 0; i < nthreads; ++i)
+    {
+      if (pthread_create(&tids[started], NULL, xora__pool_warmup_main, &w) == 0)
+        ++started;
+    }
+    if (started == 0)
+      xora__pool_warmup_main(&w); /* no threads available; warm up inline */
+    for (int i = 0; i < started; ++i)
+      pthread_join(tids[i], NULL);
+    xora_free(tids);
+
+    if (atomic_load(&p->size) == 0)
+    {
+      xora_pool_destroy(&p);
+      return XORA_CONN_ERR;
+    }
+  }
+
+  if (cfg->idle_timeout_ms > 0)
+  {
+    if (pthread_create(&p->maint, NULL, xora__pool_maint_main, p) == 0)
+      p->maint_running = 1;
+  }
+
+  *out = p;
+  return XORA_OK;
+}
+
+xora_err_t xora_pool_acquire(xora_pool_t *p, xora_conn_t **out, int timeout_ms)
+{
+  if (!p || !out)
+    return XORA_ERR;
+  *out = NULL;
+
+  int idx = -1;
+  if (!xora__pool_try_acquire(p, &idx))
+  {
+    if (timeout_ms == 0)
+    {
+      atomic_fetch_add(&p->timeouts, 1);
+      return XORA_TIMEOUT;
+    }
+
+    struct timespec deadline = {0, 0};
+    if (timeout_ms > 0)
+      xora__pool_deadline(&deadline, timeout_ms);
+
+    atomic_fetch_add(&p->waits, 1);
+    int got = 0;
+    for (;;)
+    {
+      int expired = 0;
+
+      pthread_mutex_lock(&p->mu);
+      /* waiters is raised before the re-check so a concurrent release sees it */
+      atomic_fetch_add(&p->waiters, 1);
+      while (!p->stopping && (atomic_load(&p->idle_head) & 0xFFFFFFFFu) == 0)
+      {
+        /* room to grow: go now unless the gate is closed after a failed
+         * connect, in which case sleep until it opens (or the deadline) */
+        int gated = 0;
+        struct timespec gate;
+        if (atomic_load(&p->size) < p->cfg.max_size)
+        {
+          long long at = atomic_load(&p->retry_at_ms);
+          if (at == 0 || xora__pool_now_ms() >= at)
+            break;
+          gate.tv_sec = (time_t)(at / 1000);
+          gate.tv_nsec = (long)(at % 1000) * 1000000L;
+          gated = timeout_ms < 0 || gate.tv_sec < deadline.tv_sec ||
+                  (gate.tv_sec == deadline.tv_sec && gate.tv_nsec < deadline.tv_nsec);
+        }
+        int wrc = gated            ? pthread_cond_timedwait(&p->cv, &p->mu, &gate)
+                  : timeout_ms > 0 ? pthread_cond_timedwait(&p->cv, &p->mu, &deadline)
+                                   : pthread_cond_wait(&p->cv, &p->mu);
+        if (wrc == ETIMEDOUT)
+        {
+          expired = !gated;
+          break;
+        }
+      }
+      atomic_fetch_sub(&p->waiters, 1);
+      int stopping = p->stopping;
+      pthread_mutex_unlock(&p->mu);
+
+      /* the attempt itself runs unlocked: it may ping or open a session */
+      if (!stopping && xora__pool_try_acquire(p, &idx))
+      {
+        got = 1;
+        break;
+      }
+      if (expired || stopping)
+        break;
+    }
+
+    if (!got)
+    {
+      atomic_fetch_add(&p->timeouts, 1);
+      return XORA_TIMEOUT;
+    }
+  }
+
+  atomic_fetch_add(&p->acquires, 1);
+  *out = atomic_load(&p->slots[idx].conn);
+  return XORA_OK;
+}
+
+void xora_pool_release(xora_pool_t *p, xora_conn_t *conn, xora_conn_health_t health)
+{
+  if (!p || !conn)
+    return;
+
+  int idx = xora__pool_map_find(p, conn, NULL);
+  if (idx < 0)
+    return; /* not ours */
+
+  xora_pool_slot_t *s = &p->slots[idx];
+  if (health == XORA_HEALTH_SUSPECT &&
+      atomic_fetch_add(&s->failures, 1) + 1 >= p->cfg.max_failures)
+  {
+    health = XORA_HEALTH_BROKEN;
+  }
+  else if (health == XORA_HEALTH_OK)
+  {
+    atomic_store(&s->failures, 0);
+  }
+
+  if (health == XORA_HEALTH_BROKEN)
+  {
+    xora__pool_drop_slot(p, idx);
+    return;
+  }
+
+  atomic_store(&s->health, health);
+  atomic_store(&s->last_used, xora__pool_now_ms());
+  atomic_store(&s->state, XORA_SLOT_IDLE);
+  xora__pool_push_idle(p, idx);
+  xora__pool_wake(p);
+}
+
+int xora_pool_evict_idle(xora_pool_t *p)
+{
+  if (!p || p->cfg.idle_timeout_ms <= 0)
+    return 0;
+
+  /* Drain the idle stack and split it: fresh ones (and min_size) go back
+   * right away, before any logoff, so checkouts only miss them for the
+   * drain itself; the expired ones are closed afterwards. */
+  int *keep = XORA_ALLOC_ARRAY(int, 2 * p->nslots);
+  int *drop = keep + p->nslots;
+  int nkeep = 0, ndrop = 0;
+  long long now = xora__pool_now_ms();
+  int size = atomic_load(&p->size);
+
+  int idx;
+  while ((idx = xora__pool_pop_idle(p)) >= 0)
+  {
+    long long idle_ms = now - atomic_load(&p->slots[idx].last_used);
+    if (idle_ms > p->cfg.idle_timeout_ms && size - ndrop > p->cfg.min_size)
+    {
+      atomic_store(&p->slots[idx].state, XORA_SLOT_BUSY);
+      drop[ndrop++] = idx;
+    }
+    else
+    {
+      keep[nkeep++] = idx;
+    }
+  }
+  /* push back most-recently-used last so it is checked out first */
+  for (int i = nkeep - 1; i >= 0; --i)
+    xora__pool_push_idle(p, keep[i]);
+  if (nkeep)
+    xora__pool_wake(p);
+
+  for (int i = 0; i < ndrop; ++i)
+    xora__pool_drop_slot(p, drop[i]);
+
+  xora_free(keep);
+  return ndrop;
+}
+
+void xora_pool_get_stats(xora_pool_t *p, xora_pool_stats_t *out)
+{
+  if (!p || !out)
+    return;
+  memset(out, 0, sizeof(*out));
+  out->size = atomic_load(&p->size);
+  out->idle = atomic_load(&p->idle);
+  out->busy = out->size - out->idle;
+  out->acquires = atomic_load(&p->acquires);
+  out->waits = atomic_load(&p->waits);
+  out->timeouts = atomic_load(&p->timeouts);
+  out->created = atomic_load(&p->created);
+  out->destroyed = atomic_load(&p->destroyed);
+  out->ping_failures = atomic_load(&p->ping_failures);
+}
+
+void xora_pool_destroy(xora_pool_t **pp)
+{
+  if (!pp || !*pp)
+    return;
+  xora_pool_t *p = *pp;
+
+  pthread_mutex_lock(&p->mu);
+  p->stopping = 1;
+  pthread_cond_broadcast(&p->cv);
+  pthread_cond_signal(&p->maint_cv);
+  pthread_mutex_unlock(&p->mu);
+
+  if (p->maint_running)
+    pthread_join(p->maint, NULL);
+
+  for (int i = 0; i < p->nslots; ++i)
+  {
+    xora_conn_t *c = atomic_exchange(&p->slots[i].conn, NULL);
+    if (c)
+    {
+      p->factory.destroy(p->factory.ud, &c);
+      atomic_fetch_add(&p->destroyed, 1);
+    }
+  }
+
+  pthread_cond_destroy(&p->cv);
+  pthread_cond_destroy(&p->maint_cv);
+  pthread_mutex_destroy(&p->mu);
+  xora_free(p->map);
+  xora_free(p->slots);
+  xora_free(p);
+  *pp = NULL;
+}
@@ -0,0 +1,950 @@
+/* xora_sim.c
+ *
+ * Simulated backend: the Pro*C entry points the plain C layers and the
+ * benchmarks use, over an in-memory employees table.
+ * Notes:
+ *  - The table is one array sorted by id behind a rwlock; cursors remember
+ *    the last id they returned, so concurrent inserts behave like a
+ *    read-committed ORDER BY id scan.
+ *  - Work is done under the lock, the round-trip cost is paid after it, so
+ *    sessions overlap their waits as they would on a real server.
+ *  - Every entry point records the same stats as its Pro*C counterpart and
+ *    leaves the sqlcode it would leave in the handle's sqlca. Errors are
+ *    logged through xora_log, as XORA_ORA_OK does.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_utf8.h"
+#include "xora_decimal.h"
+#include "xora_contex.h"
+#include "xora_proc_emp.h"
+#include "xora_proc_emp_fetch.h"
+#include "xora_proc_emp_crud.h"
+#include "xora_idalloc.h"
+#include "xora_stats.h"
+#include "xora_proc_stats.h"
+#include "xora_sim.h"
+#include "xora_log.h"
+
+struct xora_conn
+{
+  char user[32];
+  char pass[32];
+  char db[128];
+  int broken;
+  long sqlcode; /* what the Pro*C build leaves in the handle's sqlca */
+  char sqlerrm[72];
+  xora_conn_stats_t stats;
+};
+
+typedef struct XoraSimTable
+{
+  pthread_rwlock_t lock;
+  xora_emp_row_t *rows; /* sorted by empno */
+  int count;
+  int cap;
+} xora__sim_table_t;
+
+static xora__sim_table_t xora__tab = {PTHREAD_RWLOCK_INITIALIZER, NULL, 0, 0};
+static pthread_once_t xora__sim_once = PTHREAD_ONCE_INIT;
+
+static atomic_int xora__rtt_us = 200;
+static atomic_int xora__row_ns = 50;
+static atomic_int xora__connect_us = 2000;
+static atomic_int xora__spin = 0;
+static int xora__seed_rows = 100000;
+
+#define XORA__SIM_DUP_MSG "ORA-00001: unique constraint violated"
+static atomic_llong xora__round_trips = 0;
+static atomic_int xora__seq = 1; /* idalloc source */
+
+/*  internals  */
+
+static int xora__env_int(const char *key, int defv)
+{
+  const char *v = getenv(key);
+  return (v && *v) ? atoi(v) : defv;
+}
+
+static uint64_t xora__sim_now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void xora__sim_wait_ns(long long ns)
+{
+  if (ns <= 0)
+    return;
+  if (atomic_load_explicit(&xora__spin, memory_order_relaxed))
+  {
+    uint64_t until = xora__sim_now_ns() + (uint64_t)ns;
+    while (xora__sim_now_ns() < until)
+      ;
+    return;
+  }
+  struct timespec ts = {(time_t)(ns / 1000000000LL), (long)(ns % 1000000000LL)};
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+    ;
+}
+
+/* One round trip moving `rows` rows */
+static void xora__sim_round_trip(long rows)
+{
+  atomic_fetch_add_explicit(&xora__round_trips, 1, memory_order_relaxed);
+  long long ns = (long long)atomic_load_explicit(&xora__rtt_us, memory_order_relaxed) * 1000LL +
+                 (long long)rows * atomic_load_explicit(&xora__row_ns, memory_order_relaxed);
+  xora__sim_wait_ns(ns);
+}
+
+static void xora__sim_reserve(int cap)
+{
+  if (xora__tab.cap >= cap)
+    return;
+  int ncap = xora__tab.cap ? xora__tab.cap : 1024;
+  while (ncap < cap)
+    ncap *= 2;
+  xora__tab.rows = (xora_emp_row_t *)xora_realloc(xora__tab.rows, xora_size_mul((size_t)ncap, sizeof(xora_emp_row_t)));
+  xora__tab.cap = ncap;
+}
+
+/* caller holds the write lock */
+static void xora__sim_seed_locked(int n)
+{
+  xora__tab.count = 0;
+  xora__sim_reserve(n > 0 ? n : 1);
+  for (int i = 0; i < n; ++i)
+  {
+    xora_emp_row_t *r = &xora__tab.rows[i];
+    memset(r, 0, sizeof(*r));
+    r->empno = i + 1;
+    r->salary = 1000.0 + (double)((i * 37) % 500) * 10.0;
+    if ((i + 1) % 97 == 0)
+      r->ename_is_null = 1;
+    else
+      snprintf(r->ename, sizeof(r->ename), "EMP%06d", i + 1);
+  }
+  xora__tab.count = n;
+  atomic_store(&xora__seq, n + 1);
+}
+
+static void xora__sim_init(void)
+{
+  xora_sim_config_t cfg;
+  xora_sim_config_init(&cfg);
+  atomic_store(&xora__rtt_us, cfg.rtt_us);
+  atomic_store(&xora__row_ns, cfg.row_ns);
+  atomic_store(&xora__connect_us, cfg.connect_us);
+  atomic_store(&xora__spin, cfg.spin);
+  xora__seed_rows = cfg.rows;
+
+  pthread_rwlock_wrlock(&xora__tab.lock);
+  xora__sim_seed_locked(cfg.rows);
+  pthread_rwlock_unlock(&xora__tab.lock);
+}
+
+static void xora__sim_ensure(void)
+{
+  pthread_once(&xora__sim_once, xora__sim_init);
+}
+
+/* First index with empno >= id (read or write lock held) */
+static int xora__sim_lower_bound(int id)
+{
+  int lo = 0, hi = xora__tab.count;
+  while (lo < hi)
+  {
+    int mid = lo + (hi - lo) / 2;
+    if (xora__tab.rows[mid].empno < id)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/* Insert one row in id order; -1 on duplicate (write lock held) */
+static int xora__sim_insert_locked(const xora_emp_row_t *in, int id)
+{
+  int pos = (xora__tab.count > 0 && xora__tab.rows[xora__tab.count - 1].empno < id)
+                ? xora__tab.count
+                : xora__sim_lower_bound(id);
+  if (pos < xora__tab.count && xora__tab.rows[pos].empno == id)
+    return -1;
+
+  xora__sim_reserve(xora__tab.count + 1);
+  if (pos < xora__tab.count)
+    memmove(&xora__tab.rows[pos + 1], &xora__tab.rows[pos],
+            (size_t)(xora__tab.count - pos) * sizeof(xora_emp_row_t));
+
+  xora_emp_row_t *r = &xora__tab.rows[pos];
+  memset(r, 0, sizeof(*r));
+  r->empno = id;
+  /* sal is NUMBER(8,2): the server keeps whole cents */
+  r->salary = (double)xora_cents_from_double(in->salary) / 100.0;
+  r->ename_is_null = in->ename_is_null ? 1 : 0;
+  if (!r->ename_is_null)
+    xora_utf8_copy_bounded(r->ename, in->ename, sizeof(r->ename));
+  xora__tab.count++;
+  return 0;
+}
+
+/* ORA_HASH stand-in */
+static int xora__sim_bucket(int id, int nbuckets)
+{
+  return (int)(((uint32_t)id * 2654435761u) % (uint32_t)nbuckets);
+}
+
+/*  configuration  */
+
+void xora_sim_config_init(xora_sim_config_t *cfg)
+{
+  if (!cfg)
+    return;
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->rtt_us = xora__env_int("XORA_SIM_RTT_US", 200);
+  cfg->row_ns = xora__env_int("XORA_SIM_ROW_NS", 50);
+  cfg->connect_us = xora__env_int("XORA_SIM_CONNECT_US", 2000);
+  cfg->rows = xora__env_int("XORA_SIM_ROWS", 100000);
+  cfg->spin = xora__env_int("XORA_SIM_SPIN", 0);
+}
+
+void xora_sim_configure(const xora_sim_config_t *cfg)
+{
+  xora__sim_ensure();
+  if (!cfg)
+    return;
+  atomic_store(&xora__rtt_us, cfg->rtt_us > 0 ? cfg->rtt_us : 0);
+  atomic_store(&xora__row_ns, cfg->row_ns > 0 ? cfg->row_ns : 0);
+  atomic_store(&xora__connect_us, cfg->connect_us > 0 ? cfg->connect_us : 0);
+  atomic_store(&xora__spin, cfg->spin ? 1 : 0);
+  xora__seed_rows = cfg->rows > 0 ? cfg->rows : 0;
+
+  pthread_rwlock_wrlock(&xora__tab.lock);
+  xora__sim_seed_locked(xora__seed_rows);
+  pthread_rwlock_unlock(&xora__tab.lock);
+}
+
+void xora_sim_set_latency(int rtt_us, int row_ns)
+{
+  xora__sim_ensure();
+  atomic_store(&xora__rtt_us, rtt_us > 0 ? rtt_us : 0);
+  atomic_store(&xora__row_ns, row_ns > 0 ? row_ns : 0);
+}
+
+void xora_sim_get_config(xora_sim_config_t *out)
+{
+  if (!out)
+    return;
+  xora__sim_ensure();
+  out->rtt_us = atomic_load(&xora__rtt_us);
+  out->row_ns = atomic_load(&xora__row_ns);
+  out->connect_us = atomic_load(&xora__connect_us);
+  out->rows = xora__seed_rows;
+  out->spin = atomic_load(&xora__spin);
+}
+
+long long xora_sim_round_trips(void)
+{
+  return atomic_load(&xora__round_trips);
+}
+
+int xora_sim_row_count(void)
+{
+  xora__sim_ensure();
+  pthread_rwlock_rdlock(&xora__tab.lock);
+  int n = xora__tab.count;
+  pthread_rwlock_unlock(&xora__tab.lock);
+  return n;
+}
+
+/*  connection (xora_contex.h)  */
+
+static void xora__sim_status(xora_conn_t *h, long code, const char *msg)
+{
+  h->sqlcode = code;
+  xora_utf8_copy_bounded(h->sqlerrm, msg, sizeof(h->sqlerrm));
+}
+
+xora_err_t xora_conn_create(xora_conn_t **out,
+                            const char *user,
+                            const char *pass,
+                            const char *db)
+{
+  if (!out || *out)
+    return XORA_ALREADY_ALLOCATED;
+  xora__sim_ensure();
+
+  xora_conn_t *h = (xora_conn_t *)xora_calloc(1, sizeof(*h));
+  h->broken = 1; /* not open yet */
+  xora_utf8_copy_bounded(h->user, user, sizeof(h->user));
+  xora_utf8_copy_bounded(h->pass, pass, sizeof(h->pass));
+  xora_utf8_copy_bounded(h->db, db, sizeof(h->db));
+
+  *out = h;
+  return XORA_OK;
+}
+
+xora_err_t xora_conn_open(xora_conn_t *h)
+{
+  if (!h)
+    return XORA_CONN_ERR;
+
+  XORA_STAT_BEGIN();
+  atomic_fetch_add_explicit(&xora__round_trips, 1, memory_order_relaxed);
+  xora__sim_wait_ns((long long)atomic_load(&xora__connect_us) * 1000LL);
+  XORA_STAT_END(XORA_OP_CONN_OPEN, &h->stats, 0, 1, 1);
+
+  xora__sim_status(h, 0, NULL);
+  h->broken = 0;
+  return XORA_CONN_OPEN_OK;
+}
+
+xora_err_t xora_conn_is_open(xora_conn_t *h)
+{
+  if (!h || h->broken)
+    return XORA_CONN_CLOSED;
+
+  XORA_STAT_BEGIN();
+  xora__sim_round_trip(1);
+  XORA_STAT_END(XORA_OP_PING, &h->stats, 1, 1, 1);
+  xora__sim_status(h, 0, NULL);
+  return XORA_CONN_OPEN_OK;
+}
+
+void xora_conn_close(xora_conn_t *h)
+{
+  if (!h || h->broken)
+    return;
+
+  XORA_STAT_BEGIN();
+  xora__sim_round_trip(0);
+  XORA_STAT_END(XORA_OP_CONN_CLOSE, &h->stats, 0, 1, 1);
+  xora__sim_status(h, 0, NULL);
+  h->broken = 1;
+}
+
+void xora_conn_destroy(xora_conn_t **hptr)
+{
+  if (!hptr || !*hptr)
+    return;
+  xora_conn_close(*hptr);
+  xora_free(*hptr);
+  *hptr = NULL;
+}
+
+void xora_conn_get_stats(xora_conn_t *h, xora_conn_stats_snapshot_t *out)
+{
+  if (!out)
+    return;
+  memset(out, 0, sizeof(*out));
+  if (!h)
+    return;
+
+  out->calls = atomic_load_explicit(&h->stats.calls, memory_order_relaxed);
+  out->round_trips = atomic_load_explicit(&h->stats.round_trips, memory_order_relaxed);
+  out->rows = atomic_load_explicit(&h->stats.rows, memory_order_relaxed);
+  out->errors = atomic_load_explicit(&h->stats.errors, memory_order_relaxed);
+  out->busy_ns = atomic_load_explicit(&h->stats.busy_ns, memory_order_relaxed);
+}
+
+long xora_conn_sqlcode(const xora_conn_t *h, char *msg, size_t msg_cap)
+{
+  if (msg && msg_cap)
+    msg[0] = '\0';
+  if (!h)
+    return 0;
+  if (msg && msg_cap)
+    xora_utf8_copy_bounded(msg, h->sqlerrm, msg_cap);
+  return h->sqlcode;
+}
+
+/*  transactions  */
+
+xora_err_t xora_tx_commit(xora_conn_t *h)
+{
+  if (!h)
+    return XORA_ERR;
+  XORA_STAT_BEGIN();
+  xora__sim_round_trip(0);
+  XORA_STAT_END(XORA_OP_COMMIT, &h->stats, 0, 1, 1);
+  xora__sim_status(h, 0, NULL);
+  return XORA_OK;
+}
+
+xora_err_t xora_tx_rollback(xora_conn_t *h)
+{
+  if (!h)
+    return XORA_ERR;
+  XORA_STAT_BEGIN();
+  xora__sim_round_trip(0);
+  XORA_STAT_END(XORA_OP_ROLLBACK, &h->stats, 0, 1, 1);
+  xora__sim_status(h, 0, NULL);
+  return XORA_OK;
+}
+
+/*  fetch (xora_proc_emp_fetch.h)  */
+
+struct xora_emp_cursor
+{
+  xora_conn_t *h;
+  xora_emp_batch_t buf; /* own batch for next_batch() */
+  xora_emp_part_t part;
+  int next_id; /* rows with empno >= next_id are still to come */
+  int batch;
+  int done;
+};
+
+void xora_fetch_opts_init(xora_fetch_opts_t *opts)
+{
+  if (!opts)
+    return;
+  memset(opts, 0, sizeof(*opts));
+  opts->batch_size = XORA_MAX_BATCH;
+  opts->adaptive = 0;
+  opts->min_batch = 64;
+  opts->mem_budget = XORA_FETCH_MEM_BUDGET;
+  opts->latency_share_pct = 10;
+}
+
+xora_err_t xora_emp_batch_alloc(xora_emp_batch_t *b, int cap)
+{
+  if (!b || cap <= 0)
+    return XORA_ERR;
+
+  memset(b, 0, sizeof(*b));
+  b->cap = cap;
+  b->empno = XORA_ALLOC_ARRAY(int, cap);
+  b->salary = XORA_ALLOC_ARRAY(double, cap);
+  b->salary_cents = XORA_ALLOC_ARRAY(int64_t, cap);
+  b->salary_num = XORA_ALLOC_ARRAY(xora_varnum_t, cap);
+  b->ename = (char(*)[51])xora_malloc(xora_size_mul((size_t)cap, 51));
+  b->ename_ind = XORA_ALLOC_ARRAY(short, cap);
+  return XORA_OK;
+}
+
+void xora_emp_batch_free(xora_emp_batch_t *b)
+{
+  if (!b)
+    return;
+  xora_free(b->empno);
+  xora_free(b->salary);
+  xora_free(b->salary_cents);
+  xora_free(b->salary_num);
+  xora_free(b->ename);
+  xora_free(b->ename_ind);
+  b->cap = 0;
+  b->count = 0;
+}
+
+xora_err_t xora_emp_cursor_open(xora_conn_t *h,
+                                xora_emp_cursor_t **out,
+                                int batch_size)
+{
+  xora_fetch_opts_t opts;
+  xora_fetch_opts_init(&opts);
+  opts.batch_size = batch_size;
+  return xora_emp_cursor_open_ex(h, out, &opts);
+}
+
+xora_err_t xora_emp_cursor_open_ex(xora_conn_t *h,
+                                   xora_emp_cursor_t **out,
+                                   const xora_fetch_opts_t *opts)
+{
+  return xora_emp_cursor_open_part(h, out, opts, NULL);
+}
+
+/* Adaptive sizing is not simulated: the start size is used throughout. */
+xora_err_t xora_emp_cursor_open_part(xora_conn_t *h,
+                                     xora_emp_cursor_t **out,
+                                     const xora_fetch_opts_t *opts,
+                                     const xora_emp_part_t *part)
+{
+  if (!h || !out || *out)
+    return XORA_ERR;
+  if (part && part->kind == XORA_PART_HASH &&
+      (part->nbuckets <= 0 || part->bucket < 0 || part->bucket >= part->nbuckets))
+    return XORA_ERR;
+
+  xora_emp_cursor_t *c = (xora_emp_cursor_t *)xora_calloc(1, sizeof(*c));
+  c->h = h;
+  if (part)
+    c->part = *part;
+  else
+    c->part.kind = XORA_PART_ALL;
+  c->next_id = (c->part.kind == XORA_PART_RANGE) ? c->part.lo : INT32_MIN;
+
+  int batch = (opts && opts->batch_size > 0) ? opts->batch_size : XORA_MAX_BATCH;
+  size_t budget = (opts && opts->mem_budget) ? opts->mem_budget : XORA_FETCH_MEM_BUDGET;
+  size_t max = budget / (sizeof(int) + XORA_VARNUM_SIZE + sizeof(int64_t) + sizeof(double) + 51 + sizeof(short));
+  if (max < 1)
+    max = 1;
+  if ((size_t)batch > max)
+    batch = (int)max;
+  c->batch = batch;
+
+  XORA_STAT_BEGIN();
+  xora__sim_round_trip(0);
+  XORA_STAT_END(XORA_OP_CURSOR_OPEN, &h->stats, 0, 1, 1);
+  xora__sim_status(h, 0, NULL);
+
+  *out = c;
+  return XORA_OK;
+}
+
+xora_err_t xora_emp_cursor_fetch_into(xora_emp_cursor_t *c,
+                                      xora_emp_batch_t *b)
+{
+  if (!c || !b || b->cap <= 0)
+    return XORA_ERR;
+  b->count = 0;
+  if (c->done)
+    return XORA_NO_DATA_FOUND;
+
+  int want = (c->batch < b->cap) ? c->batch : b->cap;
+
+  XORA_STAT_BEGIN();
+  pthread_rwlock_rdlock(&xora__tab.lock);
+  int i = xora__sim_lower_bound(c->next_id);
+  for (; i < xora__tab.count && b->count < want; ++i)
+  {
+    const xora_emp_row_t *r = &xora__tab.rows[i];
+    if (c->part.kind == XORA_PART_RANGE && r->empno > c->part.hi)
+    {
+      i = xora__tab.count;
+      break;
+    }
+    if (c->part.kind == XORA_PART_HASH &&
+        xora__sim_bucket(r->empno, c->part.nbuckets) != c->part.bucket)
+      continue;
+
+    int k = b->count++;
+    b->empno[k] = r->empno;
+    (void)xora_varnum_from_cents(xora_cents_from_double(r->salary), b->salary_num[k]);
+    b->ename_ind[k] = r->ename_is_null ? -1 : 0;
+    memcpy(b->ename[k], r->ename, sizeof(b->ename[k]));
+    c->next_id = r->empno + 1;
+  }
+  if (b->count < want)
+    c->done = 1;
+  pthread_rwlock_unlock(&xora__tab.lock);
+
+  xora__sim_round_trip(b->count);
+  XORA_STAT_END(XORA_OP_FETCH, &c->h->stats, b->count, 1, 1);
+  xora__sim_status(c->h, c->done ? 1403 : 0, c->done ? "ORA-01403: no data found" : NULL);
+
+  /* client side, as in the Pro*C fetch */
+  if (xora_varnum_to_cents_batch(b->salary_num, b->count, b->salary_cents) != 0)
+  {
+    b->count = 0;
+    return XORA_ERR;
+  }
+  xora_cents_to_double_batch(b->salary_cents, b->count, b->salary);
+
+  return (b->count > 0) ? XORA_OK : XORA_NO_DATA_FOUND;
+}
+
+xora_err_t xora_emp_cursor_next_batch(xora_emp_cursor_t *c,
+                                      xora_emp_batch_view_t *view)
+{
+  if (!c || !view)
+    return XORA_ERR;
+
+  if (c->buf.cap < c->batch)
+  {
+    xora_emp_batch_free(&c->buf);
+    (void)xora_emp_batch_alloc(&c->buf, c->batch);
+  }
+  xora_err_t rc = xora_emp_cursor_fetch_into(c, &c->buf);
+
+  view->count = c->buf.count;
+  view->empno = c->buf.empno;
+  view->salary = c->buf.salary;
+  view->salary_cents = c->buf.salary_cents;
+  view->ename = (const char(*)[51])c->buf.ename;
+  view->ename_ind = c->buf.ename_ind;
+  return rc;
+}
+
+void xora_emp_cursor_close(xora_emp_cursor_t **cp)
+{
+  if (!cp || !*cp)
+    return;
+  xora_emp_cursor_t *c = *cp;
+  xora_emp_batch_free(&c->buf);
+  xora_free(c);
+  *cp = NULL;
+}
+
+int xora_emp_cursor_batch_size(const xora_emp_cursor_t *c)
+{
+  return c ? c->batch : 0;
+}
+
+xora_err_t xora_emp_id_bounds(xora_conn_t *h, int *out_min, int *out_max)
+{
+  if (!h || !out_min || !out_max)
+    return XORA_ERR;
+
+  XORA_STAT_BEGIN();
+  pthread_rwlock_rdlock(&xora__tab.lock);
+  int n = xora__tab.count;
+  if (n > 0)
+  {
+    *out_min = xora__tab.rows[0].empno;
+    *out_max = xora__tab.rows[n - 1].empno;
+  }
+  pthread_rwlock_unlock(&xora__tab.lock);
+  xora__sim_round_trip(1);
+  XORA_STAT_END(XORA_OP_SELECT, &h->stats, 1, 1, 1);
+  xora__sim_status(h, 0, NULL); /* MIN/MAX always return a row */
+
+  return (n > 0) ? XORA_OK : XORA_NO_DATA_FOUND;
+}
+
+/* Same client-side loop as the Pro*C version: host arrays, then a row copy */
+xora_err_t xora_emp_fetch_arrst(xora_conn_t *h,
+                                xora_emp_row_t *rows,
+                                int cap,
+                                int *out_count,
+                                int batch_size)
+{
+  if (!h || !rows || !out_count || cap <= 0)
+    return XORA_ERR;
+  *out_count = 0;
+
+  xora_fetch_opts_t opts;
+  xora_fetch_opts_init(&opts);
+  opts.batch_size = batch_size;
+  if (opts.batch_size <= 0 || opts.batch_size > cap)
+    opts.batch_size = (cap < XORA_MAX_BATCH) ? cap : XORA_MAX_BATCH;
+
+  xora_emp_cursor_t *cur = NULL;
+  if (xora_emp_cursor_open_ex(h, &cur, &opts) != XORA_OK)
+    return XORA_ERR;
+
+  xora_emp_batch_view_t v;
+  xora_err_t rc = XORA_OK;
+  while (*out_count < cap &&
+         (rc = xora_emp_cursor_next_batch(cur, &v)) == XORA_OK)
+  {
+    for (int i = 0; i < v.count && *out_count < cap; ++i)
+    {
+      xora_emp_row_t *r = &rows[*out_count];
+      r->empno = v.empno[i];
+      r->salary = v.salary[i];
+      r->ename_is_null = (v.ename_ind[i] < 0);
+      xora_utf8_copy_bounded(r->ename, v.ename[i], sizeof(r->ename));
+      (*out_count)++;
+    }
+  }
+
+  xora_emp_cursor_close(&cur);
+  if (*out_count < cap && rc != XORA_NO_DATA_FOUND)
+    return XORA_ERR;
+  return XORA_OK;
+}
+
+/* Rows land in the caller's array, as with the host struct array bind */
+xora_err_t xora_emp_fetch_direct(xora_conn_t *h,
+                                 xora_emp_row_t *rows,
+                                 int cap,
+                                 int *out_count,
+                                 int batch_size)
+{
+  if (!h || !rows || !out_count || cap <= 0)
+    return XORA_ERR;
+  if (batch_size <= 0)
+    batch_size = XORA_MAX_BATCH;
+  if (batch_size > cap)
+    batch_size = cap;
+  *out_count = 0;
+
+  {
+    XORA_STAT_BEGIN();
+    xora__sim_round_trip(0);
+    XORA_STAT_END(XORA_OP_CURSOR_OPEN, &h->stats, 0, 1, 1);
+  }
+
+  int next_id = INT32_MIN;
+  int done = 0;
+  while (!done && *out_count < cap)
+  {
+    int n = cap - *out_count;
+    if (n > batch_size)
+      n = batch_size;
+
+    XORA_STAT_BEGIN();
+    pthread_rwlock_rdlock(&xora__tab.lock);
+    int i = xora__sim_lower_bound(next_id);
+    int got = xora__tab.count - i;
+    if (got > n)
+      got = n;
+    if (got > 0)
+    {
+      memcpy(rows + *out_count, &xora__tab.rows[i], (size_t)got * sizeof(xora_emp_row_t));
+      next_id = xora__tab.rows[i + got - 1].empno + 1;
+    }
+    pthread_rwlock_unlock(&xora__tab.lock);
+    xora__sim_round_trip(got);
+    XORA_STAT_END(XORA_OP_FETCH, &h->stats, got, 1, 1);
+
+    if (got < n)
+      done = 1;
+    *out_count += got;
+  }
+  return XORA_OK;
+}
+
+/*  CRUD (xora_proc_emp_crud.h)  */
+
+xora_err_t xora_emp_next_id(xora_conn_t *h, int *out_empno)
+{
+  if (!h || !out_empno)
+    return XORA_ERR;
+
+  XORA_STAT_BEGIN();
+  pthread_rwlock_rdlock(&xora__tab.lock);
+  int max = xora__tab.count ? xora__tab.rows[xora__tab.count - 1].empno : 0;
+  pthread_rwlock_unlock(&xora__tab.lock);
+  xora__sim_round_trip(1);
+  XORA_STAT_END(XORA_OP_SELECT, &h->stats, 1, 1, 1);
+  xora__sim_status(h, 0, NULL);
+
+  *out_empno = max + 1;
+  return XORA_OK;
+}
+
+xora_err_t xora_emp_create_with_id(xora_conn_t *h,
+                                   const xora_emp_row_t *in,
+                                   int explicit_empno,
+                                   int *out_empno)
+{
+  if (!h || !in || !out_empno)
+    return XORA_ERR;
+
+  XORA_STAT_BEGIN();
+  pthread_rwlock_wrlock(&xora__tab.lock);
+  int rc = xora__sim_insert_locked(in, explicit_empno);
+  pthread_rwlock_unlock(&xora__tab.lock);
+  xora__sim_round_trip(1);
+  XORA_STAT_END(XORA_OP_INSERT, &h->stats, rc == 0 ? 1 : 0, 1, rc == 0);
+  xora__sim_status(h, rc == 0 ? 0 : -1, rc == 0 ? NULL : XORA__SIM_DUP_MSG);
+
+  if (rc != 0)
+  {
+    xora_log_ora(XORA_LOG_ERR, "INSERT employees (with_id)", -1,
+                 XORA__SIM_DUP_MSG, (int)strlen(XORA__SIM_DUP_MSG));
+    return XORA_ERR;
+  }
+  *out_empno = explicit_empno;
+  return XORA_OK;
+}
+
+xora_err_t xora_emp_create_autoid(xora_conn_t *h,
+                                  const xora_emp_row_t *in,
+                                  int *out_empno)
+{
+  if (!h || !in || !out_empno)
+    return XORA_ERR;
+
+  int id = 0;
+  if (xora_emp_next_id(h, &id) != XORA_OK)
+    return XORA_ERR;
+  return xora_emp_create_with_id(h, in, id, out_empno);
+}
+
+xora_err_t xora_emp_bulk_create(xora_conn_t *h,
+                                const xora_emp_row_t *rows,
+                                int count,
+                                const int *ids,
+                                int chunk_size,
+                                xora_bulk_report_t *report)
+{
+  if (!h || !rows || count <= 0)
+    return XORA_ERR;
+  if (chunk_size <= 0)
+    chunk_size = XORA_BULK_CHUNK;
+  if (chunk_size > XORA_BULK_MAX_CHUNK)
+    chunk_size = XORA_BULK_MAX_CHUNK;
+
+  xora_bulk_report_t local;
+  if (!report)
+  {
+    memset(&local, 0, sizeof(local));
+    report = &local;
+  }
+  report->rows_ok = 0;
+  report->rows_failed = 0;
+  report->rows_affected = 0;
+  report->round_trips = 0;
+  report->first_id = 0;
+
+  int first_id = 0;
+  if (!ids)
+  {
+    if (xora_emp_next_id(h, &first_id) != XORA_OK)
+      return XORA_ERR;
+    report->round_trips++;
+    report->first_id = first_id;
+  }
+
+  for (int base = 0; base < count; base += chunk_size)
+  {
+    int n = count - base;
+    if (n > chunk_size)
+      n = chunk_size;
+
+    int ok = 0;
+    XORA_STAT_BEGIN();
+    pthread_rwlock_wrlock(&xora__tab.lock);
+    for (int i = 0; i < n; ++i)
+    {
+      int row = base + i;
+      int id = ids ? ids[row] : first_id + row;
+      int fail = (xora__sim_insert_locked(&rows[row], id) != 0);
+      if (report->affected)
+        report->affected[row] = fail ? -1 : 1;
+      if (fail)
+      {
+        if (report->failed_idx && report->rows_failed < report->failed_cap)
+          report->failed_idx[report->rows_failed] = row;
+        report->rows_failed++;
+      }
+      else
+      {
+        ok++;
+      }
+    }
+    pthread_rwlock_unlock(&xora__tab.lock);
+    /* the real path re-executes after each failed row */
+    xora__sim_round_trip(n);
+    XORA_STAT_END(XORA_OP_INSERT, &h->stats, ok, 1, ok == n);
+    xora__sim_status(h, ok == n ? 0 : -1, ok == n ? NULL : XORA__SIM_DUP_MSG);
+    report->round_trips++;
+    report->rows_ok += ok;
+    report->rows_affected += ok;
+  }
+
+  return (report->rows_failed == 0) ? XORA_OK : XORA_ERR;
+}
+
+xora_err_t xora_emp_get_by_id(xora_conn_t *h, int empno,
+                              xora_emp_row_t *out, int *found)
+{
+  if (!h || !out || !found)
+    return XORA_ERR;
+
+  XORA_STAT_BEGIN();
+  pthread_rwlock_rdlock(&xora__tab.lock);
+  int i = xora__sim_lower_bound(empno);
+  *found = (i < xora__tab.count && xora__tab.rows[i].empno == empno);
+  if (*found)
+    *out = xora__tab.rows[i];
+  pthread_rwlock_unlock(&xora__tab.lock);
+  xora__sim_round_trip(*found);
+  XORA_STAT_END(XORA_OP_SELECT, &h->stats, *found, 1, 1);
+  xora__sim_status(h, *found ? 0 : 1403, *found ? NULL : "ORA-01403: no data found");
+
+  return *found ? XORA_OK : XORA_NO_DATA_FOUND;
+}
+
+/*  id allocator (xora_idalloc.h): one shared sequence for every mode  */
+
+struct xora_idalloc
+{
+  pthread_mutex_t mu;
+  int block_size;
+  int next;
+  int end; /* exclusive */
+  long long refills;
+};
+
+xora_err_t xora_idalloc_create(xora_idalloc_t **out, const xora_idalloc_config_t *cfg,
+                               xora_conn_t *h)
+{
+  if (!out || *out || !cfg || !h || cfg->block_size < 0 ||
+      (cfg->block_size == 0 && cfg->mode != XORA_IDALLOC_SEQUENCE))
+    return XORA_ERR;
+  xora__sim_ensure();
+
+  xora_idalloc_t *a = (xora_idalloc_t *)xora_calloc(1, sizeof(*a));
+  pthread_mutex_init(&a->mu, NULL);
+  /* the simulated sequence steps by whatever is asked; 0 = 100 as in example_data.sql */
+  a->block_size = cfg->block_size ? cfg->block_size : 100;
+
+  /* the sequence must already be above every row, as the real create checks */
+  pthread_rwlock_rdlock(&xora__tab.lock);
+  int top = xora__tab.count ? xora__tab.rows[xora__tab.count - 1].empno : 0;
+  pthread_rwlock_unlock(&xora__tab.lock);
+  int cur = atomic_load(&xora__seq);
+  xora__sim_round_trip(2);
+  if (cur <= top)
+  {
+    xora_logf(XORA_LOG_ERR, "idalloc",
+              "step=create seq=employees_seq err=seq-below-max-id nextval=%d max_id=%d", cur, top);
+    pthread_mutex_destroy(&a->mu);
+    xora_free(a);
+    return XORA_ERR;
+  }
+  *out = a;
+  return XORA_OK;
+}
+
+xora_err_t xora_idalloc_next_n(xora_idalloc_t *a, xora_conn_t *h, int n, int *out_ids)
+{
+  if (!a || !h || n < 0 || (n > 0 && !out_ids))
+    return XORA_ERR;
+
+  pthread_mutex_lock(&a->mu);
+  for (int i = 0; i < n; ++i)
+  {
+    if (a->next >= a->end)
+    {
+      XORA_STAT_BEGIN();
+      a->next = atomic_fetch_add(&xora__seq, a->block_size);
+      a->end = a->next + a->block_size;
+      a->refills++;
+      xora__sim_round_trip(1);
+      XORA_STAT_END(XORA_OP_SELECT, &h->stats, 1, 1, 1);
+    }
+    out_ids[i] = a->next++;
+  }
+  pthread_mutex_unlock(&a->mu);
+  return XORA_OK;
+}
+
+xora_err_t xora_idalloc_next(xora_idalloc_t *a, xora_conn_t *h, int *out_id)
+{
+  return xora_idalloc_next_n(a, h, 1, out_id);
+}
+
+long long xora_idalloc_refills(xora_idalloc_t *a)
+{
+  if (!a)
+    return 0;
+  pthread_mutex_lock(&a->mu);
+  long long r = a->refills;
+  pthread_mutex_unlock(&a->mu);
+  return r;
+}
+
+void xora_idalloc_destroy(xora_idalloc_t **a)
+{
+  if (!a || !*a)
+    return;
+  pthread_mutex_destroy(&(*a)->mu);
+  xora_free(*a);
+  *a = NULL;
+}
@@ -0,0 +1,75 @@
+/* xora_simd.c
+ *
+ * SIMD level detection.
+ * Notes:
+ *  - The level is one atomic int: -1 until first use, then the detected
+ *    level capped by XORA_SIMD. Racing first callers compute the same value.
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xora_simd.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define XORA__SIMD_X86 1
+#endif
+
+static atomic_int xora__simd = -1;
+
+xora_simd_level_t xora_simd_detect(void)
+{
+#ifdef XORA__SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return XORA_SIMD_AVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return XORA_SIMD_SSE2;
+#endif
+  return XORA_SIMD_SCALAR;
+}
+
+static xora_simd_level_t xora__simd_cap(xora_simd_level_t lvl)
+{
+  xora_simd_level_t hw = xora_simd_detect();
+  return lvl < hw ? lvl : hw;
+}
+
+xora_simd_level_t xora_simd_level(void)
+{
+  int lvl = atomic_load_explicit(&xora__simd, memory_order_relaxed);
+  if (lvl >= 0)
+    return (xora_simd_level_t)lvl;
+
+  xora_simd_level_t want = XORA_SIMD_AVX2;
+  const char *env = getenv("XORA_SIMD");
+  if (env && !strcmp(env, "scalar"))
+    want = XORA_SIMD_SCALAR;
+  else if (env && !strcmp(env, "sse2"))
+    want = XORA_SIMD_SSE2;
+
+  lvl = (int)xora__simd_cap(want);
+  atomic_store_explicit(&xora__simd, lvl, memory_order_relaxed);
+  return (xora_simd_level_t)lvl;
+}
+
+xora_simd_level_t xora_simd_set_level(xora_simd_level_t lvl)
+{
+  xora_simd_level_t eff = xora__simd_cap(lvl);
+  atomic_store(&xora__simd, (int)eff);
+  return eff;
+}
+
+const char *xora_simd_level_name(xora_simd_level_t lvl)
+{
+  switch (lvl)
+  {
+  case XORA_SIMD_AVX2:
+    return "avx2";
+  case XORA_SIMD_SSE2:
+    return "sse2";
+  default:
+    return "scalar";
+  }
+}
@@ -0,0 +1,285 @@
+/* xora_stats.c
+ *
+ * Instrumentation shards and snapshots.
+ * Notes:
+ *  - Each recording thread owns one shard (thread-local pointer). It is the
+ *    only writer, so updates are relaxed load + store: plain moves on x86,
+ *    no lock prefix, no shared cache line with other threads.
+ *  - Shards live on a push-only list and are never freed; a thread that
+ *    exits hands its shard back (in_use = 0) and the next new thread adopts
+ *    it, so thread churn does not grow the list.
+ *  - Bucket index: values below 2^SUB map 1:1; above, the top SUB bits after
+ *    the leading one pick the sub-bucket of the value's octave.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_stats.h"
+#include "xora_proc_stats.h"
+
+#define XORA__SUB (1u << XORA_STATS_SUB_BITS)
+
+typedef struct XoraStatsOp
+{
+  _Atomic uint64_t calls;
+  _Atomic uint64_t errors;
+  _Atomic uint64_t rows;
+  _Atomic uint64_t round_trips;
+  _Atomic uint64_t total_ns;
+  _Atomic uint64_t max_ns;
+  _Atomic uint64_t hist[XORA_STATS_BUCKETS];
+} xora__stats_op_t;
+
+typedef struct XoraStatsShard
+{
+  struct XoraStatsShard *next;
+  atomic_int in_use;
+  xora__stats_op_t ops[XORA_OP__COUNT];
+} xora__stats_shard_t;
+
+atomic_int xora__stats_on = 0;
+
+static _Atomic(xora__stats_shard_t *) xora__shards = NULL;
+static atomic_int xora__nshards = 0;
+static _Thread_local xora__stats_shard_t *xora__tls_shard = NULL;
+static pthread_key_t xora__shard_key;
+static pthread_once_t xora__shard_once = PTHREAD_ONCE_INIT;
+
+static const char *const xora__op_names[XORA_OP__COUNT] = {
+    "conn_open", "conn_close", "ping", "cursor_open", "fetch", "select",
+    "insert", "update", "delete", "merge", "plsql", "commit", "rollback"};
+
+/*  internals  */
+
+#define XORA__INC(field, v) \
+  atomic_store_explicit(&(field), atomic_load_explicit(&(field), memory_order_relaxed) + (v), memory_order_relaxed)
+
+static void xora__shard_release(void *p)
+{
+  atomic_store(&((xora__stats_shard_t *)p)->in_use, 0);
+}
+
+static void xora__shard_key_init(void)
+{
+  pthread_key_create(&xora__shard_key, xora__shard_release);
+}
+
+static xora__stats_shard_t *xora__shard_get(void)
+{
+  xora__stats_shard_t *sh = xora__tls_shard;
+  if (sh)
+    return sh;
+
+  pthread_once(&xora__shard_once, xora__shard_key_init);
+
+  /* Adopt a shard left behind by an exited thread (counters carry over) */
+  for (sh = atomic_load(&xora__shards); sh; sh = sh->next)
+  {
+    int expected = 0;
+    if (atomic_compare_exchange_strong(&sh->in_use, &expected, 1))
+      break;
+  }
+
+  if (!sh)
+  {
+    sh = (xora__stats_shard_t *)xora_calloc(1, sizeof(*sh));
+    atomic_init(&sh->in_use, 1);
+    xora__stats_shard_t *head = atomic_load(&xora__shards);
+    do
+    {
+      sh->next = head;
+    } while (!atomic_compare_exchange_weak(&xora__shards, &head, sh));
+    atomic_fetch_add(&xora__nshards, 1);
+  }
+
+  pthread_setspecific(xora__shard_key, sh);
+  xora__tls_shard = sh;
+  return sh;
+}
+
+static unsigned xora__bucket(uint64_t v)
+{
+  if (v < XORA__SUB)
+    return (unsigned)v;
+  unsigned msb = 63u - (unsigned)__builtin_clzll(v);
+  unsigned shift = msb - XORA_STATS_SUB_BITS;
+  unsigned idx = ((shift + 1u) << XORA_STATS_SUB_BITS) + (unsigned)((v >> shift) & (XORA__SUB - 1u));
+  return idx < XORA_STATS_BUCKETS ? idx : XORA_STATS_BUCKETS - 1;
+}
+
+/* Largest value that maps to bucket idx */
+static uint64_t xora__bucket_upper(unsigned idx)
+{
+  if (idx < XORA__SUB)
+    return idx;
+  unsigned shift = (idx >> XORA_STATS_SUB_BITS) - 1u;
+  uint64_t lower = (uint64_t)(XORA__SUB + (idx & (XORA__SUB - 1u))) << shift;
+  return lower + (((uint64_t)1 << shift) - 1u);
+}
+
+static long long xora__percentile(const uint64_t *hist, uint64_t total, double q)
+{
+  if (total == 0)
+    return 0;
+  uint64_t rank = (uint64_t)(q * (double)total);
+  if (rank >= total)
+    rank = total - 1;
+  uint64_t seen = 0;
+  for (unsigned i = 0; i < XORA_STATS_BUCKETS; ++i)
+  {
+    seen += hist[i];
+    if (seen > rank)
+      return (long long)xora__bucket_upper(i);
+  }
+  return (long long)xora__bucket_upper(XORA_STATS_BUCKETS - 1);
+}
+
+/*  public API  */
+
+void xora_stats_enable(int on)
+{
+  atomic_store(&xora__stats_on, on ? 1 : 0);
+}
+
+int xora_stats_is_enabled(void)
+{
+  return xora_stats_enabled();
+}
+
+uint64_t xora_stats_now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void xora_stats_record(xora_stat_op_t op, xora_conn_stats_t *cs,
+                       uint64_t ns, long rows, int round_trips, int ok)
+{
+  if ((unsigned)op >= XORA_OP__COUNT)
+    return;
+
+  xora__stats_op_t *o = &xora__shard_get()->ops[op];
+  XORA__INC(o->calls, 1);
+  if (!ok)
+    XORA__INC(o->errors, 1);
+  if (rows > 0)
+    XORA__INC(o->rows, (uint64_t)rows);
+  XORA__INC(o->round_trips, (uint64_t)round_trips);
+  XORA__INC(o->total_ns, ns);
+  if (ns > atomic_load_explicit(&o->max_ns, memory_order_relaxed))
+    atomic_store_explicit(&o->max_ns, ns, memory_order_relaxed);
+  XORA__INC(o->hist[xora__bucket(ns)], 1);
+
+  if (cs)
+  {
+    /* A handle is used by one thread at a time and handed over through the
+     * pool's release/acquire, so it has a single writer as well. */
+    XORA__INC(cs->calls, 1);
+    XORA__INC(cs->round_trips, round_trips);
+    if (rows > 0)
+      XORA__INC(cs->rows, rows);
+    if (!ok)
+      XORA__INC(cs->errors, 1);
+    XORA__INC(cs->busy_ns, (long long)ns);
+  }
+}
+
+void xora_stats_snapshot(xora_stats_snapshot_t *out)
+{
+  if (!out)
+    return;
+  memset(out, 0, sizeof(*out));
+  out->enabled = xora_stats_enabled();
+  out->shards = atomic_load(&xora__nshards);
+
+  uint64_t *hist = XORA_CALLOC_ARRAY(uint64_t, XORA_STATS_BUCKETS);
+  for (int op = 0; op < XORA_OP__COUNT; ++op)
+  {
+    xora_stat_op_snapshot_t *s = &out->ops[op];
+    memset(hist, 0, sizeof(uint64_t) * XORA_STATS_BUCKETS);
+    uint64_t total = 0;
+
+    for (xora__stats_shard_t *sh = atomic_load(&xora__shards); sh; sh = sh->next)
+    {
+      xora__stats_op_t *o = &sh->ops[op];
+      s->calls += (long long)atomic_load_explicit(&o->calls, memory_order_relaxed);
+      s->errors += (long long)atomic_load_explicit(&o->errors, memory_order_relaxed);
+      s->rows += (long long)atomic_load_explicit(&o->rows, memory_order_relaxed);
+      s->round_trips += (long long)atomic_load_explicit(&o->round_trips, memory_order_relaxed);
+      s->total_ns += (long long)atomic_load_explicit(&o->total_ns, memory_order_relaxed);
+      long long mx = (long long)atomic_load_explicit(&o->max_ns, memory_order_relaxed);
+      if (mx > s->max_ns)
+        s->max_ns = mx;
+      for (unsigned i = 0; i < XORA_STATS_BUCKETS; ++i)
+      {
+        uint64_t c = atomic_load_explicit(&o->hist[i], memory_order_relaxed);
+        hist[i] += c;
+        total += c;
+      }
+    }
+
+    s->p50_ns = xora__percentile(hist, total, 0.50);
+    s->p90_ns = xora__percentile(hist, total, 0.90);
+    s->p99_ns = xora__percentile(hist, total, 0.99);
+    s->p999_ns = xora__percentile(hist, total, 0.999);
+
+    /* an upper bound can overshoot the largest sample actually seen */
+    if (s->p50_ns > s->max_ns) s->p50_ns = s->max_ns;
+    if (s->p90_ns > s->max_ns) s->p90_ns = s->max_ns;
+    if (s->p99_ns > s->max_ns) s->p99_ns = s->max_ns;
+    if (s->p999_ns > s->max_ns) s->p999_ns = s->max_ns;
+  }
+  xora_free(hist);
+}
+
+void xora_stats_reset(void)
+{
+  for (xora__stats_shard_t *sh = atomic_load(&xora__shards); sh; sh = sh->next)
+  {
+    for (int op = 0; op < XORA_OP__COUNT; ++op)
+    {
+      xora__stats_op_t *o = &sh->ops[op];
+      atomic_store_explicit(&o->calls, 0, memory_order_relaxed);
+      atomic_store_explicit(&o->errors, 0, memory_order_relaxed);
+      atomic_store_explicit(&o->rows, 0, memory_order_relaxed);
+      atomic_store_explicit(&o->round_trips, 0, memory_order_relaxed);
+      atomic_store_explicit(&o->total_ns, 0, memory_order_relaxed);
+      atomic_store_explicit(&o->max_ns, 0, memory_order_relaxed);
+      for (unsigned i = 0; i < XORA_STATS_BUCKETS; ++i)
+        atomic_store_explicit(&o->hist[i], 0, memory_order_relaxed);
+    }
+  }
+}
+
+const char *xora_stats_op_name(xora_stat_op_t op)
+{
+  return ((unsigned)op < XORA_OP__COUNT) ? xora__op_names[op] : "unknown";
+}
+
+void xora_stats_dump(FILE *f)
+{
+  if (!f)
+    return;
+  xora_stats_snapshot_t s;
+  xora_stats_snapshot(&s);
+  for (int op = 0; op < XORA_OP__COUNT; ++op)
+  {
+    const xora_stat_op_snapshot_t *o = &s.ops[op];
+    if (o->calls == 0)
+      continue;
+    fprintf(f,
+            "op=%s calls=%lld errors=%lld rows=%lld round_trips=%lld "
+            "mean_us=%.1f p50_us=%.1f p90_us=%.1f p99_us=%.1f p999_us=%.1f max_us=%.1f\n",
+            xora_stats_op_name((xora_stat_op_t)op), o->calls, o->errors, o->rows,
+            o->round_trips, (double)o->total_ns / (double)o->calls / 1e3,
+            o->p50_ns / 1e3, o->p90_ns / 1e3, o->p99_ns / 1e3, o->p999_ns / 1e3,
+            o->max_ns / 1e3);
+  }
+}
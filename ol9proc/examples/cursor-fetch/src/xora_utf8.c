@@ -0,0 +1,231 @@
+/* xora_utf8.c
+ *
+ * UTF-8 bounded copy and validation.
+ * Notes:
+ *  - The reference cut rule (xora_ut8_copy_bounded): walk characters by the
+ *    length their lead byte claims (anything that is not a 2/3/4-byte lead
+ *    counts as 1) and stop before the first one that does not fit.
+ *  - On well-formed input the walk lands exactly on lead bytes, so the cut is
+ *    found from the end instead: back up over at most three continuation
+ *    bytes from the limit and check that the lead there really crosses it.
+ *    Validating the copied prefix is what makes that shortcut exact;
+ *    malformed input takes the walk.
+ *  - SIMD only scans for the first non-ASCII byte (16 or 32 at a time);
+ *    multi-byte characters are decoded one by one. Strings under 32 bytes
+ *    (most names) stay on 16-byte loads.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "xora_simd.h"
+#include "xora_utf8.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define XORA__UTF8_X86 1
+#include <immintrin.h>
+#endif
+
+/* Length a lead byte claims, as the reference counts it */
+static inline size_t xora__lead_len(unsigned char c)
+{
+  if ((c & 0xE0) == 0xC0)
+    return 2;
+  if ((c & 0xF0) == 0xE0)
+    return 3;
+  if ((c & 0xF8) == 0xF0)
+    return 4;
+  return 1;
+}
+
+static inline int xora__is_cont(unsigned char c)
+{
+  return (c & 0xC0) == 0x80;
+}
+
+/*  first non-ASCII byte in s[0..n), or n  */
+
+static size_t xora__ascii_scalar(const unsigned char *s, size_t n)
+{
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    uint64_t w;
+    memcpy(&w, s + i, 8);
+    if (w & 0x8080808080808080ull)
+      break;
+  }
+  while (i < n && s[i] < 0x80)
+    ++i;
+  return i;
+}
+
+#ifdef XORA__UTF8_X86
+/* Blocks of 16; the tail is one more block ending at n, overlapping the
+ * last full one (already known ASCII), so short strings take no byte loop. */
+__attribute__((target("sse2"))) static size_t xora__ascii_sse2(const unsigned char *s, size_t n)
+{
+  if (n < 16)
+    return xora__ascii_scalar(s, n);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    unsigned m = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(s + i)));
+    if (m)
+      return i + (size_t)__builtin_ctz(m);
+  }
+  if (i < n)
+  {
+    unsigned m = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(s + n - 16)));
+    if (m)
+      return n - 16 + (size_t)__builtin_ctz(m);
+  }
+  return n;
+}
+
+__attribute__((target("avx2"))) static size_t xora__ascii_avx2(const unsigned char *s, size_t n)
+{
+  if (n < 32)
+    return xora__ascii_sse2(s, n);
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+  {
+    unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(s + i)));
+    if (m)
+      return i + (size_t)__builtin_ctz(m);
+  }
+  if (i < n)
+  {
+    unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(s + n - 32)));
+    if (m)
+      return n - 32 + (size_t)__builtin_ctz(m);
+  }
+  return n;
+}
+#endif
+
+static size_t xora__ascii(const unsigned char *s, size_t n, xora_simd_level_t lvl)
+{
+#ifdef XORA__UTF8_X86
+  if (lvl >= XORA_SIMD_AVX2)
+    return xora__ascii_avx2(s, n);
+  if (lvl >= XORA_SIMD_SSE2)
+    return xora__ascii_sse2(s, n);
+#else
+  (void)lvl;
+#endif
+  return xora__ascii_scalar(s, n);
+}
+
+/*  validation  */
+
+/* Length of the well-formed non-ASCII character at s[0..n), 0 if malformed */
+static size_t xora__utf8_char(const unsigned char *s, size_t n)
+{
+  unsigned char c = s[0];
+  if (c >= 0xC2 && c <= 0xDF)
+    return (n >= 2 && xora__is_cont(s[1])) ? 2 : 0;
+
+  if (c >= 0xE0 && c <= 0xEF)
+  {
+    if (n < 3 || !xora__is_cont(s[2]))
+      return 0;
+    unsigned char lo = (c == 0xE0) ? 0xA0 : 0x80; /* overlong */
+    unsigned char hi = (c == 0xED) ? 0x9F : 0xBF; /* surrogates */
+    return (s[1] >= lo && s[1] <= hi) ? 3 : 0;
+  }
+
+  if (c >= 0xF0 && c <= 0xF4)
+  {
+    if (n < 4 || !xora__is_cont(s[2]) || !xora__is_cont(s[3]))
+      return 0;
+    unsigned char lo = (c == 0xF0) ? 0x90 : 0x80; /* overlong */
+    unsigned char hi = (c == 0xF4) ? 0x8F : 0xBF; /* > U+10FFFF */
+    return (s[1] >= lo && s[1] <= hi) ? 4 : 0;
+  }
+
+  return 0; /* continuation, C0/C1, F5..FF */
+}
+
+static int xora__valid(const unsigned char *s, size_t n, xora_simd_level_t lvl)
+{
+  size_t i = 0;
+  for (;;)
+  {
+    i += xora__ascii(s + i, n - i, lvl);
+    if (i == n)
+      return 1;
+    size_t len = xora__utf8_char(s + i, n - i);
+    if (!len)
+      return 0;
+    i += len;
+  }
+}
+
+int xora_utf8_valid(const char *s, size_t len)
+{
+  if (!s)
+    return len == 0;
+  return xora__valid((const unsigned char *)s, len, xora_simd_level());
+}
+
+/*  bounded copy  */
+
+/* The reference walk, except that a NUL inside a claimed sequence ends the
+ * string there (the reference reads on past it; the visible copy is the same) */
+static size_t xora__copy_walk(char *dst, const unsigned char *s, size_t max)
+{
+  size_t i = 0;
+  while (i < max && s[i])
+  {
+    size_t clen = xora__lead_len(s[i]);
+    if (i + clen > max)
+      break;
+    size_t j = 1;
+    while (j < clen && s[i + j])
+      ++j;
+    i += j;
+    if (j < clen)
+      break;
+  }
+  memcpy(dst, s, i);
+  dst[i] = '\0';
+  return i;
+}
+
+size_t xora_utf8_copy_bounded(char *dst, const char *src, size_t dst_size)
+{
+  if (!dst || dst_size == 0)
+    return 0;
+  if (!src)
+  {
+    dst[0] = '\0';
+    return 0;
+  }
+
+  const unsigned char *s = (const unsigned char *)src;
+  size_t max = dst_size - 1;
+  size_t n = strnlen(src, max + 1); /* n == max + 1: s[max] exists */
+  size_t lim = n < max ? n : max;
+  xora_simd_level_t lvl = xora_simd_level();
+
+  size_t cut = lim;
+  size_t a = xora__ascii(s, lim, lvl);
+  if (a < lim)
+  {
+    if (n > max)
+    {
+      /* the character under the limit starts at most 3 bytes back */
+      for (int k = 0; k < 3 && cut > a && xora__is_cont(s[cut]); ++k)
+        --cut;
+      if (xora__is_cont(s[cut]) || (cut < max && xora__lead_len(s[cut]) <= max - cut))
+        return xora__copy_walk(dst, s, max);
+    }
+    if (!xora__valid(s + a, cut - a, lvl))
+      return xora__copy_walk(dst, s, max);
+  }
+
+  memcpy(dst, src, cut);
+  dst[cut] = '\0';
+  return cut;
+}
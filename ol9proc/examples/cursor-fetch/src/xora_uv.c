@@ -0,0 +1,435 @@
+/* xora_uv.c
+ *
+ * Asynchronous calls completed on a libuv loop.
+ * Notes:
+ *  - Submission: FIFO list under a mutex, idle workers sleep on a condvar.
+ *    Every request is one pool checkout; nothing is batched.
+ *  - Completion: workers append to a second list and uv_async_send(); the
+ *    loop side takes the whole list and runs the callbacks in completion
+ *    order. uv_async_send coalesces, so a burst costs one wakeup.
+ *  - The libuv thread pool (uv_queue_work) is not used: it is shared with
+ *    fs and DNS requests, and a few slow queries would stall them.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "xora_error.h"
+#include "xora_alloc.h"
+#include "xora_contex.h"
+#include "xora_pool.h"
+#include "xora_idalloc.h"
+#include "xora_proc_emp.h"
+#include "xora_proc_emp_crud.h"
+#include "xora_emp_cols.h"
+#include "xora_uv.h"
+
+typedef enum XoraUvKind
+{
+  XORA__UV_CALL,
+  XORA__UV_FETCH,
+  XORA__UV_INSERT,
+  XORA__UV_COMMIT
+} xora__uv_kind_t;
+
+typedef struct XoraUvReq
+{
+  struct XoraUvReq *next;
+  xora__uv_kind_t kind;
+  xora_conn_t *conn; /* NULL: check one out of the pool */
+  xora_async_cb_t cb;
+  void *ud;
+  xora_err_t rc;
+  union
+  {
+    struct
+    {
+      xora_async_fn_t fn;
+      void *arg;
+    } call;
+    struct
+    {
+      xora_emp_cols_t *out;
+      xora_fetch_opts_t opts;
+      int has_opts;
+    } fetch;
+    struct
+    {
+      int count;
+      int *out_ids;
+    } insert;
+  } u;
+  xora_emp_row_t rows[]; /* insert: the caller's rows, copied */
+} xora__uv_req_t;
+
+struct xora_uv
+{
+  uv_loop_t *loop;
+  uv_async_t async;
+  xora_pool_t *pool;
+  xora_idalloc_t *ids;
+  int acquire_timeout_ms;
+  int max_pending;
+
+  pthread_mutex_t mu; /* guards the queue and stop */
+  pthread_cond_t wake;
+  xora__uv_req_t *q_head;
+  xora__uv_req_t *q_tail;
+  int stop;
+
+  pthread_mutex_t done_mu;
+  xora__uv_req_t *d_head;
+  xora__uv_req_t *d_tail;
+
+  pthread_t *workers;
+  int nworkers;
+
+  atomic_int pending;
+  atomic_int max_pending_seen;
+  atomic_llong submitted;
+  atomic_llong completed;
+  atomic_llong rejected;
+};
+
+/*  worker side  */
+
+static xora_err_t xora__uv_insert(xora_uv_t *a, xora_conn_t *conn, xora__uv_req_t *r)
+{
+  int n = r->u.insert.count;
+  int *ids = r->u.insert.out_ids;
+  int *own_ids = NULL;
+  if (a->ids && !ids)
+    ids = own_ids = XORA_ALLOC_ARRAY(int, n);
+
+  xora_err_t rc = XORA_OK;
+  if (a->ids)
+    rc = xora_idalloc_next_n(a->ids, conn, n, ids);
+
+  if (rc == XORA_OK)
+  {
+    xora_bulk_report_t report;
+    memset(&report, 0, sizeof(report));
+    rc = xora_emp_bulk_create(conn, r->rows, n, a->ids ? ids : NULL, n, &report);
+    if (!a->ids && ids)
+      for (int i = 0; i < n; ++i)
+        ids[i] = report.first_id + i;
+  }
+  xora_free(own_ids);
+
+  if (r->conn)
+    return rc; /* the caller's transaction */
+
+  if (rc != XORA_OK)
+  {
+    (void)xora_tx_rollback(conn);
+    return XORA_TX_ROLLBACK;
+  }
+  if (xora_tx_commit(conn) != XORA_OK)
+  {
+    (void)xora_tx_rollback(conn);
+    return XORA_TX_ROLLBACK;
+  }
+  return XORA_OK;
+}
+
+static void xora__uv_run(xora_uv_t *a, xora__uv_req_t *r)
+{
+  xora_conn_t *conn = r->conn;
+  if (!conn)
+  {
+    r->rc = xora_pool_acquire(a->pool, &conn, a->acquire_timeout_ms);
+    if (r->rc != XORA_OK)
+      return;
+  }
+
+  switch (r->kind)
+  {
+  case XORA__UV_CALL:
+    r->rc = r->u.call.fn(conn, r->u.call.arg);
+    break;
+  case XORA__UV_FETCH:
+    r->rc = xora_emp_fetch_cols(conn, r->u.fetch.out, r->u.fetch.has_opts ? &r->u.fetch.opts : NULL);
+    break;
+  case XORA__UV_INSERT:
+    r->rc = xora__uv_insert(a, conn, r);
+    break;
+  case XORA__UV_COMMIT:
+    r->rc = xora_tx_commit(conn);
+    break;
+  }
+
+  if (!r->conn)
+    xora_pool_release(a->pool, conn,
+                      (r->rc == XORA_OK || r->rc == XORA_NO_DATA_FOUND) ? XORA_HEALTH_OK
+                                                                        : XORA_HEALTH_SUSPECT);
+}
+
+static void xora__uv_complete(xora_uv_t *a, xora__uv_req_t *r)
+{
+  r->next = NULL;
+  pthread_mutex_lock(&a->done_mu);
+  if (a->d_tail)
+    a->d_tail->next = r;
+  else
+    a->d_head = r;
+  a->d_tail = r;
+  pthread_mutex_unlock(&a->done_mu);
+  uv_async_send(&a->async);
+}
+
+static void *xora__uv_worker(void *arg)
+{
+  xora_uv_t *a = (xora_uv_t *)arg;
+  for (;;)
+  {
+    pthread_mutex_lock(&a->mu);
+    while (!a->q_head && !a->stop)
+      pthread_cond_wait(&a->wake, &a->mu);
+    xora__uv_req_t *r = a->q_head;
+    if (!r)
+    {
+      /* stopping and drained */
+      pthread_mutex_unlock(&a->mu);
+      return NULL;
+    }
+    a->q_head = r->next;
+    if (!a->q_head)
+      a->q_tail = NULL;
+    pthread_mutex_unlock(&a->mu);
+
+    xora__uv_run(a, r);
+    xora__uv_complete(a, r);
+  }
+}
+
+/*  loop side  */
+
+static void xora__uv_drain(xora_uv_t *a)
+{
+  pthread_mutex_lock(&a->done_mu);
+  xora__uv_req_t *r = a->d_head;
+  a->d_head = a->d_tail = NULL;
+  pthread_mutex_unlock(&a->done_mu);
+
+  while (r)
+  {
+    xora__uv_req_t *next = r->next;
+    /* free the slot first: the callback may submit the next request */
+    atomic_fetch_sub(&a->pending, 1);
+    atomic_fetch_add(&a->completed, 1);
+    if (r->cb)
+      r->cb(r->ud, r->rc);
+    xora_free(r);
+    r = next;
+  }
+}
+
+static void xora__uv_on_async(uv_async_t *h)
+{
+  xora__uv_drain((xora_uv_t *)h->data);
+}
+
+static void xora__uv_on_close(uv_handle_t *h)
+{
+  xora_uv_t *a = (xora_uv_t *)h->data; /* h lives inside a */
+  xora_free(a);
+}
+
+/*  submission  */
+
+static xora__uv_req_t *xora__uv_req_new(xora__uv_kind_t kind, xora_conn_t *conn,
+                                        xora_async_cb_t cb, void *ud, int rows)
+{
+  size_t size = offsetof(xora__uv_req_t, rows) + xora_size_mul((size_t)rows, sizeof(xora_emp_row_t));
+  xora__uv_req_t *r = (xora__uv_req_t *)xora_malloc(size);
+  memset(r, 0, offsetof(xora__uv_req_t, rows));
+  r->kind = kind;
+  r->conn = conn;
+  r->cb = cb;
+  r->ud = ud;
+  return r;
+}
+
+/* Takes ownership of r */
+static xora_err_t xora__uv_submit(xora_uv_t *a, xora__uv_req_t *r)
+{
+  int n = atomic_fetch_add(&a->pending, 1) + 1;
+  if (n > a->max_pending)
+  {
+    atomic_fetch_sub(&a->pending, 1);
+    atomic_fetch_add(&a->rejected, 1);
+    xora_free(r);
+    return XORA_TIMEOUT;
+  }
+  int seen = atomic_load(&a->max_pending_seen);
+  while (n > seen && !atomic_compare_exchange_weak(&a->max_pending_seen, &seen, n))
+    ;
+
+  pthread_mutex_lock(&a->mu);
+  if (a->stop)
+  {
+    pthread_mutex_unlock(&a->mu);
+    atomic_fetch_sub(&a->pending, 1);
+    xora_free(r);
+    return XORA_ERR;
+  }
+  r->next = NULL;
+  if (a->q_tail)
+    a->q_tail->next = r;
+  else
+    a->q_head = r;
+  a->q_tail = r;
+  atomic_fetch_add(&a->submitted, 1);
+  pthread_cond_signal(&a->wake);
+  pthread_mutex_unlock(&a->mu);
+  return XORA_OK;
+}
+
+/*  public  */
+
+void xora_uv_config_init(xora_uv_config_t *cfg)
+{
+  if (!cfg)
+    return;
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->workers = 4;
+  cfg->max_pending = 1024;
+  cfg->acquire_timeout_ms = 5000;
+}
+
+xora_err_t xora_uv_create(xora_uv_t **out, uv_loop_t *loop, const xora_uv_config_t *cfg)
+{
+  if (!out || *out)
+    return XORA_ALREADY_ALLOCATED;
+  if (!loop || !cfg || !cfg->pool)
+    return XORA_ERR;
+
+  xora_uv_t *a = (xora_uv_t *)xora_calloc(1, sizeof(*a));
+  a->loop = loop;
+  a->pool = cfg->pool;
+  a->ids = cfg->ids;
+  a->acquire_timeout_ms = cfg->acquire_timeout_ms;
+  a->max_pending = cfg->max_pending > 0 ? cfg->max_pending : 1024;
+  pthread_mutex_init(&a->mu, NULL);
+  pthread_cond_init(&a->wake, NULL);
+  pthread_mutex_init(&a->done_mu, NULL);
+
+  if (uv_async_init(loop, &a->async, xora__uv_on_async) != 0)
+  {
+    pthread_cond_destroy(&a->wake);
+    pthread_mutex_destroy(&a->mu);
+    pthread_mutex_destroy(&a->done_mu);
+    xora_free(a);
+    return XORA_ERR;
+  }
+  a->async.data = a;
+
+  int nw = cfg->workers > 0 ? cfg->workers : 4;
+  a->workers = XORA_ALLOC_ARRAY(pthread_t, nw);
+  for (int i = 0; i < nw; ++i)
+  {
+    if (pthread_create(&a->workers[i], NULL, xora__uv_worker, a) != 0)
+      break;
+    a->nworkers++;
+  }
+  if (a->nworkers == 0)
+  {
+    xora_free(a->workers);
+    a->workers = NULL;
+    xora_uv_destroy(&a);
+    return XORA_ERR;
+  }
+
+  *out = a;
+  return XORA_OK;
+}
+
+xora_err_t xora_async_call(xora_uv_t *a, xora_conn_t *conn,
+                           xora_async_fn_t fn, void *arg,
+                           xora_async_cb_t cb, void *ud)
+{
+  if (!a || !fn)
+    return XORA_ERR;
+  xora__uv_req_t *r = xora__uv_req_new(XORA__UV_CALL, conn, cb, ud, 0);
+  r->u.call.fn = fn;
+  r->u.call.arg = arg;
+  return xora__uv_submit(a, r);
+}
+
+xora_err_t xora_async_fetch(xora_uv_t *a, xora_conn_t *conn,
+                            xora_emp_cols_t *out, const xora_fetch_opts_t *opts,
+                            xora_async_cb_t cb, void *ud)
+{
+  if (!a || !out)
+    return XORA_ERR;
+  xora__uv_req_t *r = xora__uv_req_new(XORA__UV_FETCH, conn, cb, ud, 0);
+  r->u.fetch.out = out;
+  if (opts)
+  {
+    r->u.fetch.opts = *opts;
+    r->u.fetch.has_opts = 1;
+  }
+  return xora__uv_submit(a, r);
+}
+
+xora_err_t xora_async_insert(xora_uv_t *a, xora_conn_t *conn,
+                             const xora_emp_row_t *rows, int count, int *out_ids,
+                             xora_async_cb_t cb, void *ud)
+{
+  if (!a || !rows || count <= 0)
+    return XORA_ERR;
+  xora__uv_req_t *r = xora__uv_req_new(XORA__UV_INSERT, conn, cb, ud, count);
+  memcpy(r->rows, rows, sizeof(xora_emp_row_t) * (size_t)count);
+  r->u.insert.count = count;
+  r->u.insert.out_ids = out_ids;
+  return xora__uv_submit(a, r);
+}
+
+xora_err_t xora_async_commit(xora_uv_t *a, xora_conn_t *conn,
+                             xora_async_cb_t cb, void *ud)
+{
+  if (!a || !conn)
+    return XORA_ERR;
+  return xora__uv_submit(a, xora__uv_req_new(XORA__UV_COMMIT, conn, cb, ud, 0));
+}
+
+void xora_uv_get_stats(xora_uv_t *a, xora_uv_stats_t *out)
+{
+  if (!out)
+    return;
+  memset(out, 0, sizeof(*out));
+  if (!a)
+    return;
+  out->submitted = atomic_load(&a->submitted);
+  out->completed = atomic_load(&a->completed);
+  out->rejected = atomic_load(&a->rejected);
+  out->pending = atomic_load(&a->pending);
+  out->max_pending_seen = atomic_load(&a->max_pending_seen);
+}
+
+void xora_uv_destroy(xora_uv_t **ap)
+{
+  if (!ap || !*ap)
+    return;
+  xora_uv_t *a = *ap;
+  *ap = NULL;
+
+  pthread_mutex_lock(&a->mu);
+  a->stop = 1;
+  pthread_cond_broadcast(&a->wake);
+  pthread_mutex_unlock(&a->mu);
+  for (int i = 0; i < a->nworkers; ++i)
+    pthread_join(a->workers[i], NULL);
+  xora_free(a->workers);
+
+  /* Callbacks of requests that finished after the last wakeup was handled.
+   * A callback may still try to submit; stop makes that fail. */
+  xora__uv_drain(a);
+
+  pthread_cond_destroy(&a->wake);
+  pthread_mutex_destroy(&a->mu);
+  pthread_mutex_destroy(&a->done_mu);
+  uv_close((uv_handle_t *)&a->async, xora__uv_on_close);
+}
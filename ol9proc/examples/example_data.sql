@@ -26,3 +26,18 @@ INSERT INTO employees (id, name, dept, sal) VALUES (103, 'Adams',   'IT',    300
 INSERT INTO employees (id, name, dept, sal) VALUES (104, 'Johnson', 'SALES', 2800);
 
 COMMIT;
+
+-- id allocation for xora_idalloc (cursor-fetch)
+-- SEQUENCE mode: INCREMENT BY must equal the allocator block_size
+CREATE SEQUENCE employees_seq START WITH 1000 INCREMENT BY 100 NOCACHE;
+
+-- HILO mode: one counter row per key; next_id is the first unreserved id
+CREATE TABLE xora_id_blocks (
+    name    VARCHAR2(30) PRIMARY KEY,
+    next_id NUMBER(12)   NOT NULL
+);
+
+INSERT INTO xora_id_blocks (name, next_id)
+SELECT 'employees', NVL(MAX(id), 0) + 1 FROM employees;
+
+COMMIT;